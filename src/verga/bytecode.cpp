@@ -25,6 +25,103 @@
 #define DEBUG 0
 #endif
 
+/*
+ * Non-zero if closed code blocks are converted to direct-threaded code.
+ */
+static int bc_threaded = BCODE_THREADED;
+
+#if BCODE_THREADED
+/*
+ * Handler functions in the same order as the handler labels in
+ * VGThread_execThreaded().
+ */
+static BCfunc *bc_handlers[] = {
+  (BCfunc*) BCEnd_exec,
+  (BCfunc*) BCNoop_exec,
+  (BCfunc*) BCOpr_exec,
+  (BCfunc*) BCCopy_exec,
+  (BCfunc*) BCCopyRange_exec,
+  (BCfunc*) BCAsgn_exec,
+  (BCfunc*) BCRaise_exec,
+  (BCfunc*) BCNbAsgnD_exec,
+  (BCfunc*) BCNbAsgnE_exec,
+  (BCfunc*) BCWireAsgnD_exec,
+  (BCfunc*) BCGoto_exec,
+  (BCfunc*) BCSpawn_exec,
+  (BCfunc*) BCWait_exec,
+  (BCfunc*) BCTask_exec,
+  (BCfunc*) BCDelay_exec,
+  (BCfunc*) BCTrigger_exec,
+  (BCfunc*) BCLock_exec,
+  (BCfunc*) BCMemFetch_exec,
+  (BCfunc*) BCMemPut_exec,
+  (BCfunc*) BCNbMemPutD_exec,
+  (BCfunc*) BCNbMemPutE_exec,
+  (BCfunc*) BCSubr_exec,
+  (BCfunc*) BCReturn_exec,
+  (BCfunc*) BCDebugPrint_exec,
+  (BCfunc*) BCGate_exec,
+  (BCfunc*) BCGate1_exec,
+  0
+};
+
+static void **bc_labels = 0;		/* Handler labels from VGThread_execThreaded() */
+
+static void VGThread_execThreaded(VGThread *t);
+
+/*****************************************************************************
+ *
+ * Convert instructions in a CodeBlock to direct-threaded code
+ *
+ * Parameters:
+ *     cb		CodeBlock to convert
+ *     start		First instruction to convert
+ *     stop		Last instruction to convert
+ *
+ * Replaces the handler function of each instruction with the address of the
+ * matching handler label in VGThread_execThreaded().
+ *
+ *****************************************************************************/
+static void CodeBlock_thread(CodeBlock *cb,unsigned start,unsigned stop)
+{
+  unsigned i;
+
+  if (!bc_labels)
+    VGThread_execThreaded(0);
+
+  for (i = start;i <= stop;i++) {
+    ByteCode *bc = CodeBlock_get(cb,i);
+    int j;
+
+    for (j = 0;bc_handlers[j];j++)
+      if (bc_handlers[j] == bc->bc_func)
+	break;
+    if (!bc_handlers[j])
+      abort();
+
+    bc->bc_label = bc_labels[j];
+  }
+}
+#endif
+
+/*****************************************************************************
+ *
+ * Select the bytecode dispatch method
+ *
+ * Parameters:
+ *     threaded		Non-zero to run closed code blocks as direct-threaded
+ *			code, zero to call the handler function of each
+ *			instruction.
+ *
+ * This must be set before any code blocks are closed.  It has no effect if
+ * the compiler does not support threaded code.
+ *
+ *****************************************************************************/
+void ByteCode_setThreaded(int threaded)
+{
+  bc_threaded = BCODE_THREADED && threaded;
+}
+
 /*****************************************************************************
  *
  * Create a new CodeBlock
@@ -37,7 +134,10 @@ CodeBlock::CodeBlock(ModuleInst *mi)
 	this->_length = 0;
 	this->cb_nalloced = BCODE_BLOCKSIZE;
 	this->_module = mi;
+	this->cb_threaded = 0;
 	this->cb_instructions = (ByteCode*) malloc(sizeof(ByteCode)*BCODE_BLOCKSIZE);
+	List_init(&this->cb_copies);
+	this->cb_copyOffset = 0;
 }
 
 /*****************************************************************************
@@ -55,18 +155,32 @@ CodeBlock::~CodeBlock()
 
 /*****************************************************************************
  *
- * Resize a codeblock to use the minimum number of bytes.
+ * Optimize a codeblock, resize it to use the minimum number of bytes and
+ * convert it to threaded code if enabled.
  *
  *****************************************************************************/
 void
 CodeBlock::close()
 {
-	ByteCode *oldBC = this->cb_instructions;
+	ByteCode *oldBC;
+
+	this->optimize();
+	List_flush(&this->cb_copies);
+
+	oldBC = this->cb_instructions;
 
 	this->cb_nalloced = this->_length;
 	this->cb_instructions = (ByteCode*) malloc(sizeof(ByteCode)*this->cb_nalloced);
 	std::memcpy(this->cb_instructions, oldBC, sizeof(ByteCode)*this->cb_nalloced);
 	free(oldBC);
+
+#if BCODE_THREADED
+	if (bc_threaded && !this->cb_threaded) {
+		if (this->_length > 0)
+			CodeBlock_thread(this, 0, this->_length-1);
+		this->cb_threaded = 1;
+	}
+#endif
 }
 
 /*****************************************************************************
@@ -80,6 +194,7 @@ CodeBlock::close()
 void CodeBlock_uninit(CodeBlock *cb)
 {
   free(cb->cb_instructions);
+  List_uninit(&cb->cb_copies);
 }
 
 /*****************************************************************************
@@ -117,6 +232,29 @@ CodeBlock::copy(unsigned dpos,CodeBlock *src,unsigned start,unsigned stop)
 
 	std::memcpy(CodeBlock_get(this, dpos), CodeBlock_get(src,start),
 	    sizeof (ByteCode)*copySize);
+	if (reqLen > (unsigned)this->_length)
+		this->_length = reqLen;
+
+	/*
+	 * Branches in the copy still refer to the source block, so the source
+	 * must know about the copy if it moves instructions when it is closed.
+	 */
+	if (!src->cb_threaded) {
+		this->cb_copyOffset = start - dpos;
+		List_addToTail(&src->cb_copies, this);
+	}
+
+#if BCODE_THREADED
+	/*
+	 * Copies from a block that is not closed yet must be converted here
+	 * since this block is never closed.
+	 */
+	if (bc_threaded) {
+		if (!src->cb_threaded)
+			CodeBlock_thread(this, dpos, dpos+copySize-1);
+		this->cb_threaded = 1;
+	}
+#endif
 #if 0
   {
 	int i;
@@ -214,6 +352,9 @@ void BCNoop_exec(BCNoop *bc,VGThread *t)
  *     r		Destination Value
  *     a,b,c		Source Value objects
  *
+ * If the widths of the values allow it, func is replaced by a kernel
+ * specialized for those widths (see Value_kernel()).
+ *
  *****************************************************************************/
 void BCOpr_init(ByteCode *bc,valueop_f *func,Value*r,Value*a,Value*b,Value*c)
 {
@@ -221,7 +362,7 @@ void BCOpr_init(ByteCode *bc,valueop_f *func,Value*r,Value*a,Value*b,Value*c)
     abort();
 
   bc->bc_func = (BCfunc*) BCOpr_exec;
-  bc->bc_opr.o_op =  func;
+  bc->bc_opr.o_op =  Value_kernel(func,r,a,b,c);
   bc->bc_opr.o_dest = r;
   bc->bc_opr.o_opr[0] = a;
   bc->bc_opr.o_opr[1] = b;
@@ -311,10 +452,24 @@ void BCGoto_exec(BCGoto *g,VGThread *t)
 #endif
     t->t_pc++;
   } else {
+    ByteCode *pc = CodeBlock_first(g->g_block) + g->g_offset;
+
 #if DEBUG
     vgio_echo("%p: BCGoto: jump %p:%x\n",t,g->g_block,g->g_offset);
 #endif
-    t->t_pc = CodeBlock_first(g->g_block) + g->g_offset;
+
+    /*
+     * On a backward jump, yield to the event loop if there is input to
+     * check so that a loop with no delays can not lock out commands.
+     * Threads run by the parallel executor always stop at a trigger, so
+     * they are left to run on.
+     */
+    if (pc <= t->t_pc && do_input_check && !Parallel_inWorker()) {
+      t->t_pc = pc;
+      VGThread_suspend(t);
+      EvQueue_enqueueAtHead(VGThread_getQueue(t),new_EvThread(t));
+    } else
+      t->t_pc = pc;
   }
 }
 
@@ -515,14 +670,15 @@ void BCCopy_init(ByteCode *bc, Value*dst, Value*src)
 
 /*****************************************************************************
  *
- * Execute BCCopy instruction
+ * Copy the source of a BCCopy instruction to its destination
  *
  * Parameters:
- *     bc		ByteCode object to execute
- *     t		Thread that is executing instruction
+ *     c		BCCopy instruction
+ *
+ * The source is truncated or zero extended to the size of the destination.
  *
  *****************************************************************************/
-void BCCopy_exec(BCCopy *c, VGThread *t)
+void BCCopy_copy(BCCopy *c)
 {
   int nd = Value_nbits(c->c_dst);
   int ns = Value_nbits(c->c_src);
@@ -535,6 +691,20 @@ void BCCopy_exec(BCCopy *c, VGThread *t)
     Value_zero(c->c_dst);
     Value_copyRange(c->c_dst,0,c->c_src,ns-1,0);
   }
+}
+
+/*****************************************************************************
+ *
+ * Execute BCCopy instruction
+ *
+ * Parameters:
+ *     bc		ByteCode object to execute
+ *     t		Thread that is executing instruction
+ *
+ *****************************************************************************/
+void BCCopy_exec(BCCopy *c, VGThread *t)
+{
+  BCCopy_copy(c);
 
 #if DEBUG
   vgio_echo("%p: BCCopy: ",t);
@@ -572,7 +742,19 @@ void BCCopyRange_init(ByteCode *bc, Value *dst, unsigned dLsb,Value *src,Value *
   r->r_width = width;
 }
 
-void BCCopyRange_exec(BCCopyRange *r, VGThread *t)
+/*****************************************************************************
+ *
+ * Copy the bits for a BCCopyRange instruction
+ *
+ * Parameters:
+ *     r		BCCopyRange instruction
+ *     t		Thread that is executing instruction
+ *
+ * This does the work of BCCopyRange_exec() except for advancing the thread
+ * so that it can also be used by BCGate.
+ *
+ *****************************************************************************/
+static void BCCopyRange_copy(BCCopyRange *r, VGThread *t)
 {
   unsigned sLsb;
 
@@ -586,7 +768,6 @@ void BCCopyRange_exec(BCCopyRange *r, VGThread *t)
     Value_unknown(x);
     Value_copyRange(r->r_dst, r->r_dLsb, x,r->r_width-1,0);
     delete_Value(x);
-    t->t_pc++;
 
 #if DEBUG
   vgio_echo("%p: BCCopyRange(",t);
@@ -603,7 +784,6 @@ void BCCopyRange_exec(BCCopyRange *r, VGThread *t)
    * Normal case
    */
   Value_copyRange(r->r_dst, r->r_dLsb, r->r_src,sLsb+r->r_width-1,sLsb);
-  t->t_pc++;
 
 #if DEBUG
   vgio_echo("%p: BCCopyRange(",t);
@@ -614,6 +794,21 @@ void BCCopyRange_exec(BCCopyRange *r, VGThread *t)
 #endif
 }
 
+/*****************************************************************************
+ *
+ * Execute BCCopyRange instruction
+ *
+ * Parameters:
+ *     bc		ByteCode object to execute
+ *     t		Thread that is executing instruction
+ *
+ *****************************************************************************/
+void BCCopyRange_exec(BCCopyRange *r, VGThread *t)
+{
+  BCCopyRange_copy(r, t);
+  t->t_pc++;
+}
+
 /*****************************************************************************
  *
  * Initialize a BCMemFetch instruction
@@ -1098,14 +1293,17 @@ void BCWireAsgnD_init(ByteCode *bc, Net *net, int id, Value *netLsb, Value *valu
 
 /*****************************************************************************
  *
- * Execute BCWireAsgnD instruction
+ * Schedule the driver change for a BCWireAsgnD instruction
  *
  * Parameters:
- *     bc		ByteCode object to execute
- *     t		Thread that is executing instruction
+ *     a		BCWireAsgnD instruction
+ *     thread		Thread that is executing instruction
+ *
+ * This does the work of BCWireAsgnD_exec() except for advancing the thread
+ * so that it can also be used by BCGate.
  *
  *****************************************************************************/
-void BCWireAsgnD_exec(BCWireAsgnD *a, VGThread *thread)
+static void BCWireAsgnD_schedule(BCWireAsgnD *a, VGThread *thread)
 {
   unsigned netLsb = 0;
   EvQueue *Q = VGThread_getQueue(thread);
@@ -1125,22 +1323,50 @@ void BCWireAsgnD_exec(BCWireAsgnD *a, VGThread *thread)
 #endif
 
       delete_Value(xs);
-      thread->t_pc++;
       return;
     }
   } else {
     netLsb = 0;
   }
 
+  /*
+   * Continuous assignments have inertial delay.  If there is still a change
+   * pending on this driver, overwrite it if it is for the same time,
+   * otherwise cancel it and schedule the new value.
+   */
+  e = Net_getDriverEvent(a->a_net, a->a_id);
+  if (e) {
+    if (e->ev_base.eb_time == EvQueue_getCurTime(Q) + a->a_delay) {
+      EvDriver_setState(&e->ev_driver, netLsb, a->a_value, a->a_valLsb+a->a_width-1,a->a_valLsb);
+      return;
+    }
+    EvQueue_remove(Q,e);
+    delete_Event(e);
+  }
+
   e = new_EvDriver(a->a_net, a->a_id, netLsb, a->a_value, a->a_valLsb+a->a_width-1,a->a_valLsb);
   EvQueue_enqueueAfter(Q,e,a->a_delay);
+  Net_setDriverEvent(a->a_net, a->a_id, e);
 
 #if DEBUG
   vgio_echo("%p: BCWireAsgnD: #%d %s = ",thread,a->a_delay,Net_getName(a->a_net));
   Value_print(a->a_value,stdout);
   vgio_echo("\n");
 #endif
+}
 
+/*****************************************************************************
+ *
+ * Execute BCWireAsgnD instruction
+ *
+ * Parameters:
+ *     bc		ByteCode object to execute
+ *     t		Thread that is executing instruction
+ *
+ *****************************************************************************/
+void BCWireAsgnD_exec(BCWireAsgnD *a, VGThread *thread)
+{
+  BCWireAsgnD_schedule(a, thread);
   thread->t_pc++;
 }
 
@@ -1302,7 +1528,371 @@ void BCDebugPrint_exec(BCDebugPrint *dp,VGThread *t)
   t->t_pc++;
 }
 
+/*****************************************************************************
+ *
+ * Generate the end of the handler loop for a gate or continuous assignment
+ *
+ * Parameters:
+ *     cb		CodeBlock being generated
+ *     top		Offset of the first instruction of the loop
+ *
+ * The loop must end with a BCTrigger that has already been generated.  If
+ * the loop body is only a sequence of BCOpr and BCCopyRange followed by a
+ * sequence of BCWireAsgnD, a BCGate superinstruction is generated to close
+ * the loop.  Otherwise a BCGoto back to top is generated.
+ *
+ *****************************************************************************/
+void BCGate_generate(CodeBlock *cb,unsigned top)
+{
+  unsigned end = cb->size() - 1;	/* Offset of the BCTrigger */
+  unsigned neval = 0;
+  unsigned nasgn = 0;
+  unsigned ranges = 0;
+  unsigned i = top;
+  BCGate *g;
+
+  for (;i < end && neval < 8*sizeof(ranges);i++, neval++) {
+    BCfunc *f = CodeBlock_get(cb,i)->bc_func;
+
+    if (f == (BCfunc*) BCCopyRange_exec)
+      ranges |= (1u << neval);
+    else if (f != (BCfunc*) BCOpr_exec)
+      break;
+  }
+  for (;i < end && CodeBlock_get(cb,i)->bc_func == (BCfunc*) BCWireAsgnD_exec;i++)
+    nasgn++;
+
+  if (i != end || nasgn == 0 || CodeBlock_get(cb,end)->bc_func != (BCfunc*) BCTrigger_exec) {
+    BCGoto_init(cb->nextEmpty(), 0, 0, cb, top);
+    return;
+  }
+
+  g = (BCGate*) cb->nextEmpty();
+  g->g_neval = neval;
+  g->g_nasgn = nasgn;
+  g->g_ranges = ranges;
+  if (neval == 1 && nasgn == 1 && !ranges)
+    g->g_func = (BCfunc*) BCGate1_exec;
+  else
+    g->g_func = (BCfunc*) BCGate_exec;
+}
+
+/*****************************************************************************
+ *
+ * Execute BCGate instruction
+ *
+ * Parameters:
+ *     g		ByteCode object to execute
+ *     t		Thread that is executing instruction
+ *
+ * The thread is left waiting at this instruction.
+ *
+ *****************************************************************************/
+void BCGate_exec(BCGate *g,VGThread *t)
+{
+  unsigned i;
+
+#if DEBUG
+  vgio_echo("%p: BCGate(%u, %u)\n",t,g->g_neval,g->g_nasgn);
+#endif
+
+  BCGate_evaluate(g,t);
+  for (i = 0;i < g->g_nasgn;i++)
+    BCWireAsgnD_schedule(BCGate_getAsgn(g,i), t);
+
+  VGThread_eventWait(t,BCGate_getTrigger(g));
+}
+
+/*****************************************************************************
+ *
+ * Evaluate the operands of a gate
+ *
+ * Parameters:
+ *     g		BCGate instruction
+ *     t		Thread of the gate
+ *
+ * Runs the operator and range copy instructions of the gate loop, leaving
+ * the value to be assigned to the drivers in their source values.
+ *
+ *****************************************************************************/
+void BCGate_evaluate(BCGate *g,VGThread *t)
+{
+  ByteCode *bc = (ByteCode*)g - 1 - g->g_nasgn - g->g_neval;
+  unsigned i;
+
+  for (i = 0;i < g->g_neval;i++, bc++) {
+    if ((g->g_ranges & (1u << i))) {
+      BCCopyRange_copy(&bc->bc_copyrange, t);
+    } else {
+      BCOpr *o = &bc->bc_opr;
 
+      (*o->o_op)(o->o_dest,o->o_opr[0],o->o_opr[1],o->o_opr[2]);
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * Execute BCGate1 instruction
+ *
+ * Parameters:
+ *     g		ByteCode object to execute
+ *     t		Thread that is executing instruction
+ *
+ * Same as BCGate_exec() for a gate on scalar nets, which has one operator
+ * and one driver.
+ *
+ *****************************************************************************/
+void BCGate1_exec(BCGate *g,VGThread *t)
+{
+  ByteCode *bc = (ByteCode*)g;
+  BCOpr *o = &bc[-3].bc_opr;
+
+#if DEBUG
+  vgio_echo("%p: BCGate1\n",t);
+#endif
+
+  (*o->o_op)(o->o_dest,o->o_opr[0],o->o_opr[1],o->o_opr[2]);
+  BCWireAsgnD_schedule(&bc[-2].bc_wireasgnd, t);
+  VGThread_eventWait(t,bc[-1].bc_trigger.t_trigger);
+}
+
+/*****************************************************************************
+ *
+ * Test the handler of an instruction
+ *
+ * Parameters:
+ *     cb		Code block holding the instruction
+ *     bc		Instruction to test
+ *     f		Handler function
+ *
+ * Returns:		Non-zero if bc is executed by f.
+ *
+ * Works both before and after the block is converted to threaded code.
+ *
+ *****************************************************************************/
+static int ByteCode_isHandler(CodeBlock *cb,ByteCode *bc,BCfunc *f)
+{
+#if BCODE_THREADED
+  if (cb->cb_threaded) {
+    int j;
+
+    for (j = 0;bc_handlers[j];j++)
+      if (bc_handlers[j] == f)
+	return bc->bc_label == bc_labels[j];
+    return 0;
+  }
+#endif
+  return bc->bc_func == f;
+}
+
+/*****************************************************************************
+ *
+ * Find the gate loop run by a thread
+ *
+ * Parameters:
+ *     t		Thread to look at
+ *
+ * Returns:		The BCGate of the thread, or null if the thread is not
+ *			the handler loop of a gate or continuous assignment.
+ *
+ *****************************************************************************/
+BCGate *VGThread_getGate(VGThread *t)
+{
+  CodeBlock *cb = t->t_start_block;
+  unsigned i = t->t_start_pc;
+  unsigned n = cb->size();
+  unsigned neval = 0, nasgn = 0;
+  BCGate *g;
+
+  for (;i < n;i++, neval++) {
+    ByteCode *bc = CodeBlock_get(cb,i);
+
+    if (!ByteCode_isHandler(cb,bc,(BCfunc*) BCOpr_exec)
+	&& !ByteCode_isHandler(cb,bc,(BCfunc*) BCCopyRange_exec))
+      break;
+  }
+  for (;i < n && ByteCode_isHandler(cb,CodeBlock_get(cb,i),(BCfunc*) BCWireAsgnD_exec);i++)
+    nasgn++;
+
+  if (i + 1 >= n || !ByteCode_isHandler(cb,CodeBlock_get(cb,i),(BCfunc*) BCTrigger_exec))
+    return 0;
+  if (!ByteCode_isHandler(cb,CodeBlock_get(cb,i+1),(BCfunc*) BCGate_exec)
+      && !ByteCode_isHandler(cb,CodeBlock_get(cb,i+1),(BCfunc*) BCGate1_exec))
+    return 0;
+
+  g = &CodeBlock_get(cb,i+1)->bc_gate;
+  if (g->g_neval != neval || g->g_nasgn != nasgn)
+    return 0;
+
+  return g;
+}
+
+/*****************************************************************************
+ *
+ * Visit the instructions a thread can reach
+ *
+ * Parameters:
+ *     t		Thread to look at
+ *     visit		Function called on each instruction other than a jump
+ *     data		Data passed to visit
+ *
+ * Returns:		Non-zero if every call to visit returned non-zero and
+ *			no branch leaves the code block of the thread.
+ *
+ * The instructions are followed from the start of the thread through its
+ * branches, and each is visited once.
+ *
+ *****************************************************************************/
+static int VGThread_walk(VGThread *t,int (*visit)(CodeBlock*,ByteCode*,void*),void *data)
+{
+  CodeBlock *cb = t->t_start_block;
+  unsigned n = cb->size();
+  unsigned *stack;
+  char *seen;
+  int sp = 0, ok = 1;
+
+  seen = (char*) calloc(n,1);
+  stack = (unsigned*) malloc((n+1)*sizeof(unsigned));
+  stack[sp++] = t->t_start_pc;
+
+  while (ok && sp > 0) {
+    unsigned i = stack[--sp];
+
+    while (ok && i < n && !seen[i]) {
+      ByteCode *bc = CodeBlock_get(cb,i);
+
+      seen[i] = 1;
+      if (ByteCode_isHandler(cb,bc,(BCfunc*) BCGoto_exec)) {
+	BCGoto *g = &bc->bc_goto;
+
+	if (g->g_block != cb) {
+	  ok = 0;
+	  break;
+	}
+	if (g->g_cond || g->g_neg)		/* May fall through */
+	  stack[sp++] = i+1;
+	if (!g->g_cond && g->g_neg)		/* Never jumps */
+	  break;
+	i = g->g_offset;
+	continue;
+      }
+
+      ok = (*visit)(cb,bc,data);
+      i++;
+    }
+    if (i >= n)
+      ok = 0;
+  }
+
+  free(seen);
+  free(stack);
+
+  return ok;
+}
+
+/*****************************************************************************
+ *
+ * Test if an instruction may be run by the parallel executor (VGThread_walk
+ * visitor)
+ *
+ *****************************************************************************/
+static int VGThread_parallelOp(CodeBlock *cb,ByteCode *bc,void *data)
+{
+  if (ByteCode_isHandler(cb,bc,(BCfunc*) BCOpr_exec))
+    return (bc->bc_opr.o_op != Value_f_div);
+
+  return (ByteCode_isHandler(cb,bc,(BCfunc*) BCNoop_exec)
+	  || ByteCode_isHandler(cb,bc,(BCfunc*) BCCopy_exec)
+	  || ByteCode_isHandler(cb,bc,(BCfunc*) BCCopyRange_exec)
+	  || ByteCode_isHandler(cb,bc,(BCfunc*) BCNbAsgnD_exec)
+	  || ByteCode_isHandler(cb,bc,(BCfunc*) BCTrigger_exec));
+}
+
+/*****************************************************************************
+ *
+ * Test if a thread can be run by the parallel executor
+ *
+ * Parameters:
+ *     t		Thread to look at
+ *
+ * Returns:		Non-zero if every instruction the thread can reach only
+ *			computes values, schedules a non-blocking assignment or
+ *			waits on a trigger.
+ *
+ * Such a thread changes nothing another thread can see until the events it
+ * schedules are processed, so any number of them woken in the same time
+ * slot can run at once.  Its branches must stay in its code block.  Real
+ * division is left out since it reports division by zero.
+ *
+ *****************************************************************************/
+int VGThread_canParallel(VGThread *t)
+{
+  if (!t->t_mitem || ModuleItem_getDynamicModule(t->t_mitem))
+    return 0;
+
+  return VGThread_walk(t,VGThread_parallelOp,0);
+}
+
+/*****************************************************************************
+ *
+ * Add the values used by an instruction to a list (VGThread_walk visitor)
+ *
+ *****************************************************************************/
+static int VGThread_valuesOp(CodeBlock *cb,ByteCode *bc,void *data)
+{
+  List *values = (List*) data;
+  int i;
+
+  if (ByteCode_isHandler(cb,bc,(BCfunc*) BCOpr_exec)) {
+    List_addToTail(values,bc->bc_opr.o_dest);
+    for (i = 0;i < 3;i++)
+      if (bc->bc_opr.o_opr[i])
+	List_addToTail(values,bc->bc_opr.o_opr[i]);
+  } else if (ByteCode_isHandler(cb,bc,(BCfunc*) BCCopy_exec)) {
+    List_addToTail(values,bc->bc_copy.c_dst);
+    List_addToTail(values,bc->bc_copy.c_src);
+  } else if (ByteCode_isHandler(cb,bc,(BCfunc*) BCCopyRange_exec)) {
+    List_addToTail(values,bc->bc_copyrange.r_dst);
+    List_addToTail(values,bc->bc_copyrange.r_src);
+  } else if (ByteCode_isHandler(cb,bc,(BCfunc*) BCNbAsgnD_exec)) {
+    List_addToTail(values,Net_getValue(bc->bc_nbasgnd.a_net));
+    List_addToTail(values,bc->bc_nbasgnd.a_value);
+  } else if (ByteCode_isHandler(cb,bc,(BCfunc*) BCTrigger_exec)) {
+    Trigger *trig = bc->bc_trigger.t_trigger;
+    ListElem *le;
+
+    if (trig->t_posedges)
+      for (le = List_first(trig->t_posedges);le;le = List_next(trig->t_posedges,le))
+	List_addToTail(values,Net_getValue((Net*)ListElem_obj(le)));
+    if (trig->t_negedges)
+      for (le = List_first(trig->t_negedges);le;le = List_next(trig->t_negedges,le))
+	List_addToTail(values,Net_getValue((Net*)ListElem_obj(le)));
+    if (trig->t_slices)
+      for (le = List_first(trig->t_slices);le;le = List_next(trig->t_slices,le))
+	List_addToTail(values,Net_getValue(((NetSlice*)ListElem_obj(le))->ns_net));
+  }
+
+  return 1;
+}
+
+/*****************************************************************************
+ *
+ * Get the values used by a thread that can be run by the parallel executor
+ *
+ * Parameters:
+ *     t		Thread to look at (VGThread_canParallel() is true)
+ *     values		List to add the values to
+ *
+ * The values of the nets the thread reads, assigns or waits on are added,
+ * along with the temporary values of its expressions.  A value may be
+ * added more than once.
+ *
+ *****************************************************************************/
+void VGThread_getValues(VGThread *t,List *values)
+{
+  VGThread_walk(t,VGThread_valuesOp,values);
+}
 
 /*****************************************************************************
  *
@@ -1345,6 +1935,8 @@ VGThread::~VGThread()
 void VGThread::init(CodeBlock *cb, unsigned pc, ModuleInst *modCtx,ModuleItem *mitem)
 {
   this->t_pending = 0;
+  this->t_wakeup.et_base.eb_status = ES_EMBEDDED;
+  this->t_wakeup.et_thread = this;
   this->t_state = TS_ACTIVE;
   this->t_isLive = 1;
   this->t_wait = 0;
@@ -1357,6 +1949,9 @@ void VGThread::init(CodeBlock *cb, unsigned pc, ModuleInst *modCtx,ModuleItem *m
   this->t_numChild = 0;
   this->t_parent = 0;
   this->t_callStack = 0;
+  this->t_parallel = 0;
+  this->t_batch = 0;
+  this->t_partition = 0;
 }
 
 void VGThread_start(VGThread *thread)
@@ -1368,7 +1963,6 @@ void
 VGThread::kill()
 {
   /*  vgio_echo("killing thread %p.\n",t);*/
-  this->t_pending = 0;
   this->t_state = TS_BLOCKED;
   this->t_isLive = 0;
 
@@ -1426,18 +2020,135 @@ void VGThread_goto(VGThread *thread,CodeBlock *codeBlock,unsigned offset)
   thread->t_pc = CodeBlock_get(codeBlock,offset);
 }
 
+#if BCODE_THREADED
+/*****************************************************************************
+ *
+ * Execute a thread in direct-threaded code until it is suspended.
+ *
+ * Parameters:
+ *     t		Thread to execute (or null to initialize bc_labels)
+ *
+ * Each instruction holds the address of its handler label, and each handler
+ * jumps directly to the label of the next instruction.  Only handlers that
+ * can block, end or yield the thread check the thread state before doing so.
+ *
+ *****************************************************************************/
+static void VGThread_execThreaded(VGThread *t)
+{
+  static void *labels[] = {
+    &&l_end, &&l_noop, &&l_opr, &&l_copy, &&l_copyrange, &&l_asgn,
+    &&l_raise, &&l_nbasgnd, &&l_nbasgne, &&l_wireasgnd, &&l_goto,
+    &&l_spawn, &&l_wait, &&l_task, &&l_delay, &&l_trigger, &&l_lock,
+    &&l_memfetch, &&l_memput, &&l_nbmemputd, &&l_nbmempute, &&l_subr,
+    &&l_ret, &&l_dbgprint, &&l_gate, &&l_gate1
+  };
+
+  if (!t) {
+    bc_labels = labels;
+    return;
+  }
+
+#define BCODE_NEXT goto *t->t_pc->bc_label
+#define BCODE_NEXTACTIVE do { if (!VGThread_isActive(t)) return; BCODE_NEXT; } while (0)
+
+  BCODE_NEXTACTIVE;
+
+ l_end:
+  BCEnd_exec(&t->t_pc->bc_end,t);
+  return;
+ l_noop:
+  BCNoop_exec(&t->t_pc->bc_noop,t);
+  BCODE_NEXT;
+ l_opr:
+  BCOpr_exec(&t->t_pc->bc_opr,t);
+  BCODE_NEXT;
+ l_copy:
+  BCCopy_exec(&t->t_pc->bc_copy,t);
+  BCODE_NEXT;
+ l_copyrange:
+  BCCopyRange_exec(&t->t_pc->bc_copyrange,t);
+  BCODE_NEXT;
+ l_asgn:
+  BCAsgn_exec(&t->t_pc->bc_asgn,t);
+  BCODE_NEXT;
+ l_raise:
+  BCRaise_exec(&t->t_pc->bc_raise,t);
+  BCODE_NEXT;
+ l_nbasgnd:
+  BCNbAsgnD_exec(&t->t_pc->bc_nbasgnd,t);
+  BCODE_NEXT;
+ l_nbasgne:
+  BCNbAsgnE_exec(&t->t_pc->bc_nbasgne,t);
+  BCODE_NEXT;
+ l_wireasgnd:
+  BCWireAsgnD_exec(&t->t_pc->bc_wireasgnd,t);
+  BCODE_NEXT;
+ l_goto:
+  BCGoto_exec(&t->t_pc->bc_goto,t);
+  BCODE_NEXTACTIVE;
+ l_spawn:
+  BCSpawn_exec(&t->t_pc->bc_spawn,t);
+  BCODE_NEXTACTIVE;
+ l_wait:
+  BCWait_exec(&t->t_pc->bc_wait,t);
+  BCODE_NEXTACTIVE;
+ l_task:
+  BCTask_exec(&t->t_pc->bc_task,t);
+  BCODE_NEXTACTIVE;
+ l_delay:
+  BCDelay_exec(&t->t_pc->bc_delay,t);
+  BCODE_NEXTACTIVE;
+ l_trigger:
+  BCTrigger_exec(&t->t_pc->bc_trigger,t);
+  BCODE_NEXTACTIVE;
+ l_lock:
+  BCLock_exec(&t->t_pc->bc_lock,t);
+  BCODE_NEXTACTIVE;
+ l_memfetch:
+  BCMemFetch_exec(&t->t_pc->bc_memfetch,t);
+  BCODE_NEXT;
+ l_memput:
+  BCMemPut_exec(&t->t_pc->bc_memput,t);
+  BCODE_NEXT;
+ l_nbmemputd:
+  BCNbMemPutD_exec(&t->t_pc->bc_nbmemputd,t);
+  BCODE_NEXT;
+ l_nbmempute:
+  BCNbMemPutE_exec(&t->t_pc->bc_nbmempute,t);
+  BCODE_NEXT;
+ l_subr:
+  BCSubr_exec(&t->t_pc->bc_subr,t);
+  BCODE_NEXT;
+ l_ret:
+  BCReturn_exec(&t->t_pc->bc_ret,t);
+  BCODE_NEXTACTIVE;
+ l_dbgprint:
+  BCDebugPrint_exec(&t->t_pc->bc_dbgprint,t);
+  BCODE_NEXT;
+ l_gate:
+  BCGate_exec(&t->t_pc->bc_gate,t);
+  return;
+ l_gate1:
+  BCGate1_exec(&t->t_pc->bc_gate,t);
+  return;
+
+#undef BCODE_NEXT
+#undef BCODE_NEXTACTIVE
+}
+#endif
+
 void
 VGThread::exec()
 {
 	VGThread_resume(this);
-	while (VGThread_isActive(this)) {
-		if (do_input_check) {
-			EvQueue *Q = VGThread_getQueue(this);
-			VGThread_suspend(this);
-			EvQueue_enqueueAtHead(Q,new_EvThread(this));
-		} else
-		VGThread_doNextInsruction(this);
+#if BCODE_THREADED
+	if (bc_threaded) {
+		VGThread_execThreaded(this);
+		return;
 	}
+#endif
+	while (VGThread_isActive(this))
+		VGThread_doNextInsruction(this);
 }
 
 /*****************************************************************************
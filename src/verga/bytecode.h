@@ -20,6 +20,8 @@
 #ifndef __bytecode_h
 #define __bytecode_h
 
+#include "evqueue.h"
+
 /*****************************************************************************
  *
  * This file implements the simulation byte code classes.  The basic byte code
@@ -58,11 +60,26 @@
  *   BCSubr		Jump to a subroutine
  *   BCReturn		Return from a subroutine
  *   BCDebugPrint	Print a string for debugging purposes
+ *   BCGate		Evaluate a gate or continuous assignment and wait for input
+ *   BCGate1		BCGate with only one operator and one driver
  *
  *****************************************************************************/
 
 #define BCODE_BLOCKSIZE  64
 
+/*
+ * Compilers that support labels as values (GNU C) run closed code blocks as
+ * direct-threaded code.  Define BCODE_THREADED as 0 to always dispatch through
+ * the handler function pointers.
+ */
+#ifndef BCODE_THREADED
+#if defined(__GNUC__)
+#define BCODE_THREADED	1
+#else
+#define BCODE_THREADED	0
+#endif
+#endif
+
 /*****************************************************************************
  *
  * Thread states
@@ -115,6 +132,7 @@ public:
 	void exec();
 
 	Event *t_pending; /* Pointer to event if pending, null otherwise */
+	EvThread t_wakeup; /* Event to resume this thread */
 	ThreadState_t t_state; /* State of the thread (active, blocked, paused, etc.)  */
 	int t_isLive; /* Non-zero if this thread is live */
 	int t_wait; /* Suspend until this many threads end */
@@ -127,6 +145,9 @@ public:
 	VGThread *t_parent; /* Parent task */
 	VGThread *t_next; /* Next pointer when we are in the active queue */
 	VGFrame *t_callStack; /* Call stack for any calls to user tasks/functions */
+	int t_parallel; /* Non-zero if the thread can be run by the parallel executor */
+	unsigned t_batch; /* Last parallel batch that took a wakeup of the thread */
+	unsigned t_partition; /* Partition, which picks the worker that runs the thread */
 };
 
 /*****************************************************************************
@@ -463,6 +484,30 @@ typedef struct
 	char *dp_message; /* Message to print */
 } BCDebugPrint;
 
+/*****************************************************************************
+ *
+ * BCGate - Superinstruction for the handler loop of a gate or continuous
+ * assignment.  It replaces the BCGoto at the end of a loop of the form:
+ *
+ *	top:	BCOpr/BCCopyRange ...	(g_neval operand evaluations)
+ *		BCWireAsgnD ...		(g_nasgn driver assignments)
+ *		BCTrigger
+ *		BCGoto top
+ *
+ * The thread runs the loop once from top.  After that, each change on an
+ * input resumes it at the BCGate, which evaluates the operands, schedules
+ * the drivers and waits on the trigger again in a single instruction.  The
+ * instructions it uses are found at fixed offsets before it.
+ *
+ *****************************************************************************/
+typedef struct
+{
+	BCfunc *g_func; /* Handler function */
+	unsigned g_neval; /* Number of BCOpr/BCCopyRange instructions in loop */
+	unsigned g_nasgn; /* Number of BCWireAsgnD instructions in loop */
+	unsigned g_ranges; /* Bit i set if evaluation i is a BCCopyRange */
+} BCGate;
+
 /*****************************************************************************
  *
  * @brief A single byte code instruction.
@@ -471,6 +516,7 @@ typedef struct
 union ByteCode_union
 {
 	BCfunc *bc_func; /* Handler function for operation */
+	void *bc_label; /* Handler label for operation (threaded code) */
 	BCOpr bc_opr; /* Basic operation */
 	BCEnd bc_end; /* End thread */
 	BCNoop bc_noop; /* No-op */
@@ -495,6 +541,7 @@ union ByteCode_union
 	BCSubr bc_subr; /* Jump to a subroutine */
 	BCReturn bc_ret; /* Return from a subroutine */
 	BCDebugPrint bc_dbgprint; /* Print a debugging message */
+	BCGate bc_gate; /* Gate handler loop */
 };
 
 /**
@@ -528,9 +575,14 @@ public:
 	void copy(unsigned dpos, CodeBlock *src, unsigned start, unsigned stop);
 
 	int cb_nalloced; /* Number of allocated entries */
+	int cb_threaded; /* Non-zero if instructions hold handler labels */
 	ByteCode *cb_instructions; /* Vector of instructions */
+	List/*CodeBlock*/ cb_copies; /* Blocks holding copies of our instructions */
+	int cb_copyOffset; /* Offset in source block of our instructions if a copy */
 
 private:
+	void optimize();
+
 	/**
 	 * @brief Module instance we are in
 	 */
@@ -552,6 +604,9 @@ void CodeBlock_uninit(CodeBlock *cb);
  * ByteCode member functions
  *****************************************************************************/
 #define ByteCode_exec(bc,t) (*bc->bc_func)(bc,t)
+void ByteCode_setThreaded(int);
+void ByteCode_setOptLevel(int);
+void ByteCode_printOptStats(void);
 
 /*****************************************************************************
  * BCEnd - member functions
@@ -576,6 +631,7 @@ void BCOpr_exec(BCOpr *bc, VGThread *t);
  *****************************************************************************/
 void BCCopy_init(ByteCode *bc, Value*dst, Value*src);
 void BCCopy_exec(BCCopy *bc, VGThread *t);
+void BCCopy_copy(BCCopy *bc);
 
 /*****************************************************************************
  * BCCopyRange - member functions
@@ -699,6 +755,16 @@ void BCReturn_exec(BCReturn *r, VGThread *t);
 void BCDebugPrint_init(ByteCode *bc, char *msg, ...);
 void BCDebugPrint_exec(BCDebugPrint *dp, VGThread *t);
 
+/*****************************************************************************
+ * BCGate - member functions
+ *****************************************************************************/
+void BCGate_generate(CodeBlock *cb, unsigned top);
+void BCGate_exec(BCGate *g, VGThread *t);
+void BCGate1_exec(BCGate *g, VGThread *t);
+void BCGate_evaluate(BCGate *g, VGThread *t);
+#define BCGate_getAsgn(g,i) (&((ByteCode*)(g) - 1 - (g)->g_nasgn + (i))->bc_wireasgnd)
+#define BCGate_getTrigger(g) (((ByteCode*)(g) - 1)->bc_trigger.t_trigger)
+
 /*****************************************************************************
  * VGFrame - member functions
  *****************************************************************************/
@@ -713,6 +779,9 @@ void VGThread_delayToEnd(VGThread *thread);
 void VGThread_eventWait(VGThread *thread, Trigger *t);
 void VGThread_start(VGThread *thread);
 void VGThread_childEndNotify(VGThread *thread);
+BCGate *VGThread_getGate(VGThread *thread);
+int VGThread_canParallel(VGThread *thread);
+void VGThread_getValues(VGThread *thread,List *values);
 VGThread *VGThread_spawn(VGThread *parent, CodeBlock *cb, unsigned offset);
 void VGThread_goto(VGThread *thread, CodeBlock *codeBlock, unsigned offset);
 #define VGThread_getModCtx(thread) (thread)->t_modCtx
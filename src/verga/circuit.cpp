@@ -26,6 +26,7 @@
 
 Circuit::Circuit() :
 c_evQueue(new EvQueue(*this)),
+c_levelizer(NULL),
 _root(NULL)
 {
 	NHash_init(&this->c_triggers);
@@ -1035,9 +1036,104 @@ Circuit::check()
 	SHash_uninit(&reported);
 }
 
+/*****************************************************************************
+ *
+ * Freeze the fanout of all nets in the circuit
+ *
+ * Parameters:
+ *     c		Circuit to freeze
+ *
+ * After the circuit is built, the listeners of each net are copied into
+ * arrays that are scanned when the net changes.
+ *
+ *****************************************************************************/
+static void Circuit_freezeFanout(Circuit *c)
+{
+	NetHash::iterator he;
+
+	for (he = c->c_nets.begin(); he != c->c_nets.end(); ++he)
+		Net_freezeFanout(he->second);
+}
+
+/*****************************************************************************
+ *
+ * Levelize the zero-delay gates of the circuit
+ *
+ * Parameters:
+ *     c		Circuit to levelize
+ *     insts		Module instances of the circuit
+ *
+ *****************************************************************************/
+static void Circuit_levelize(Circuit *c,ModuleInstHash &insts)
+{
+	ModuleInstHash::iterator it;
+	List threads;
+	ListElem *le;
+
+	List_init(&threads);
+	for (it = insts.begin(); it != insts.end(); ++it) {
+		ModuleInst *mi = it->second;
+
+		for (le = List_first(&mi->_threads);le;le = List_next(&mi->_threads,le))
+			List_addToTail(&threads,ListElem_obj(le));
+	}
+
+	c->c_levelizer = new_Levelizer(&threads,c->c_evQueue);
+	List_uninit(&threads);
+}
+
+/*****************************************************************************
+ *
+ * Set up parallel evaluation of the threads of the circuit
+ *
+ * Parameters:
+ *     c		Circuit
+ *     insts		Module instances of the circuit
+ *     numJobs		Number of threads to evaluate on
+ *
+ * Threads that can be run in parallel are marked and divided into one
+ * partition for each job.  An executor is only created if there are any.
+ *
+ *****************************************************************************/
+static void Circuit_parallelize(Circuit *c,ModuleInstHash &insts,unsigned numJobs)
+{
+	ModuleInstHash::iterator it;
+	List threads;
+	ListElem *le;
+
+	List_init(&threads);
+	for (it = insts.begin(); it != insts.end(); ++it) {
+		ModuleInst *mi = it->second;
+
+		for (le = List_first(&mi->_threads);le;le = List_next(&mi->_threads,le)) {
+			VGThread *t = (VGThread*) ListElem_obj(le);
+
+			if (VGThread_canParallel(t)) {
+				t->t_parallel = 1;
+				List_addToTail(&threads,t);
+			}
+		}
+	}
+
+	if (List_numElems(&threads) > 0) {
+		Partitioner *pt = new_Partitioner(c,&threads,numJobs,&vgsim.vg_placements);
+
+		c->c_evQueue->eq_parallel = new_Parallel(numJobs,pt);
+	}
+	List_uninit(&threads);
+}
+
 void
 Circuit::run()
 {
+	Circuit_freezeFanout(this);
+
+	if (vgsim.vg_levelize && !this->c_levelizer)
+		Circuit_levelize(this,this->_moduleInsts);
+
+	if (vgsim.vg_numJobs > 1 && !this->c_evQueue->eq_parallel)
+		Circuit_parallelize(this,this->_moduleInsts,vgsim.vg_numJobs);
+
 	if (vgsim.interactive())
 		EvQueue_interactiveMainEventLoop(this->c_evQueue);
 	else
@@ -1046,22 +1142,23 @@ Circuit::run()
 
 /*****************************************************************************
  *
- * Get a trigger for the specified posesges and negedges lists.
+ * Get a trigger for the specified posesges, negedges and slices lists.
  *
  * Parameters:
  *     c		Circuit to use.
  *     posedges		List of Net* that trigger on a posedge
  *     negedges		List of Net* that trigger on a negedge
+ *     slices		List of NetSlice* that trigger on a change (or null)
  *
  *****************************************************************************/
 Trigger*
-Circuit_getTrigger(Circuit *c,List *posedges,List *negedges)
+Circuit_getTrigger(Circuit *c,List *posedges,List *negedges,List *slices)
 {
-	unsigned hc = Trigger_sortAndGetHashCode(posedges,negedges);
+	unsigned hc = Trigger_sortAndGetHashCode(posedges,negedges,slices);
 	Trigger *tlist,*r;
 
 	tlist = (Trigger*) NHash_find(&c->c_triggers,hc);
-	r = Trigger_getTrigger(&tlist,posedges,negedges);
+	r = Trigger_getTrigger(&tlist,posedges,negedges,slices);
 	NHash_replace(&c->c_triggers,hc,tlist);
 
 	return (r);
@@ -1093,7 +1190,7 @@ Trigger *Circuit_getNetTrigger(Circuit *c,Net *n,transtype_t tt)
   if (Net_nbits(n) == 1 && (tt == TT_NEGEDGE || tt == TT_EDGE))
     List_addToTail(&negedges, n);
 
-  trigger = Circuit_getTrigger(c,&posedges,&negedges);
+  trigger = Circuit_getTrigger(c,&posedges,&negedges,0);
 
   List_uninit(&posedges);
   List_uninit(&negedges);
@@ -102,6 +102,7 @@ public:
 	NetHash		 c_nets;		/* Global table of nets */
 	NHash/*Trigger*/ c_triggers;		/* Triggers in this circuit */
 	EvQueue		*c_evQueue;		/* Global event queue */
+	Levelizer	*c_levelizer;		/* Levelized gates (null if not levelized) */
 	/**
 	 * @brief Dynamicly loaded modules
 	 */
@@ -139,7 +140,7 @@ void DynamicModule_killNotify(DynamicModule*);
 void Circuit_buildPathDelayMod(Circuit *c,ModuleInst *mi,ModuleInst *parent,char *path);
 Net *Circuit_findNet(Circuit *c,const char *name);
 Net *Circuit_findMemoryNet(Circuit *c,const char *name);
-Trigger *Circuit_getTrigger(Circuit *c,List *posedge,List *negedge);
+Trigger *Circuit_getTrigger(Circuit *c,List *posedge,List *negedge,List *slices);
 Trigger *Circuit_getNetTrigger(Circuit *c,Net*,transtype_t);
 #define Circuit_getQueue(c) (c)->c_evQueue
 #define Circuit_update(c) EvQueue_update((c)->c_evQueue)
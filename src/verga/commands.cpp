@@ -35,6 +35,7 @@ typedef struct {
 void Circuit_execScript(Circuit*c,int argc,char *argv[]);
 void Circuit_execShow(Circuit*c,int argc,char *argv[]);
 void Circuit_execQueue(Circuit*c,int argc,char *argv[]);
+void Circuit_execSendTo(Circuit*c,int argc,char *argv[]);
 void Circuit_execCPath(Circuit*c,int argc,char *argv[]);
 void Circuit_execSet(Circuit*c,int argc,char *argv[]);
 /*void Circuit_execBreak(Circuit*c,int argc,char *argv[]);*/
@@ -65,7 +66,8 @@ void Circuit_execMemWatch(Circuit*c,int argc,char *argv[]);
 CircExecFunc circExecTable[] = {
   {"$script", Circuit_execScript},
   {"$show", Circuit_execShow},
-  {"$sendto", Circuit_execQueue},
+  {"$sendto", Circuit_execSendTo},
+  {"$queue", Circuit_execQueue},
   {"$cpath", Circuit_execCPath},
   {"$enablescript", Circuit_execEnableScript},
   {"$disablescript", Circuit_execDisableScript},
@@ -200,7 +202,36 @@ void Circuit_execShow(Circuit*c,int argc,char *argv[])
 }
 
 
+/*****************************************************************************
+ *
+ * Implements $queue command
+ *
+ * Parameters:
+ *     c		Current circuit
+ *     arc		Number of arguments
+ *     argv		Argument strings
+ *
+ * Command summary:
+ *
+ *   $queue [<n>]	Report pending and scheduled events by type, occupancy
+ *			of the time wheel, events per epoch and the 'n' nets
+ *			with the most scheduled events.
+ *
+ *****************************************************************************/
 void Circuit_execQueue(Circuit*c,int argc,char *argv[])
+{
+  int n = QUEUE_TOPNETS;
+
+  if (argc > 2 || (argc == 2 && sscanf(argv[1],"%d",&n) != 1)) {
+    argError("$queue");
+    return;
+  }
+
+  EvQueue_printProfile(c->c_evQueue,n);
+}
+
+
+void Circuit_execSendTo(Circuit*c,int argc,char *argv[])
 {
 }
 
@@ -733,7 +764,8 @@ void Circuit_execWrite(Circuit*c,int argc,char *argv[])
     char buf[STRMAX];
 
     Value_format(v,"%d",buf);
-    vgio_echo("Circuit_execWrite(%s, %s) -> %s (%x,%x,%x)\n",argv[1],argv[2],buf,v->zero[0],v->one[0],v->flt[0]);
+    vgio_echo("Circuit_execWrite(%s, %s) -> %s (%llx,%llx,%llx)\n",argv[1],argv[2],buf,
+	      (unsigned long long)v->zero[0],(unsigned long long)v->one[0],(unsigned long long)v->flt[0]);
   }
 #endif
 
@@ -854,6 +886,10 @@ void Circuit_execDebug(Circuit*c,int argc,char *argv[])
 
   if (strcmp(argv[1],"queue") == 0) {
     EvQueue_print(Q);
+  } else if (strcmp(argv[1],"events") == 0) {
+    Event_printStats();
+  } else if (strcmp(argv[1],"optimizer") == 0) {
+    ByteCode_printOptStats();
   }
 }
 
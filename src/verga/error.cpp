@@ -74,6 +74,7 @@ static ErrorDescriptor errorTable[] = {
   {ERR_BADOP,		1,	"BADOP",	"Expression operator error in '%s'."},
   {ERR_NOREAD,		1,	"NOREAD",	"Failed to load source file '%s'."},
   {ERR_MEMFILE,		1,	"MEMFILE",	"Failed to open memory file '%s'."},
+  {ERR_QPROFILE,	1,	"QPROFILE",	"Failed to write queue profile '%s'."},
   {ERR_WRONGMOD,	1,	"WRONGMOD",	"Found module '%s' when expecting '%s'."},
   {ERR_NOTPARM,		1,	"NOTPARM",	"Identifier '%s' in constant expression is not a parameter."},
   {ERR_BADADDR,		1,	"BADADDR",	"Illegal address range on port '%s'."},
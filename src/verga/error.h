@@ -51,6 +51,7 @@ enum errorcode_t
 	ERR_BADOP,
 	ERR_NOREAD,
 	ERR_MEMFILE,
+	ERR_QPROFILE,
 	ERR_WRONGMOD,
 	ERR_NOTPARM,
 	ERR_BADADDR,
@@ -24,7 +24,91 @@
 
 extern int do_commandEcho;
 
-static Event *event_freelist = 0;
+/*
+ * Event allocation pools, indexed by event type
+ */
+static EvPool event_pools[EV_NUMTYPES] = {
+  {"unknown",	sizeof(Event)},
+  {"thread",	sizeof(EvThread)},
+  {"net",	sizeof(EvNet)},
+  {"control",	sizeof(EvControl)},
+  {"driver",	sizeof(EvDriver)},
+  {"strobe",	sizeof(EvStrobe)},
+  {"probe",	sizeof(EvProbe)},
+  {"mem",	sizeof(EvMem)},
+};
+static const int event_pools_len = sizeof(event_pools)/sizeof(event_pools[0]);
+
+/*
+ * Pools used by the calling thread.  Threads of the parallel executor
+ * allocate from pools of their own (see Event_usePools()).
+ */
+static thread_local EvPool *event_curPools = event_pools;
+
+/*****************************************************************************
+ *
+ * Operations on the slot occupancy map of the time wheel.  Bit s of the map
+ * is set when slot s of level 0 of the wheel is non-empty.  Summary words
+ * record which words of the map are non-zero so that the next busy slot can
+ * be found with a few find-first-set operations.
+ *
+ *****************************************************************************/
+#if defined(__GNUC__)
+#define wheelmap_ffs(w)		__builtin_ctzll(w)
+#define wheelmap_msb(w)		(63 - __builtin_clzll(w))
+#else
+static int wheelmap_ffs(unsigned long long w)
+{
+  int n = 0;
+
+  while (!(w & 1)) {
+    w >>= 1;
+    n++;
+  }
+  return n;
+}
+
+static int wheelmap_msb(unsigned long long w)
+{
+  int n = 0;
+
+  while ((w >>= 1))
+    n++;
+  return n;
+}
+#endif
+
+#define EvQueue_markSlot(Q,s) { \
+    (Q)->eq_wheelMap[(s)>>6] |= 1ULL << ((s)&0x3f); \
+    (Q)->eq_wheelSummary[(s)>>12] |= 1ULL << (((s)>>6)&0x3f); \
+  }
+
+#define EvQueue_clearSlot(Q,s) { \
+    if (!((Q)->eq_wheelMap[(s)>>6] &= ~(1ULL << ((s)&0x3f)))) \
+      (Q)->eq_wheelSummary[(s)>>12] &= ~(1ULL << (((s)>>6)&0x3f)); \
+  }
+
+/*****************************************************************************
+ *
+ * Keep the count of pending events and the per-type profile counters up to
+ * date as events enter and leave the queue.
+ *
+ *****************************************************************************/
+#define EvQueue_countIn(Q,E) { \
+    evtype_t t_ = Event_getType(E); \
+    (Q)->eq_numPending++; \
+    (Q)->eq_typePending[t_]++; \
+    (Q)->eq_typeScheduled[t_]++; \
+  }
+#define EvQueue_countOut(Q,E) { \
+    (Q)->eq_numPending--; \
+    (Q)->eq_typePending[Event_getType(E)]--; \
+  }
+
+/*
+ * Bit position of the low bit of the slot index for upper level k.
+ */
+#define EvQueue_levelShift(Q,k)	((Q)->eq_wheelBits + THYMEWHEEL_LEVELBITS*(k))
 
 void EvThread_process(EvThread *e,EvQueue *q);
 void EvNet_process(EvNet *e,EvQueue *q);
@@ -74,29 +158,6 @@ static EventVTable evmem_vtable = {
   (EventUninit_f*) EvMem_uninit,
 };
 
-/*****************************************************************************
- *
- * Insert an event E into the sorted list Q.  This insert is only used for "overflow"
- * with lead times exceeding the size of the time wheel.
- *
- *****************************************************************************/
-static Event *EventList_insert(Event *Q,Event *E)
-{
-  if (!Q) {
-    E->ev_base.eb_next = 0;
-    return E;
-  }
-
-  if (E->ev_base.eb_time < Q->ev_base.eb_time) {
-    E->ev_base.eb_next = Q;
-    return E;
-  }
-
-  Q->ev_base.eb_next = EventList_insert(Q->ev_base.eb_next,E);
-
-  return Q;
-}
-
 /*****************************************************************************
  *
  * Remove an event E from the list Q.
@@ -153,6 +214,45 @@ Event *SQueue_dequeue(SQueue *Q)
   return E;
 }
 
+/*****************************************************************************
+ *
+ * Get a Value to hold the state of an event.
+ *
+ * Parameters:
+ *     ei		Inline storage of the event
+ *     nbits		Number of bits in value
+ *
+ * Returns:		Value using the inline storage if nbits is small enough,
+ *			otherwise a newly allocated Value.
+ *
+ *****************************************************************************/
+static Value *EvInline_alloc(EvInline *ei,int nbits)
+{
+  Value *S = &ei->ei_value;
+
+  if (nbits > THYMEVALUE_INLINEBITS)
+    return new_Value(nbits);
+
+  Value_init(S,nbits);
+
+  return S;
+}
+
+/*****************************************************************************
+ *
+ * Release the Value holding the state of an event.
+ *
+ * Parameters:
+ *     ei		Inline storage of the event
+ *     S		Value returned by EvInline_alloc()
+ *
+ *****************************************************************************/
+static void EvInline_free(EvInline *ei,Value *S)
+{
+  if (S != &ei->ei_value)
+    delete_Value(S);
+}
+
 /*****************************************************************************
  *
  * Create a thread activication event.
@@ -160,10 +260,22 @@ Event *SQueue_dequeue(SQueue *Q)
  * Parameters:
  *     thread		Thread to be activated.
  *
+ * Each thread has a wakeup event of its own which is used if it is not
+ * already pending, so that suspending and resuming a thread does not
+ * allocate.  An event is only taken from the pool if a thread is woken
+ * from more than one place at a time.
+ *
  *****************************************************************************/
 Event *new_EvThread(VGThread *thread)
 {
-  EvThread *tev = (EvThread *) new_Event();
+  EvThread *tev;
+
+  if (!thread->t_pending) {
+    tev = &thread->t_wakeup;
+    tev->et_base.eb_next = tev->et_base.eb_prev = 0;
+    thread->t_pending = (Event*) tev;
+  } else
+    tev = (EvThread *) new_Event(EV_THREAD);
 
   tev->et_base.eb_vtable = &evthread_vtable;
   tev->et_thread = thread;
@@ -185,10 +297,11 @@ EvThread_process(EvThread *tev,EvQueue *q)
 {
 	VGThread *thread = tev->et_thread;
 
-	thread->t_pending = 0;
+	if (thread->t_pending == (Event*)tev)
+		thread->t_pending = 0;
 	if (thread->t_isLive)
 		thread->exec();
-	if (!thread->t_isLive)
+	if (!thread->t_isLive && !thread->t_pending)
 		delete thread;
 }
 
@@ -206,13 +319,15 @@ EvThread_process(EvThread *tev,EvQueue *q)
  *****************************************************************************/
 Event *new_EvNet(Net *n,int nlsb,Value *s,int smsb,int slsb)
 {
-  EvNet *en = (EvNet *) new_Event();
+  EvNet *en = (EvNet *) new_Event(EV_NET);
   int nbits = smsb-slsb+1;
 
   en->en_base.eb_vtable = &evnet_vtable;
   en->en_net = n;
   en->en_lsb = nlsb;
-  en->en_state = new_Value(nbits);
+  en->en_state = EvInline_alloc(&en->en_inline, nbits);
+  if (!Parallel_inWorker())
+    n->n_numEvents++;		/* Counted by Parallel_run() otherwise */
 
   if (Value_nbits(s) == nbits)
     Value_copy(en->en_state,s);
@@ -251,7 +366,7 @@ void EvNet_process(EvNet *en,EvQueue *q)
  *****************************************************************************/
 void EvNet_uninit(EvNet *en)
 {
-  delete_Value(en->en_state);
+  EvInline_free(&en->en_inline, en->en_state);
 }
 
 /*****************************************************************************
@@ -268,7 +383,7 @@ void EvNet_uninit(EvNet *en)
  *****************************************************************************/
 Event *new_EvStrobe(systask_f *task,TaskContext *tContext)
 {
-  EvStrobe *e = (EvStrobe *) new_Event();
+  EvStrobe *e = (EvStrobe *) new_Event(EV_STROBE);
 
   e->es_base.eb_vtable = &evstrobe_vtable;
   e->es_task = task;
@@ -326,7 +441,7 @@ void EvStrobe_uninit(EvStrobe *e)
  *****************************************************************************/
 Event *new_EvProbe(Net *n,const char *who,const char *name)
 {
-  EvProbe *e = (EvProbe *) new_Event();
+  EvProbe *e = (EvProbe *) new_Event(EV_PROBE);
 
   e->ep_base.eb_vtable = &evprobe_vtable;
   e->ep_who = who ? strdup(who) : 0;
@@ -389,13 +504,14 @@ void EvProbe_uninit(EvProbe *e)
 Event *new_EvMem(Net *n,Value *addr,int nlsb,Value *s,int smsb,int slsb)
 {
   Memory *m  = &n->n_data.memory;
-  EvMem *em = (EvMem *) new_Event();
+  EvMem *em = (EvMem *) new_Event(EV_MEM);
   int nbits = smsb-slsb+1;
 
   em->em_base.eb_vtable = &evmem_vtable;
   em->em_mem = n;
   em->em_lsb = nlsb;
-  em->em_state = new_Value(nbits);
+  em->em_state = EvInline_alloc(&em->em_inline, nbits);
+  n->n_numEvents++;
 
   if (Value_toInt(addr,&em->em_addr) < 0) {
     if ((Memory_getFlags(m) & MF_INITIALIZED))
@@ -448,7 +564,7 @@ void EvMem_process(EvMem *em,EvQueue *q)
  *****************************************************************************/
 void EvMem_uninit(EvMem *em)
 {
-  delete_Value(em->em_state);
+  EvInline_free(&em->em_inline, em->em_state);
 }
 
 
@@ -467,22 +583,41 @@ void EvMem_uninit(EvMem *em)
  *****************************************************************************/
 Event *new_EvDriver(Net *n,int id,int nlsb,Value *s,int smsb,int slsb)
 {
-  EvDriver *ed = (EvDriver *) new_Event();
-  int nbits = Net_nbits(n);
+  EvDriver *ed = (EvDriver *) new_Event(EV_DRIVER);
 
   ed->ed_base.eb_vtable = &evdriver_vtable;
   ed->ed_net = n;
   ed->ed_id = id;
-  ed->ed_state = new_Value(nbits);
+  ed->ed_state = EvInline_alloc(&ed->ed_inline, Net_nbits(n));
+  EvDriver_setState(ed,nlsb,s,smsb,slsb);
+  n->n_numEvents++;
 
-  if (Value_nbits(s) == nbits)
+  return (Event*) ed;
+}
+
+/*****************************************************************************
+ *
+ * Set the value a driver event will assign to its driver.
+ *
+ * Parameters:
+ *     ed		Driver event
+ *     nlsb		LSB of net to write to
+ *     s		Value to write
+ *     smsb		MSB of value to write
+ *     slsb		LSB of value to write
+ *
+ * Bits of the net outside of the written range are set to float.  This is
+ * also used to overwrite the value of an already pending driver event.
+ *
+ *****************************************************************************/
+void EvDriver_setState(EvDriver *ed,int nlsb,Value *s,int smsb,int slsb)
+{
+  if (Value_nbits(s) == Value_nbits(ed->ed_state))
     Value_copy(ed->ed_state, s);
   else {
     Value_float(ed->ed_state);
     Value_copyRange(ed->ed_state,nlsb,s,smsb,slsb);
   }
-
-  return (Event*) ed;
 }
 
 /*****************************************************************************
@@ -496,10 +631,10 @@ Event *new_EvDriver(Net *n,int id,int nlsb,Value *s,int smsb,int slsb)
  *****************************************************************************/
 void EvDriver_process(EvDriver *ed,EvQueue *q)
 {
-  Value *driver = Net_getDriver(ed->ed_net, ed->ed_id);
-  Value_copy(driver, ed->ed_state);
+  if (Net_getDriverEvent(ed->ed_net, ed->ed_id) == (Event*)ed)
+    Net_setDriverEvent(ed->ed_net, ed->ed_id, 0);
 
-  Net_driverChangeNotify(ed->ed_net, ed->ed_id);
+  Net_setDriver(ed->ed_net, ed->ed_id, ed->ed_state);
 }
 
 /*****************************************************************************
@@ -512,39 +647,77 @@ void EvDriver_process(EvDriver *ed,EvQueue *q)
  *****************************************************************************/
 void EvDriver_uninit(EvDriver *ed)
 {
-  delete_Value(ed->ed_state);
+  EvInline_free(&ed->ed_inline, ed->ed_state);
 }
 
 
 /*****************************************************************************
  *
- * Allocate a new Event using the free list if not empty
+ * Add a slab of events to the free list of a pool.
+ *
+ * Parameters:
+ *     P		Pool to grow
+ *
+ * Slabs are aligned on a cache line and never returned to the system.  The
+ * free list is built in address order so that consecutive allocations are
+ * adjacent in memory.
+ *
+ *****************************************************************************/
+static void EvPool_grow(EvPool *P)
+{
+  size_t size = (P->ep_size + THYMEEVENT_GRAIN-1) & ~(size_t)(THYMEEVENT_GRAIN-1);
+  size_t n = THYMEEVENT_SLABSIZE/size;
+  char *slab = (char*) malloc(THYMEEVENT_SLABSIZE + THYMEEVENT_CACHELINE);
+
+  slab += THYMEEVENT_CACHELINE - ((size_t)slab & (THYMEEVENT_CACHELINE-1));
+  while (n-- > 0) {
+    Event *E = (Event*) (slab + n*size);
+
+    E->ev_base.eb_status = ES_MACTIVE;
+    E->ev_base.eb_next = P->ep_free;
+    P->ep_free = E;
+  }
+  P->ep_numSlabs++;
+}
+
+/*****************************************************************************
+ *
+ * Allocate a new Event from the pool for its type
+ *
+ * Parameters:
+ *     type		Type of event to allocate
  *
  * Returns:		Uninitialized Event object.
  *
  *****************************************************************************/
-Event *new_Event()
+Event *new_Event(evtype_t type)
 {
+  EvPool *P = &event_curPools[type];
   Event *E;
 
-  if (event_freelist) {
-    E = event_freelist;
-    event_freelist = E->ev_base.eb_next;
-    E->ev_base.eb_status = ES_MACTIVE;
-  } else {
-    E = (Event*) malloc(sizeof(Event));
+  if (!P->ep_free)
+    EvPool_grow(P);
+
+  E = P->ep_free;
+  P->ep_free = E->ev_base.eb_next;
+  if (E->ev_base.eb_status == ES_FREELIST)
     E->ev_base.eb_status = ES_FACTIVE;
-  }
+
   E->ev_base.eb_vtable = 0;
   E->ev_base.eb_time = 0;
   E->ev_base.eb_next = 0;
+  E->ev_base.eb_prev = 0;
+
+  P->ep_numAlloc++;
+  if (++P->ep_inUse > P->ep_highWater)
+    P->ep_highWater = P->ep_inUse;
 
   return E;
 }
 
 /*****************************************************************************
  *
- * Return an Event to the freelist
+ * Return an Event to the free list of its pool
  *
  * Parameters:
  *     E		Event to be "deleted".
@@ -552,14 +725,114 @@ Event *new_Event()
  *****************************************************************************/
 void delete_Event(Event *e)
 {
+  EvPool *P = &event_curPools[Event_getType(e)];
+
+  if (e->ev_base.eb_status == ES_EMBEDDED)
+    return;
+
   if (e->ev_base.eb_vtable->evv_uninit)
     (*e->ev_base.eb_vtable->evv_uninit)(e);
 
   e->ev_base.eb_vtable = 0;
   e->ev_base.eb_status = ES_FREELIST;
 
-  e->ev_base.eb_next = event_freelist;
-  event_freelist = e;
+  e->ev_base.eb_next = P->ep_free;
+  P->ep_free = e;
+  P->ep_inUse--;
+}
+
+/*****************************************************************************
+ *
+ * Set up a set of pools for another thread
+ *
+ * Parameters:
+ *     pools		Array of EV_NUMTYPES pools to set up
+ *
+ *****************************************************************************/
+void Event_initPools(EvPool *pools)
+{
+  int i;
+
+  for (i = 0;i < event_pools_len;i++) {
+    memset(&pools[i],0,sizeof(EvPool));
+    pools[i].ep_name = event_pools[i].ep_name;
+    pools[i].ep_size = event_pools[i].ep_size;
+  }
+}
+
+/*****************************************************************************
+ *
+ * Select the pools used by the calling thread
+ *
+ * Parameters:
+ *     pools		Pools set up by Event_initPools() (null for the main pools)
+ *
+ *****************************************************************************/
+void Event_usePools(EvPool *pools)
+{
+  event_curPools = pools ? pools : event_pools;
+}
+
+/*****************************************************************************
+ *
+ * Add the use of a set of pools into the main pools
+ *
+ * Parameters:
+ *     pools		Pools of another thread
+ *
+ * Events allocated by another thread are returned to the main pools when
+ * they are processed.  The counts of those pools are brought up to date,
+ * and as many free events as each pool gave out are moved back to it so
+ * that events do not pile up in the main pools.  Must be called from the
+ * main thread while the thread owning the pools is idle.
+ *
+ *****************************************************************************/
+void Event_settlePools(EvPool *pools)
+{
+  int i;
+
+  for (i = 0;i < event_pools_len;i++) {
+    EvPool *P = &pools[i];
+    EvPool *M = &event_pools[i];
+
+    unsigned n = P->ep_inUse;
+
+    M->ep_numAlloc += P->ep_numAlloc;
+    M->ep_numSlabs += P->ep_numSlabs;
+    M->ep_inUse += n;
+    if (M->ep_inUse > M->ep_highWater)
+      M->ep_highWater = M->ep_inUse;
+    P->ep_numAlloc = 0;
+    P->ep_numSlabs = 0;
+    P->ep_inUse = 0;
+
+    while (n-- > 0 && M->ep_free) {
+      Event *E = M->ep_free;
+
+      M->ep_free = E->ev_base.eb_next;
+      E->ev_base.eb_next = P->ep_free;
+      P->ep_free = E;
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * Print allocation statistics for each type of event
+ *
+ *****************************************************************************/
+void Event_printStats(void)
+{
+  int i;
+
+  printf("%-8s %5s %8s %10s %6s %12s\n","type","size","in use","high water","slabs","allocations");
+  for (i = 0;i < event_pools_len;i++) {
+    EvPool *P = &event_pools[i];
+
+    if (!P->ep_numSlabs) continue;
+    printf("%-8s %5u %8u %10u %6u %12llu\n",P->ep_name,(unsigned)P->ep_size,
+	   P->ep_inUse,P->ep_highWater,P->ep_numSlabs,P->ep_numAlloc);
+  }
 }
 
 /*****************************************************************************
@@ -616,16 +889,210 @@ void EvQueue_init(EvQueue *Q)
   SQueue_init(&Q->eq_assignQ);
   SQueue_init(&Q->eq_strobeQ);
   SQueue_init(&Q->eq_inactiveQ);
+  Q->eq_assigning = 0;
+  Q->eq_parallel = 0;
   SHash_init(&Q->eq_finalQ);
   SHash_resize(&Q->eq_finalQ,4); /* Make initial hash table small for run-time efficiency */
-  Q->eq_overflowQ = 0;
+  Q->eq_levelMap = 0;
+  Q->eq_numUpper = 0;
   Q->eq_realQ = 0;
   Q->eq_monitor = 0;
   Q->eq_monitorOn = 1;
   Q->eq_monitoredChange = 0;
 
-  for (i = 0;i < THYMEWHEEL_SIZE;i++)
-    Q->eq_wheelHead[i] = Q->eq_wheelTail[i] = 0;
+  for (i = 0;i < EV_NUMTYPES;i++) {
+    Q->eq_typePending[i] = 0;
+    Q->eq_typeScheduled[i] = 0;
+  }
+  Q->eq_epochEvents = 0;
+  Q->eq_numEpochs = 0;
+  Q->eq_totalEvents = 0;
+  Q->eq_minEpochEvents = 0;
+  Q->eq_maxEpochEvents = 0;
+
+  for (i = 0;i < THYMEWHEEL_LEVELS;i++) {
+    EvLevel *L = &Q->eq_levels[i];
+    int j;
+
+    for (j = 0;j < THYMEWHEEL_LEVELSLOTS;j++)
+      L->el_head[j] = L->el_tail[j] = 0;
+    L->el_map = 0;
+  }
+
+  Q->eq_wheelHead = Q->eq_wheelTail = 0;
+  Q->eq_wheelMap = Q->eq_wheelSummary = 0;
+  EvQueue_setWheelSize(Q,THYMEWHEEL_SIZE);
+}
+
+/*****************************************************************************
+ *
+ * Set the number of slots in level 0 of the time wheel.
+ *
+ * Parameters:
+ *     Q		Queue to be resized
+ *     size		Requested number of slots
+ *
+ * The size is rounded up to a power of two in the range THYMEWHEEL_MINSIZE
+ * to THYMEWHEEL_MAXSIZE.  This must only be called before any events are
+ * scheduled.
+ *
+ *****************************************************************************/
+void EvQueue_setWheelSize(EvQueue *Q,unsigned size)
+{
+  unsigned n = THYMEWHEEL_MINSIZE;
+  int bits = 6;
+  int mapSize;
+
+  while (n < size && n < THYMEWHEEL_MAXSIZE) {
+    n <<= 1;
+    bits++;
+  }
+  mapSize = n >> 6;
+
+  free(Q->eq_wheelHead);
+  free(Q->eq_wheelTail);
+  free(Q->eq_wheelMap);
+  free(Q->eq_wheelSummary);
+
+  Q->eq_wheelSize = n;
+  Q->eq_wheelMask = n-1;
+  Q->eq_wheelBits = bits;
+  Q->eq_wheelHead = (Event**) calloc(n,sizeof(Event*));
+  Q->eq_wheelTail = (Event**) calloc(n,sizeof(Event*));
+  Q->eq_wheelMap = (unsigned long long*) calloc(mapSize,sizeof(unsigned long long));
+  Q->eq_wheelSummary = (unsigned long long*) calloc((mapSize+63)>>6,sizeof(unsigned long long));
+}
+
+/*****************************************************************************
+ *
+ * Find the first non-empty slot in level 0 of the time wheel at or after slot s.
+ *
+ * Parameters:
+ *     Q		Queue to be searched
+ *     s		Slot to start search at
+ *
+ * Returns:		Index of first non-empty slot or -1 if none.
+ *
+ *****************************************************************************/
+static int EvQueue_nextSlot(EvQueue *Q,unsigned s)
+{
+  unsigned w = s >> 6;
+  unsigned sw = w >> 6;
+  unsigned numSummary = ((Q->eq_wheelSize >> 6) + 63) >> 6;
+  unsigned long long bits;
+
+  bits = Q->eq_wheelMap[w] & (~0ULL << (s & 0x3f));
+  if (bits)
+    return (w << 6) | wheelmap_ffs(bits);
+
+  bits = ((w & 0x3f) == 0x3f) ? 0 : Q->eq_wheelSummary[sw] & (~0ULL << ((w & 0x3f)+1));
+  for (;;) {
+    if (bits) {
+      w = (sw << 6) | wheelmap_ffs(bits);
+      return (w << 6) | wheelmap_ffs(Q->eq_wheelMap[w]);
+    }
+    if (++sw >= numSummary)
+      return -1;
+    bits = Q->eq_wheelSummary[sw];
+  }
+}
+
+/*****************************************************************************
+ *
+ * Place an event in the time wheel.
+ *
+ * Parameters:
+ *     Q		Queue in which to place event
+ *     E		Event to be placed
+ *
+ * Events in the same level 0 block as the current time go directly in level 0.
+ * Other events go in the upper level given by the highest bit in which their
+ * time differs from the current time.
+ *
+ *****************************************************************************/
+static void EvQueue_place(EvQueue *Q,Event *E)
+{
+  simtime_t t = E->ev_base.eb_time;
+  simtime_t x = (t ^ Q->eq_curTime) >> Q->eq_wheelBits;
+
+  E->ev_base.eb_next = 0;
+
+  if (!x) {
+    unsigned s = t & Q->eq_wheelMask;
+
+    E->ev_base.eb_prev = Q->eq_wheelTail[s];
+    if (Q->eq_wheelTail[s]) {
+      /*
+       * Insert event on tail of slot queue
+       */
+      Q->eq_wheelTail[s]->ev_base.eb_next = E;
+      Q->eq_wheelTail[s] = E;
+    } else {
+      /*
+       * Insert event into empty slot queue
+       */
+      Q->eq_wheelTail[s] = Q->eq_wheelHead[s] = E;
+      EvQueue_markSlot(Q,s);
+    }
+  } else {
+    int k = wheelmap_msb(x) / THYMEWHEEL_LEVELBITS;
+    EvLevel *L = &Q->eq_levels[k];
+    unsigned s = (t >> EvQueue_levelShift(Q,k)) & (THYMEWHEEL_LEVELSLOTS-1);
+
+    E->ev_base.eb_prev = L->el_tail[s];
+    if (L->el_tail[s]) {
+      L->el_tail[s]->ev_base.eb_next = E;
+      L->el_tail[s] = E;
+    } else {
+      L->el_tail[s] = L->el_head[s] = E;
+      L->el_map |= 1ULL << s;
+      Q->eq_levelMap |= 1 << k;
+    }
+    Q->eq_numUpper++;
+  }
+}
+
+/*****************************************************************************
+ *
+ * Cascade events down from the upper levels of the time wheel.
+ *
+ * Parameters:
+ *     Q		Queue to be updated
+ *
+ * This function is called after advancing time.  For each upper level, the
+ * events in the slot for the block containing the current time are moved to a
+ * lower level.  Since an event is always placed in a slot after the one for
+ * the current time, a single pass over the levels is sufficient.
+ *
+ *****************************************************************************/
+static void EvQueue_cascade(EvQueue *Q)
+{
+  unsigned levels = Q->eq_levelMap;
+
+  while (levels) {
+    int k = wheelmap_msb(levels);
+    EvLevel *L = &Q->eq_levels[k];
+    unsigned s = (Q->eq_curTime >> EvQueue_levelShift(Q,k)) & (THYMEWHEEL_LEVELSLOTS-1);
+
+    levels &= ~(1 << k);
+
+    if ((L->el_map & (1ULL << s))) {
+      Event *E = L->el_head[s];
+
+      L->el_head[s] = L->el_tail[s] = 0;
+      L->el_map &= ~(1ULL << s);
+      if (!L->el_map)
+	Q->eq_levelMap &= ~(1 << k);
+
+      while (E) {
+	Event *N = E->ev_base.eb_next;
+
+	Q->eq_numUpper--;
+	EvQueue_place(Q,E);
+	E = N;
+      }
+    }
+  }
 }
 
 void Event_print(Event *e)
@@ -643,12 +1110,12 @@ void Event_print(Event *e)
 
 void EvQueue_print(EvQueue *Q)
 {
-  unsigned s = Q->eq_curTime & THYMEWHEEL_MASK;
-  unsigned i;
+  unsigned s = Q->eq_curTime & Q->eq_wheelMask;
+  unsigned i,j;
   Event *e;
 
   printf("Pending: %d S:%d\n",Q->eq_numPending,s);
-  for (i = 0;i < THYMEWHEEL_SIZE;i++) {
+  for (i = 0;i < Q->eq_wheelSize;i++) {
     if (i != s && !Q->eq_wheelHead[i]) continue;
     if (i == s)
       printf(">>%3d:",i);
@@ -687,13 +1154,18 @@ void EvQueue_print(EvQueue *Q)
     printf("\n");
   }
 
-  if (Q->eq_overflowQ) {
-    printf("  OV:");
-    for (e = Q->eq_overflowQ;e;e = e->ev_base.eb_next) {
-      printf(" ");
-      Event_print(e);
+  for (i = 0;i < THYMEWHEEL_LEVELS;i++) {
+    EvLevel *L = &Q->eq_levels[i];
+
+    for (j = 0;j < THYMEWHEEL_LEVELSLOTS;j++) {
+      if (!L->el_head[j]) continue;
+      printf("  L%d.%d:",i+1,j);
+      for (e = L->el_head[j];e;e = e->ev_base.eb_next) {
+	printf(" ");
+	Event_print(e);
+      }
+      printf("\n");
     }
-    printf("\n");
   }
 
   if (Q->eq_monitor) {
@@ -715,6 +1187,201 @@ void EvQueue_print(EvQueue *Q)
   }
 }
 
+/*****************************************************************************
+ *
+ * EvProfile - Summary of the state of the event queue used by $queue and by
+ * the profile written at exit.
+ *
+ *****************************************************************************/
+#define EVPROFILE_HISTSIZE	16
+
+typedef struct {
+  unsigned	ep_usedSlots;			/* Non-empty level 0 slots */
+  unsigned	ep_hist[EVPROFILE_HISTSIZE];	/* Slots with 2^i..2^(i+1)-1 events */
+  unsigned	ep_realLength;			/* Length of real time queue */
+  double	ep_avgEpochEvents;		/* Average events per epoch */
+  int		ep_numNets;			/* Number of entries in ep_nets */
+  Net		**ep_nets;			/* Nets with the most events */
+} EvProfile;
+
+/*****************************************************************************
+ *
+ * Collect a profile of the event queue.
+ *
+ * Parameters:
+ *     Q		Queue to profile
+ *     P		Profile to fill in
+ *     topN		Number of nets with the most scheduled events to report
+ *
+ * The nets are kept in a small array sorted by event count.  The array
+ * must be released with free().
+ *
+ *****************************************************************************/
+static void EvQueue_getProfile(EvQueue *Q,EvProfile *P,int topN)
+{
+  NetHash *nets = &Q->eq_circuit.c_nets;
+  NetHash::iterator he;
+  Event *e;
+  int s,i;
+
+  P->ep_usedSlots = 0;
+  for (i = 0;i < EVPROFILE_HISTSIZE;i++)
+    P->ep_hist[i] = 0;
+  for (s = EvQueue_nextSlot(Q,0);s >= 0;
+       s = ((unsigned)s+1 < Q->eq_wheelSize) ? EvQueue_nextSlot(Q,s+1) : -1) {
+    unsigned n = 0;
+
+    for (e = Q->eq_wheelHead[s];e;e = e->ev_base.eb_next)
+      n++;
+    i = wheelmap_msb((unsigned long long)n);
+    if (i >= EVPROFILE_HISTSIZE) i = EVPROFILE_HISTSIZE-1;
+    P->ep_hist[i]++;
+    P->ep_usedSlots++;
+  }
+
+  P->ep_realLength = 0;
+  for (e = Q->eq_realQ;e;e = e->ev_base.eb_next)
+    P->ep_realLength++;
+
+  P->ep_avgEpochEvents = Q->eq_numEpochs ? (double)Q->eq_totalEvents/Q->eq_numEpochs : 0.0;
+
+  P->ep_numNets = 0;
+  P->ep_nets = (Net**) malloc(sizeof(Net*)*(topN > 0 ? topN : 1));
+  for (he = nets->begin();he != nets->end();++he) {
+    Net *n = he->second;
+
+    if (!n->n_numEvents || he->first != n->name())
+      continue;
+    if (P->ep_numNets < topN)
+      P->ep_numNets++;
+    else if (!topN || n->n_numEvents <= P->ep_nets[topN-1]->n_numEvents)
+      continue;
+
+    for (i = P->ep_numNets-1;i > 0 && P->ep_nets[i-1]->n_numEvents < n->n_numEvents;i--)
+      P->ep_nets[i] = P->ep_nets[i-1];
+    P->ep_nets[i] = n;
+  }
+}
+
+/*****************************************************************************
+ *
+ * Report a profile of the event queue for the $queue command.
+ *
+ * Parameters:
+ *     Q		Queue to profile
+ *     topN		Number of nets with the most scheduled events to report
+ *
+ *****************************************************************************/
+void EvQueue_printProfile(EvQueue *Q,int topN)
+{
+  EvProfile P;
+  int i;
+
+  EvQueue_getProfile(Q,&P,topN);
+
+  vgio_printf("queue @ %llu pending %u\n",Q->eq_curTime,Q->eq_numPending);
+  for (i = 1;i < EV_NUMTYPES;i++)
+    vgio_printf("queue type %s %u %llu\n",event_pools[i].ep_name,
+		Q->eq_typePending[i],Q->eq_typeScheduled[i]);
+
+  vgio_printf("queue slots %u %u",P.ep_usedSlots,Q->eq_wheelSize);
+  for (i = 0;i < EVPROFILE_HISTSIZE;i++)
+    if (P.ep_hist[i])
+      vgio_printf(" %u:%u",1 << i,P.ep_hist[i]);
+  vgio_printf("\n");
+  vgio_printf("queue upper %u real %u\n",Q->eq_numUpper,P.ep_realLength);
+
+  vgio_printf("queue epochs %llu events %llu min %llu avg %.2f max %llu\n",
+	      Q->eq_numEpochs,Q->eq_totalEvents,Q->eq_minEpochEvents,
+	      P.ep_avgEpochEvents,Q->eq_maxEpochEvents);
+  vgio_printf("queue ops %llu fast %llu\n",Value_opCalls,Value_opFast);
+
+  for (i = 0;i < P.ep_numNets;i++)
+    vgio_printf("queue net %s %llu\n",P.ep_nets[i]->name(),P.ep_nets[i]->n_numEvents);
+  vgio_printf("queue end\n");
+
+  free(P.ep_nets);
+}
+
+/*****************************************************************************
+ *
+ * Write a string as a JSON string literal.
+ *
+ *****************************************************************************/
+static void json_string(FILE *f,const char *s)
+{
+  fputc('"',f);
+  for (;*s;s++) {
+    if (*s == '"' || *s == '\\')
+      fprintf(f,"\\%c",*s);
+    else if ((unsigned char)*s < ' ')
+      fprintf(f,"\\u%04x",*s);
+    else
+      fputc(*s,f);
+  }
+  fputc('"',f);
+}
+
+/*****************************************************************************
+ *
+ * Write a profile of the event queue in JSON format.
+ *
+ * Parameters:
+ *     Q		Queue to profile
+ *     f		File to write to
+ *     topN		Number of nets with the most scheduled events to report
+ *
+ *****************************************************************************/
+void EvQueue_writeProfile(EvQueue *Q,FILE *f,int topN)
+{
+  EvProfile P;
+  int i,first;
+
+  EvQueue_getProfile(Q,&P,topN);
+
+  fprintf(f,"{\n");
+  fprintf(f,"  \"time\": %llu,\n",Q->eq_curTime);
+  fprintf(f,"  \"pending\": %u,\n",Q->eq_numPending);
+
+  fprintf(f,"  \"types\": {");
+  for (i = 1;i < EV_NUMTYPES;i++)
+    fprintf(f,"%s\n    \"%s\": {\"pending\": %u, \"scheduled\": %llu}",i > 1 ? "," : "",
+	    event_pools[i].ep_name,Q->eq_typePending[i],Q->eq_typeScheduled[i]);
+  fprintf(f,"\n  },\n");
+
+  fprintf(f,"  \"wheel\": {\"size\": %u, \"used\": %u, \"histogram\": {",
+	  Q->eq_wheelSize,P.ep_usedSlots);
+  for (i = 0,first = 1;i < EVPROFILE_HISTSIZE;i++)
+    if (P.ep_hist[i]) {
+      fprintf(f,"%s\"%u\": %u",first ? "" : ", ",1 << i,P.ep_hist[i]);
+      first = 0;
+    }
+  fprintf(f,"}, \"upper\": %u, \"real\": %u},\n",Q->eq_numUpper,P.ep_realLength);
+
+  fprintf(f,"  \"epochs\": {\"count\": %llu, \"events\": %llu, \"min\": %llu, \"avg\": %.2f, \"max\": %llu},\n",
+	  Q->eq_numEpochs,Q->eq_totalEvents,Q->eq_minEpochEvents,
+	  P.ep_avgEpochEvents,Q->eq_maxEpochEvents);
+
+  fprintf(f,"  \"operators\": {\"calls\": %llu, \"fast\": %llu, \"fraction\": %.4f},\n",
+	  Value_opCalls,Value_opFast,Value_opCalls ? (double)Value_opFast/Value_opCalls : 0.0);
+
+  if (vgsim.circuit().c_levelizer)
+    Levelizer_writeProfile(vgsim.circuit().c_levelizer,f);
+  if (Q->eq_parallel)
+    Parallel_writeProfile(Q->eq_parallel,f);
+
+  fprintf(f,"  \"nets\": [");
+  for (i = 0;i < P.ep_numNets;i++) {
+    fprintf(f,"%s\n    {\"name\": ",i ? "," : "");
+    json_string(f,P.ep_nets[i]->name());
+    fprintf(f,", \"events\": %llu}",P.ep_nets[i]->n_numEvents);
+  }
+  fprintf(f,"%s]\n",P.ep_numNets ? "\n  " : "");
+  fprintf(f,"}\n");
+
+  free(P.ep_nets);
+}
+
 void
 EvQueue_go(EvQueue *Q)
 {
@@ -780,10 +1447,33 @@ void EvQueue_removeFinal(EvQueue *Q, const char *key)
  *****************************************************************************/
 void EvQueue_enqueueInactive(EvQueue *Q, Event *e)
 {
-  Q->eq_numPending++;
+  EvQueue_countIn(Q,e);
   SQueue_enqueue(&Q->eq_inactiveQ,e);
 }
 
+/*****************************************************************************
+ *
+ * Schedule an event after the pending non-blocking assignments.
+ *
+ * Parameter:
+ *     Q		Queue in which to insert event
+ *     e		Event to be placed in queue
+ *
+ * While the non-blocking assignments of an epoch are being made, the event
+ * is placed behind the ones still waiting so that it sees all of them.
+ * Otherwise it is placed in the current time slot.
+ *
+ *****************************************************************************/
+void EvQueue_enqueueAssign(EvQueue *Q, Event *e)
+{
+  if (Q->eq_assigning) {
+    e->ev_base.eb_time = Q->eq_curTime;
+    EvQueue_countIn(Q,e);
+    SQueue_enqueue(&Q->eq_assignQ,e);
+  } else
+    EvQueue_enqueueAfter(Q,e,0);
+}
+
 /*****************************************************************************
  *
  * Schedule an event in the strobe event queue.
@@ -798,7 +1488,7 @@ void EvQueue_enqueueInactive(EvQueue *Q, Event *e)
  *****************************************************************************/
 void EvQueue_enqueueStrobe(EvQueue *Q, Event *e)
 {
-  Q->eq_numPending++;
+  EvQueue_countIn(Q,e);
   SQueue_enqueue(&Q->eq_strobeQ,e);
 }
 
@@ -832,33 +1522,20 @@ void EvQueue_enqueueMonitor(EvQueue *Q, Event *e)
  *     Q		Queue in which to insert event
  *     E		Event to be placed in queue
  *
+ * On a worker of the parallel executor, the event is placed when the batch
+ * is merged.
+ *
  *****************************************************************************/
 void EvQueue_enqueue(EvQueue *Q,Event *E)
 {
-  unsigned s = E->ev_base.eb_time & THYMEWHEEL_MASK;
-
-  Q->eq_numPending++;
-  E->ev_base.eb_next = 0;
-
-  if (E->ev_base.eb_time - Q->eq_curTime >= THYMEWHEEL_SIZE) {
-    /*
-     * Insert event into overflow queue
-     */
-    Q->eq_overflowQ = EventList_insert(Q->eq_overflowQ,E);
+  if (Parallel_inWorker()) {
+    ParWorker_defer(par_worker,0,E);
     return;
-  } else if (Q->eq_wheelTail[s]) {
-    /*
-     * Insert event on tail of slot queue
-     */
-    Q->eq_wheelTail[s]->ev_base.eb_next = E;
-    Q->eq_wheelTail[s] = E;
-  } else {
-    /*
-     * Insert event into empty slot queue
-     */
-    Q->eq_wheelTail[s] = Q->eq_wheelHead[s] = E;
   }
 
+  EvQueue_countIn(Q,E);
+  EvQueue_place(Q,E);
+
 #if 0
   printf("%5llu: enqueue T=%x  QL=%d ",Q->eq_curTime,Event_getType(E),Q->eq_numPending);
   EvQueue_print(Q);printf("\n");
@@ -867,17 +1544,61 @@ void EvQueue_enqueue(EvQueue *Q,Event *E)
 
 void EvQueue_enqueueAtHead(EvQueue *Q, Event *E)
 {
-  unsigned s = Q->eq_curTime & THYMEWHEEL_MASK;
+  unsigned s = Q->eq_curTime & Q->eq_wheelMask;
 
   E->ev_base.eb_time = Q->eq_curTime;
   E->ev_base.eb_next = 0;
 
-  if (!Q->eq_wheelHead[s])
+  if (!Q->eq_wheelHead[s]) {
     Q->eq_wheelTail[s] = E;
+    EvQueue_markSlot(Q,s);
+  }
 
+  E->ev_base.eb_prev = 0;
   E->ev_base.eb_next = Q->eq_wheelHead[s];
+  if (E->ev_base.eb_next)
+    E->ev_base.eb_next->ev_base.eb_prev = E;
   Q->eq_wheelHead[s] = E;
-  Q->eq_numPending++;
+  EvQueue_countIn(Q,E);
+}
+
+
+/*****************************************************************************
+ *
+ * Append a chain of events to the current time slot.
+ *
+ * Parameters:
+ *     Q		Queue in which to place events
+ *     head		First event of the chain
+ *     tail		Last event of the chain
+ *     counts		Number of events of each type in the chain
+ *
+ * The chain must be linked in both directions.  The events are not walked,
+ * so their times are not updated.  This is harmless since times are only
+ * looked at for events beyond the current time and for driver events,
+ * which are never placed in a chain.
+ *
+ *****************************************************************************/
+void EvQueue_enqueueChain(EvQueue *Q,Event *head,Event *tail,unsigned *counts)
+{
+  unsigned s = Q->eq_curTime & Q->eq_wheelMask;
+  int i;
+
+  head->ev_base.eb_prev = Q->eq_wheelTail[s];
+  if (Q->eq_wheelTail[s])
+    Q->eq_wheelTail[s]->ev_base.eb_next = head;
+  else {
+    Q->eq_wheelHead[s] = head;
+    EvQueue_markSlot(Q,s);
+  }
+  Q->eq_wheelTail[s] = tail;
+  tail->ev_base.eb_next = 0;
+
+  for (i = 0;i < EV_NUMTYPES;i++) {
+    Q->eq_numPending += counts[i];
+    Q->eq_typePending[i] += counts[i];
+    Q->eq_typeScheduled[i] += counts[i];
+  }
 }
 
 
@@ -920,7 +1641,7 @@ void EvQueue_doFinal(EvQueue *Q)
 
 static int EvQueue_primaryPending(EvQueue *Q)
 {
-  unsigned s = Q->eq_curTime & THYMEWHEEL_MASK;
+  unsigned s = Q->eq_curTime & Q->eq_wheelMask;
 
   if (Q->eq_wheelHead[s]) return 1;
   if (Q->eq_inactiveQ.sq_head) return 1;
@@ -929,6 +1650,21 @@ static int EvQueue_primaryPending(EvQueue *Q)
 }
 
 
+/*****************************************************************************
+ *
+ * Take the event E off the head of level 0 slot s of the time wheel.
+ *
+ *****************************************************************************/
+#define EvQueue_unlinkHead(Q,s,E) { \
+    (Q)->eq_wheelHead[s] = (E)->ev_base.eb_next; \
+    if ((Q)->eq_wheelHead[s]) \
+      (Q)->eq_wheelHead[s]->ev_base.eb_prev = 0; \
+    else { \
+      (Q)->eq_wheelTail[s] = 0; \
+      EvQueue_clearSlot(Q,s); \
+    } \
+  }
+
 /*****************************************************************************
  *
  * Dequeue the next event from the current time step in the event queue.
@@ -941,7 +1677,7 @@ static int EvQueue_primaryPending(EvQueue *Q)
  *****************************************************************************/
 Event *EvQueue_dequeue(EvQueue *Q)
 {
-  unsigned s = Q->eq_curTime & THYMEWHEEL_MASK;
+  unsigned s = Q->eq_curTime & Q->eq_wheelMask;
   Event *E;
 
   for (;;) {
@@ -954,14 +1690,17 @@ Event *EvQueue_dequeue(EvQueue *Q)
     if (!Q->eq_wheelHead[s]) {
       if (Q->eq_inactiveQ.sq_head) {
 	E = SQueue_dequeue(&Q->eq_inactiveQ);
+	Q->eq_assigning = 0;
 	break;
       }
       if (Q->eq_assignQ.sq_head) {
 	E = SQueue_dequeue(&Q->eq_assignQ);
+	Q->eq_assigning = 1;
 	break;
       }
       if (Q->eq_strobeQ.sq_head) {
 	E = SQueue_dequeue(&Q->eq_strobeQ);
+	Q->eq_assigning = 0;
 	break;
       }
 
@@ -970,8 +1709,7 @@ Event *EvQueue_dequeue(EvQueue *Q)
       evtype_t etype;
 
       E = Q->eq_wheelHead[s];
-      Q->eq_wheelHead[s] = E->ev_base.eb_next;
-      if (!Q->eq_wheelHead[s]) Q->eq_wheelTail[s] = 0;
+      EvQueue_unlinkHead(Q,s,E);
 
       /*
        * If the event is a non-blocking assignment, move it to the assignQ and
@@ -980,13 +1718,16 @@ Event *EvQueue_dequeue(EvQueue *Q)
       etype = Event_getType(E);
       if (etype == EV_NET) {
 	SQueue_enqueue(&Q->eq_assignQ,E);
-      } else
+      } else {
+	Q->eq_assigning = 0;
 	break;
+      }
     }
   }
 
   E->ev_base.eb_next = 0;
-  Q->eq_numPending--;
+  EvQueue_countOut(Q,E);
+  Q->eq_epochEvents++;
 
 #if 0
   printf("%5llu: dequeue T=%x  QL=%d ",Q->eq_curTime,Event_getType(E),Q->eq_numPending);
@@ -996,6 +1737,50 @@ Event *EvQueue_dequeue(EvQueue *Q)
   return E;
 }
 
+/*****************************************************************************
+ *
+ * Dequeue the next event of the current time slot if it wakes a thread that
+ * can be run in parallel.
+ *
+ * Parameters:
+ *     Q		Queue from which to dequeue event
+ *     batch		Serial number of the batch being collected
+ *
+ * Returns:		The event, or null if the slot is empty or its next
+ *			event is of another kind.
+ *
+ * Non-blocking assignments at the head of the slot are moved to the assign
+ * queue just as by EvQueue_dequeue().  A thread already woken in the same
+ * batch is not taken a second time, since the two wakeups must be run one
+ * after the other.
+ *
+ *****************************************************************************/
+Event *EvQueue_dequeueParallel(EvQueue *Q,unsigned batch)
+{
+  unsigned s = Q->eq_curTime & Q->eq_wheelMask;
+  Event *E;
+
+  while ((E = Q->eq_wheelHead[s])) {
+    if (Event_getType(E) == EV_NET) {
+      EvQueue_unlinkHead(Q,s,E);
+      SQueue_enqueue(&Q->eq_assignQ,E);
+      continue;
+    }
+
+    if (!Event_isParallel(E) || E->ev_thread.et_thread->t_batch == batch)
+      return 0;
+
+    E->ev_thread.et_thread->t_batch = batch;
+    EvQueue_unlinkHead(Q,s,E);
+    E->ev_base.eb_next = 0;
+    EvQueue_countOut(Q,E);
+    Q->eq_epochEvents++;
+    return E;
+  }
+
+  return 0;
+}
+
 /*****************************************************************************
  *
  * Remove a specific event from the queue.
@@ -1004,38 +1789,59 @@ Event *EvQueue_dequeue(EvQueue *Q)
  *     Q		Queue from which to remove event
  *     E		Event to remove
  *
+ * The event must be pending in the time wheel.  Since all events for an
+ * epoch are in the slot determined by their time and the current time, and
+ * slots are doubly linked, this is an O(1) operation.
+ *
  *****************************************************************************/
 void EvQueue_remove(EvQueue *Q,Event *E)
 {
-  if (E->ev_base.eb_time - Q->eq_curTime < THYMEWHEEL_SIZE) {
+  simtime_t x = (E->ev_base.eb_time ^ Q->eq_curTime) >> Q->eq_wheelBits;
+  Event *P = E->ev_base.eb_prev;
+  Event *N = E->ev_base.eb_next;
+  Event **head,**tail;
+  unsigned s;
+  int k = -1;
+
+  if (!x) {
     /*
-     * Event is in main timewheel
+     * Event is in level 0 of the time wheel
      */
-    unsigned s = E->ev_base.eb_time % THYMEWHEEL_SIZE;
-    Event *P,*D;
-
-    P = 0;
-    for (D = Q->eq_wheelHead[s];D;D = D->ev_base.eb_next) {
-      if (D == E) break;
-      P = D;
-    }
-
-    if (P) {
-      P->ev_base.eb_next = E->ev_base.eb_next;
-      if (!P->ev_base.eb_next)
-	Q->eq_wheelTail[s] = P;
-    } else {
-      Q->eq_wheelHead[s] = E->ev_base.eb_next;
-      if (!Q->eq_wheelHead[s])
-	Q->eq_wheelTail[s] = 0;
-    }
+    s = E->ev_base.eb_time & Q->eq_wheelMask;
+    head = &Q->eq_wheelHead[s];
+    tail = &Q->eq_wheelTail[s];
   } else {
     /*
-     * Event is in overflow list
+     * Event is in an upper level of the time wheel
      */
+    k = wheelmap_msb(x) / THYMEWHEEL_LEVELBITS;
+    s = (E->ev_base.eb_time >> EvQueue_levelShift(Q,k)) & (THYMEWHEEL_LEVELSLOTS-1);
+    head = &Q->eq_levels[k].el_head[s];
+    tail = &Q->eq_levels[k].el_tail[s];
+    Q->eq_numUpper--;
+  }
+
+  if (P)
+    P->ev_base.eb_next = N;
+  else
+    *head = N;
 
-    Q->eq_overflowQ = EventList_remove(Q->eq_overflowQ, E);
+  if (N)
+    N->ev_base.eb_prev = P;
+  else
+    *tail = P;
+
+  if (!*head) {
+    if (k < 0) {
+      EvQueue_clearSlot(Q,s);
+    } else {
+      if (!(Q->eq_levels[k].el_map &= ~(1ULL << s)))
+	Q->eq_levelMap &= ~(1 << k);
+    }
   }
+
+  E->ev_base.eb_next = E->ev_base.eb_prev = 0;
+  EvQueue_countOut(Q,E);
 }
 
 /*****************************************************************************
@@ -1052,14 +1858,29 @@ int EvQueue_check(EvQueue *Q)
   int count = 0;
   Event *e;
 
-  for (s = 0;s < THYMEWHEEL_SIZE;s++) {
+  for (s = 0;s < Q->eq_wheelSize;s++) {
+    int isMarked = (Q->eq_wheelMap[s>>6] & (1ULL << (s&0x3f))) != 0;
+
+    if (isMarked != (Q->eq_wheelHead[s] != 0)) {
+      printf("slot %u occupancy map is inconsistent\n",s);
+      return -1;
+    }
+
     for (e = Q->eq_wheelHead[s];e;e = e->ev_base.eb_next) {
-      if (!(e->ev_base.eb_status == ES_MACTIVE || e->ev_base.eb_status == ES_FACTIVE))
+      if (!(e->ev_base.eb_status == ES_MACTIVE || e->ev_base.eb_status == ES_FACTIVE
+	    || e->ev_base.eb_status == ES_EMBEDDED))
 	return -1;
       count++;
     }
   }
 
+  for (s = 0;s < THYMEWHEEL_LEVELS;s++) {
+    unsigned j;
+
+    for (j = 0;j < THYMEWHEEL_LEVELSLOTS;j++)
+      for (e = Q->eq_levels[s].el_head[j];e;e = e->ev_base.eb_next) count++;
+  }
+
   for (e = Q->eq_inactiveQ.sq_head;e;e = e->ev_base.eb_next) count++;
   for (e = Q->eq_strobeQ.sq_head;e;e = e->ev_base.eb_next) count++;
 
@@ -1075,27 +1896,81 @@ int EvQueue_check(EvQueue *Q)
 
 /*****************************************************************************
  *
- * Promote events in the overflow queue to the main active queue.
+ * Find the time of the next epoch that has events scheduled.
  *
  * Parameters:
  *     Q		Queue to be checked.
+ *     t		Return for time of next epoch with events
  *
- * This function is called after advancing time to check for events in the
- * overflow queue that may now possibly be moved to the main active queue.
- * The overflow queue is used for events that are scheduled in the distant
- * future beyond THYMEWHEEL_SIZE epochs.  Normally we expect this queue
- * to be mostly unusued except for a something like a '#100000 $finish' statement.
+ * Returns:		Non-zero if there is a scheduled event.
+ *
+ * Level 0 of the time wheel is searched from the current slot using the
+ * occupancy map.  If it is empty, the events in the first non-empty slot of
+ * the lowest non-empty upper level are all sooner than any other events, so
+ * we only need to look at that slot.  Events in the inactive, strobe and
+ * real-time queues are not considered.
  *
  *****************************************************************************/
-void EvQueue_promoteOverflow(EvQueue *Q)
+int EvQueue_nextEventTime(EvQueue *Q,simtime_t *t)
 {
-  while (Q->eq_overflowQ && (Q->eq_overflowQ->ev_base.eb_time - Q->eq_curTime < THYMEWHEEL_SIZE)) {
-    Event *overflow_event = Q->eq_overflowQ;
+  int s = EvQueue_nextSlot(Q,Q->eq_curTime & Q->eq_wheelMask);
 
-    Q->eq_numPending--;
-    Q->eq_overflowQ = Q->eq_overflowQ->ev_base.eb_next;
-    EvQueue_enqueue(Q,overflow_event);
+  if (s >= 0) {
+    *t = (Q->eq_curTime & ~(simtime_t)Q->eq_wheelMask) | s;
+    return 1;
   }
+
+  if (Q->eq_levelMap) {
+    EvLevel *L = &Q->eq_levels[wheelmap_ffs(Q->eq_levelMap)];
+    Event *e = L->el_head[wheelmap_ffs(L->el_map)];
+
+    *t = e->ev_base.eb_time;
+    for (e = e->ev_base.eb_next;e;e = e->ev_base.eb_next)
+      if (e->ev_base.eb_time < *t)
+	*t = e->ev_base.eb_time;
+    return 1;
+  }
+
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Advance simulation time to the next epoch with events.
+ *
+ * Parameters:
+ *     Q		Queue to be advanced.
+ *
+ * Idle epochs are skipped, but time never advances beyond a pending stop
+ * time so that EVF_LIMIT (and clock watches which are converted into it)
+ * stop at exactly the same epoch as when stepping one epoch at a time.
+ * If nothing is scheduled, time advances by a single epoch.  Events in the
+ * upper levels of the time wheel are cascaded down as their block is reached.
+ *
+ *****************************************************************************/
+void EvQueue_advance(EvQueue *Q)
+{
+  simtime_t t;
+
+  if (!EvQueue_nextEventTime(Q,&t) || t <= Q->eq_curTime)
+    t = Q->eq_curTime + 1;
+
+  if ((Q->eq_flags & EVF_LIMIT) && t > Q->eq_limitTime)
+    t = imax(Q->eq_limitTime,Q->eq_curTime + 1);
+
+  /*
+   * Record the number of events processed in the epoch just completed.
+   */
+  if (!Q->eq_numEpochs || Q->eq_epochEvents < Q->eq_minEpochEvents)
+    Q->eq_minEpochEvents = Q->eq_epochEvents;
+  if (Q->eq_epochEvents > Q->eq_maxEpochEvents)
+    Q->eq_maxEpochEvents = Q->eq_epochEvents;
+  Q->eq_totalEvents += Q->eq_epochEvents;
+  Q->eq_epochEvents = 0;
+  Q->eq_numEpochs++;
+
+  Q->eq_curTime = t;
+  EvQueue_cascade(Q);
 }
 
 /*****************************************************************************
@@ -1113,8 +1988,7 @@ void EvQueue_update(EvQueue *Q)
   while (EvQueue_primaryPending(Q)) {
     e = EvQueue_dequeue(Q);
     if (e) {
-      Event_process(e,Q);
-      delete_Event(e);
+      EvQueue_runEvent(Q,e);
     }
   }
 }
@@ -1142,23 +2016,22 @@ void EvQueue_mainEventLoop(EvQueue *Q)
     Event *e = EvQueue_dequeue(Q);
     if (((Q->eq_flags & EVF_LIMIT) && Q->eq_curTime >= Q->eq_limitTime)) break;
     if (e) {
-      Event_process(e,Q);
-      delete_Event(e);
+      EvQueue_runEvent(Q,e);
     } else {
       if (Q->eq_monitoredChange)
 	EvQueue_doFinal(Q);
 
       Q->eq_monitoredChange = 0;
       if (EvQueue_pending(Q) > 0) {
-	Q->eq_curTime++;
+	EvQueue_advance(Q);
       } else {
-	if (Q->eq_realQ) {
-	  /* NOTE: There is a possible race condition if the timer event occurs after */
-	  /* the test of do_input_check.  The minor consequenses will be that a time check */
-	  /* could be delayed by one polling period. */
-	  if (!do_input_check)
-	    pause();
-	}else
+	/*
+	 * Only real time events are left.  Wait for the input thread to tell
+	 * us it is time to check them.
+	 */
+	if (Q->eq_realQ)
+	  input_wait();
+	else
 	  break;
       }
     }
@@ -1174,8 +2047,7 @@ void EvQueue_mainEventLoop(EvQueue *Q)
 	while (Q->eq_realQ && now > Q->eq_realQ->ev_base.eb_time) {
 	  Event *e = Q->eq_realQ;
 	  Q->eq_realQ = e->ev_base.eb_next;
-	  Event_process(e,Q);
-	  delete_Event(e);
+	  Event_run(e,Q);
 	}
       }
       do_input_check = 0;
@@ -1206,9 +2078,9 @@ void EvQueue_interactiveMainEventLoop(EvQueue *Q)
   int simulator_running;
 
   /*
-   * Enable asynchronous input.
+   * Start the thread reading commands from the standard input.
    */
-  input_setup();
+  input_setup(1);
 
 
   /*
@@ -1231,11 +2103,15 @@ void EvQueue_interactiveMainEventLoop(EvQueue *Q)
        *****************************************************************************/
 
       /*
-       * Asynchronously check for and process input.  We also process any real-time
-       * events here.
+       * Process any commands queued by the input thread.  We also process any
+       * real-time events here.  The flag is cleared before the queue is tested
+       * so that a command arriving in between is not missed, and set again
+       * after a command so that any further commands are also processed.
        */
       if (do_input_check && !(Q->eq_flags & EVF_NOCMD)) {
+	do_input_check = 0;
 	if (input_ready(0)) {
+	  do_input_check = 1;
 	  if (!get_line(buf,STRMAX)) return;
 	  Q->eq_circuit.exec(buf);
 	} else {
@@ -1249,12 +2125,9 @@ void EvQueue_interactiveMainEventLoop(EvQueue *Q)
 	    while (Q->eq_realQ && now > Q->eq_realQ->ev_base.eb_time) {
 	      Event *e = Q->eq_realQ;
 	      Q->eq_realQ = e->ev_base.eb_next;
-	      Event_process(e,Q);
-	      delete_Event(e);
+	      Event_run(e,Q);
 	    }
 	  }
-
-	  do_input_check = 0;
 	}
 	continue;
       }
@@ -1265,18 +2138,16 @@ void EvQueue_interactiveMainEventLoop(EvQueue *Q)
        */
       e = EvQueue_dequeue(Q);
       if (e) {
-	Event_process(e,Q);
-	delete_Event(e);
+	EvQueue_runEvent(Q,e);
       } else {
 	/*
-	 * Advance simulator time and check overflow queue to see if we can move
-	 * overflow events to the main queue.
+	 * Advance simulator time to the next epoch with events.  This will also
+	 * cascade down any events in the upper levels of the time wheel.
 	 */
 	if (Q->eq_monitoredChange)
 	  EvQueue_doFinal(Q);
-	Q->eq_curTime++;
+	EvQueue_advance(Q);
 	Q->eq_monitoredChange = 0;
-	EvQueue_promoteOverflow(Q);
 
 	/*
 	 * If the event queue is empty or we have requested a stop at this time,
@@ -1286,12 +2157,8 @@ void EvQueue_interactiveMainEventLoop(EvQueue *Q)
 	  EvQueue_stop(Q);
 	  simulator_running = 0;
 	} else if (EvQueue_pending(Q) == 0) {
-	  /* NOTE: There is a possible race condition if the timer event occurs after */
-	  /* the test of do_input_check.  The minor consequenses will be that a time check */
-	  /* could be delayed by one polling period. */
 	  if (Q->eq_realQ) {
-	    if (!do_input_check)
-	      pause();
+	    input_wait();
 	  } else
 	    simulator_running = 0;
 	}
@@ -1437,9 +2304,9 @@ void EvQueue_clockNotify(EvQueue *Q,Net *n, transtype_t tt)
 void EvQueue_timedEnqueue(EvQueue *Q, Event *E, simtime_t t)
 {
   /*
-   * Enable the timer event if not already enabled
+   * Have the input thread wake us up to check real time events.
    */
-  input_setup();
+  input_startTimer();
 
   E->ev_base.eb_time = t;
   Q->eq_realQ = Event_priorityInsert(Q->eq_realQ, E);
@@ -43,15 +43,17 @@ enum evtype_t
 	EV_PROBE = 6,	/* A probe display */
 	EV_MEM = 7	/* A memory assignment */
 };
+#define EV_NUMTYPES	8	/* Number of event type codes */
 
 /*****************************************************************************
  * evstatus_t - Event status
  *****************************************************************************/
 enum evstatus_t
 {
-	ES_MACTIVE = 1,		/* Active event allocated by malloc() */
+	ES_MACTIVE = 1,		/* Active event allocated from a new slab */
 	ES_FACTIVE = 2,		/* Active event allocated from freelist */
-	ES_FREELIST = 3		/* Event is on free list */
+	ES_FREELIST = 3,	/* Event is on free list */
+	ES_EMBEDDED = 4		/* Event is part of another object */
 };
 
 /*****************************************************************************
@@ -112,6 +114,7 @@ typedef struct {
   EventVTable	*eb_vtable;	/* Virtual table for event */
   simtime_t	eb_time;	/* Time of event */
   Event		*eb_next;	/* Next event in bucket */
+  Event		*eb_prev;	/* Previous event in bucket (time wheel only) */
   evstatus_t	eb_status;	/* Event status */
 } EvBase;
 
@@ -140,6 +143,17 @@ typedef struct {
   Value		*ep_lastValue;	/* Last value of net */
 } EvProbe;
 
+/*****************************************************************************
+ *
+ * EvInline - Storage for a value carried by an event.  Values of up to
+ * THYMEVALUE_INLINEBITS bits use a Value in the event itself rather than
+ * a separately allocated one.
+ *
+ *****************************************************************************/
+typedef struct {
+  Value		ei_value;	/* Value with inline bits */
+} EvInline;
+
 /*****************************************************************************
  *
  * EvNet - Event causing a net value to change
@@ -150,6 +164,7 @@ typedef struct {
   Net		*en_net;	/* Net which changed */
   int		en_lsb;		/* LSB in net to write to (MSB implied from en_state width) */
   Value		*en_state;	/* New value for net */
+  EvInline	en_inline;	/* Inline storage for en_state */
 } EvNet;
 
 /*****************************************************************************
@@ -162,6 +177,7 @@ typedef struct {
   Net		*ed_net;	/* Net which changed */
   int		ed_id;		/* ID of driver that changed */
   Value		*ed_state;	/* New value for net */
+  EvInline	ed_inline;	/* Inline storage for ed_state */
 } EvDriver;
 
 /*****************************************************************************
@@ -196,6 +212,7 @@ typedef struct {
   unsigned	em_addr;	/* Address in memory to change */
   int		em_lsb;		/* LSB in net to write to (MSB implied from en_state width) */
   Value		*em_state;	/* New value for memory */
+  EvInline	em_inline;	/* Inline storage for em_state */
 } EvMem;
 
 /*****************************************************************************
@@ -215,6 +232,23 @@ union Event_union {
   EvMem		ev_mem;
 };
 
+/*****************************************************************************
+ *
+ * EvPool - Slab allocator for events of one type.  Events are carved out of
+ * cache line aligned slabs and recycled through a per-type free list, so
+ * each event only takes the space needed by its own type.
+ *
+ *****************************************************************************/
+typedef struct {
+  const char	*ep_name;	/* Name of event type */
+  size_t	ep_size;	/* Size of an event */
+  Event		*ep_free;	/* Free list */
+  unsigned	ep_numSlabs;	/* Number of slabs allocated */
+  unsigned	ep_inUse;	/* Number of events currently in use */
+  unsigned	ep_highWater;	/* Most events in use at one time */
+  unsigned long long ep_numAlloc; /* Total number of allocations */
+} EvPool;
+
 /*****************************************************************************
  *
  * SQueue - Simple event queue.
@@ -237,10 +271,32 @@ typedef struct {
   deltatime_t	wc_overstep;			/* Overstep amount */
 } WClock;
 
+/*****************************************************************************
+ *
+ * EvLevel - An upper level of the hierarchical time wheel.  Each slot holds
+ * the events for one block of time with a size that is THYMEWHEEL_LEVELSLOTS
+ * times the block size of the level below it.
+ *
+ *****************************************************************************/
+typedef struct {
+  Event			*el_head[THYMEWHEEL_LEVELSLOTS];	/* Event queue for each slot */
+  Event			*el_tail[THYMEWHEEL_LEVELSLOTS];	/* Tail of queue for each slot */
+  unsigned long long	el_map;				/* One bit for each non-empty slot */
+} EvLevel;
+
 /*****************************************************************************
  *
  * EvQueue - The event queue.
  *
+ * Events are kept in a hierarchical time wheel.  Level 0 has eq_wheelSize
+ * slots of one epoch each and holds events in the same eq_wheelSize aligned
+ * block of time as the current time.  Events further in the future are placed
+ * in the upper level determined by the highest bit in which their time differs
+ * from the current time, and are cascaded down one level at a time as the
+ * current time enters their block.  At any time, all events for the same
+ * epoch are in the same slot of the same level so cascading preserves the
+ * order in which they were scheduled.
+ *
  *****************************************************************************/
 class EvQueue
 {
@@ -254,36 +310,58 @@ public:
   simtime_t	eq_limitTime;			/* Time to stop simulator if limit enabled */
 
   unsigned	eq_numPending;			/* Number of pending events */
-  Event		*eq_wheelHead[THYMEWHEEL_SIZE];	/* Event queues for each step (for dequeue) */
-  Event		*eq_wheelTail[THYMEWHEEL_SIZE];	/* Event queues for each step (for enqueue) */
+  unsigned	eq_wheelSize;			/* Number of slots in level 0 of time wheel */
+  unsigned	eq_wheelMask;			/* Mask for level 0 slots (= size-1) */
+  int		eq_wheelBits;			/* log2 of eq_wheelSize */
+  Event		**eq_wheelHead;			/* Event queues for each step (for dequeue) */
+  Event		**eq_wheelTail;			/* Event queues for each step (for enqueue) */
+  unsigned long long *eq_wheelMap;		/* One bit for each non-empty level 0 slot */
+  unsigned long long *eq_wheelSummary;		/* One bit for each non-zero word of eq_wheelMap */
+  EvLevel	eq_levels[THYMEWHEEL_LEVELS];	/* Upper levels of time wheel */
+  unsigned	eq_levelMap;			/* One bit for each non-empty upper level */
+  unsigned	eq_numUpper;			/* Number of events in upper levels */
 
   int		eq_monitorOn;			/* Non-zero if monitor is enabled */
 
   SQueue	eq_assignQ;			/* Queue for current time non-blocking assignment */
   SQueue	eq_strobeQ;			/* Queue for current strobe events */
   SQueue	eq_inactiveQ;			/* Inactive events queue (used for #0 statements) */
+  int		eq_assigning;			/* Non-zero while running an event from eq_assignQ */
+  Parallel	*eq_parallel;			/* Executor for thread events (null if none) */
   SHash		eq_finalQ;			/* Persistent events occuring at end of each step */
   Event		*eq_monitor;			/* Event for monitor execution */
-  Event		*eq_overflowQ;			/* Overflow events ouside regular time window */
   Event		*eq_realQ;			/* Events with real-time time stamps */
 
   WClock	eq_watchClock;			/* Clock watch description */
 
   int		eq_monitoredChange;		/* Monitored variables have changed in this epoch */
+
+  unsigned	eq_typePending[EV_NUMTYPES];	/* Pending events of each type */
+  unsigned long long eq_typeScheduled[EV_NUMTYPES];/* Events of each type scheduled */
+  unsigned long long eq_epochEvents;		/* Events processed in current epoch */
+  unsigned long long eq_numEpochs;		/* Number of completed epochs */
+  unsigned long long eq_totalEvents;		/* Events processed in completed epochs */
+  unsigned long long eq_minEpochEvents;		/* Fewest events processed in an epoch */
+  unsigned long long eq_maxEpochEvents;		/* Most events processed in an epoch */
 };
 
 /*****************************************************************************
  * EvQueue member functions
  *****************************************************************************/
 void EvQueue_init(EvQueue *Q);
+void EvQueue_setWheelSize(EvQueue *Q,unsigned size);
 
 void EvQueue_print(EvQueue *Q);
+void EvQueue_printProfile(EvQueue *Q,int topN);
+void EvQueue_writeProfile(EvQueue *Q,FILE *f,int topN);
 
 void EvQueue_enqueue(EvQueue *Q,Event *E);
 void EvQueue_enqueueAt(EvQueue *Q,Event *E,simtime_t t);
 void EvQueue_enqueueAfter(EvQueue *Q,Event *E,deltatime_t t);
+void EvQueue_enqueueChain(EvQueue *Q,Event *head,Event *tail,unsigned *counts);
 void EvQueue_enqueueInactive(EvQueue *Q, Event*);
 void EvQueue_enqueueStrobe(EvQueue *Q, Event*);
+void EvQueue_enqueueAssign(EvQueue *Q, Event*);
 void EvQueue_enqueueMonitor(EvQueue *Q, Event*);
 void EvQueue_timedEnqueue(EvQueue *Q, Event *E, simtime_t t);
 void EvQueue_enqueueAtHead(EvQueue *Q, Event *E);
@@ -293,9 +371,12 @@ void EvQueue_enqueueFinal(EvQueue *Q, const char *key, Event*);
 void EvQueue_removeFinal(EvQueue *Q, const char *key);
 
 Event *EvQueue_dequeue(EvQueue*);
+Event *EvQueue_dequeueParallel(EvQueue *Q,unsigned batch);
 void EvQueue_remove(EvQueue *Q,Event *E);
 
 void EvQueue_update(EvQueue *Q);
+int EvQueue_nextEventTime(EvQueue *Q,simtime_t *t);
+void EvQueue_advance(EvQueue *Q);
 void EvQueue_mainEventLoop(EvQueue *Q);
 void EvQueue_interactiveMainEventLoop(EvQueue *Q);
 int EvQueue_check(EvQueue *Q);
@@ -313,19 +394,49 @@ void EvQueue_go(EvQueue *Q);
 /*****************************************************************************
  * Event member functions
  *****************************************************************************/
-Event *new_Event();
+Event *new_Event(evtype_t);
 void delete_Event(Event*);
 Event *new_EvThread(VGThread *t);
 Event *new_EvNet(Net*,int nlsb,Value*,int smsb,int slsb);
 Event *new_EvStrobe(systask_f *task,TaskContext *tContext);
 Event *new_EvProbe(Net *n,const char *who,const char *name);
 Event *new_EvDriver(Net *n,int id,int nlsb,Value *s,int smsb,int slsb);
+void EvDriver_setState(EvDriver *ed,int nlsb,Value *s,int smsb,int slsb);
 Event *new_EvMem(Net*,Value *addr,int nlsb,Value*,int smsb,int slsb);
 Event *Event_priorityInsert(Event *PQ,Event *E);
 #define Event_process(e,q) (*(e)->ev_vtable->evv_process)(e,q)
+
+/*
+ * Process an event and return it to its pool.  An event that is part of a
+ * thread is left alone, and is looked at before it is processed since the
+ * thread may be deleted by processing it.
+ */
+#define Event_run(e,Q) { \
+    if ((e)->ev_base.eb_status == ES_EMBEDDED) \
+      Event_process(e,Q); \
+    else { \
+      Event_process(e,Q); \
+      delete_Event(e); \
+    } \
+  }
+
+/*
+ * Run an event taken from the current time slot, along with the thread
+ * events after it if it can be run in parallel with them.
+ */
+#define EvQueue_runEvent(Q,e) { \
+    if ((Q)->eq_parallel && Event_isParallel(e)) \
+      Parallel_run((Q)->eq_parallel,Q,e); \
+    else \
+      Event_run(e,Q); \
+  }
 #define Event_getType(e) (e)->ev_vtable->evv_class
 #define Event_isThreadUser(e,t) (Event_getType(e) == EV_THREAD && ((EvThread*)(e))->et_thread == (t))
 void Event_print(Event*e);
+void Event_printStats(void);
+void Event_initPools(EvPool *pools);
+void Event_usePools(EvPool *pools);
+void Event_settlePools(EvPool *pools);
 
 Event *new_EvThread(VGThread *thread);
 
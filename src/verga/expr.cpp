@@ -83,6 +83,7 @@ OpDesc *OpDesc_findFunc(valueop_f *opfunc)
 {
   int i;
 
+  opfunc = Value_kernelBase(opfunc);
   for (i = 0;i < opTable_size;i++) {
     if (opTable[i].od_opfunc == opfunc || opTable[i].od_w_opfunc == opfunc)
       return &opTable[i];
@@ -258,7 +259,7 @@ Expr *new_Expr_num(int n)
   Expr *e = (Expr*) malloc(sizeof(Expr));
 
   e->e_type = E_NUMBER;
-  e->e.snum = new_Value(SSWORDSIZE);
+  e->e.snum = new_Value(SSINTSIZE);
   Value_convertI(e->e.snum,n);
 
   return e;
@@ -279,7 +280,7 @@ Expr *new_Expr_realnum(real_t n)
   Expr *e = (Expr*) malloc(sizeof(Expr));
 
   e->e_type = E_REAL;
-  e->e.snum = new_Value(SSWORDSIZE);
+  e->e.snum = new_Value(SSINTSIZE);
   Value_convertR(e->e.snum,n);
 
   return e;
@@ -1059,7 +1060,7 @@ Value *Expr_parmEval(Expr *e,Scope *scope,parmevflags_t flags)
 	int n;
 
 	if (Specify_getSpecParm(spec,Expr_getLitName(e),mi, &n) >= 0) {
-	  v =  new_Value(SSWORDSIZE);
+	  v =  new_Value(SSINTSIZE);
 	  Value_convertI(v,n);
 	  return v;
 	}
@@ -1145,7 +1146,7 @@ static Value *Expr_vectorGenerate(Expr *e, int nbits, Scope *scope, CodeBlock *c
     Value *nAddr;
 
     src_value = new_Value(Net_nbits(n));
-    nAddr = Expr_generate(VRange_getLsb(addr),SSWORDSIZE,scope,cb);
+    nAddr = Expr_generate(VRange_getLsb(addr),SSINTSIZE,scope,cb);
     BCMemFetch_init(cb->nextEmpty(),n,nAddr, src_value);
   } else
     src_value = Net_getValue(n);
@@ -1155,7 +1156,7 @@ static Value *Expr_vectorGenerate(Expr *e, int nbits, Scope *scope, CodeBlock *c
     if (VRange_getSize(bits,scope,&width) < 0)
       return 0;
 
-    nLsb = Expr_generate(VRange_getLsb(bits),SSWORDSIZE,scope,cb);
+    nLsb = Expr_generate(VRange_getLsb(bits),SSINTSIZE,scope,cb);
   } else {
     nLsb = 0;
     width = Net_nbits(n);
@@ -1313,7 +1314,7 @@ int Expr_getBitSize(Expr *e,Scope *scope)
       }
     }
   case E_NUMBER :
-    return SSWORDSIZE;
+    return SSINTSIZE;
   case E_HEX :
     return Value_nbits(e->e.snum);
   case E_REAL :
@@ -1725,10 +1726,144 @@ Value *Expr_generate(Expr *e,int nbits,Scope *scope,CodeBlock *cb)
   return 0;
 }
 
+/*****************************************************************************
+ *
+ * Test an expression to see if it can be evaluated as a constant
+ *
+ * Parameters:
+ *     e		Expression to test
+ *     scope		Scope for parameter lookup
+ *
+ * Returns:		Non-zero if e uses only numbers, parameters and operators.
+ *
+ * This test is made before Expr_parmEvalI() where an expression that is not
+ * constant is not an error.
+ *
+ *****************************************************************************/
+static int Expr_isParmConst(Expr *e,Scope *scope)
+{
+  int i;
+
+  switch (e->e_type) {
+  case E_NUMBER :
+  case E_HEX :
+    return 1;
+  case E_LITERAL :
+    return Scope_findParm(scope,Expr_getLitName(e)) != 0;
+  case E_REAL :
+  case E_TASK :
+  case E_VECTORP :
+  case E_VECTORN :
+  case E_RANGE :
+  case E_CONCAT :
+  case E_REPCAT :
+    return 0;
+  default :
+    if (!OpDesc_find(e->e_type))
+      return 0;
+    for (i = 0;i < 3;i++)
+      if (e->e.opr[i] && !Expr_isParmConst(e->e.opr[i],scope))
+	return 0;
+    return 1;
+  }
+}
+
+/*****************************************************************************
+ *
+ * Add a range of bits of a net to a set of readers
+ *
+ * Parameters:
+ *     H		Set of readers
+ *     n		Net that is read
+ *     msb,lsb		Range of bits of n that are read
+ *
+ * A net that is read more than once is entered with the smallest slice
+ * that covers all of the ranges that are read.
+ *
+ *****************************************************************************/
+static void Expr_addReader(PHash *H,Net *n,int msb,int lsb)
+{
+  NetSlice *ns = (NetSlice*) PHash_find(H, n);
+
+  if (!ns) {
+    PHash_insert(H, n, Net_getSlice(n, msb, lsb));
+    return;
+  }
+
+  if (ns->ns_msb >= msb && ns->ns_lsb <= lsb)
+    return;
+
+  msb = imax(msb, ns->ns_msb);
+  lsb = imin(lsb, ns->ns_lsb);
+  NHash_replace(H, (intptr_t)n, Net_getSlice(n, msb, lsb));
+}
+
+/*****************************************************************************
+ *
+ * Add the bits selected from a net by a constant bit or part select
+ *
+ * Parameters:
+ *     e		Bit or part select expression
+ *     scope		Scope to use for variable lookup
+ *     H		Set of readers
+ *
+ * Returns:		Non-zero if the select was added to H.
+ *
+ * Selects from memories, or with indices that are not constant, are not
+ * added here and are treated as reads of the whole net.
+ *
+ *****************************************************************************/
+static int Expr_getSelectReader(Expr *e, Scope *scope, PHash *H)
+{
+  unsigned index, width = 1;
+  int msb, lsb;
+  Net *n;
+
+  if (!scope || Expr_type(e->e.opr[0]) != E_LITERAL) return 0;
+
+  n = Scope_findNet(scope,Expr_getLitName(e->e.opr[0]),0);
+  if (!n || (Net_getType(n) & NT_P_MEMORY) || Net_nbits(n) == 1) return 0;
+
+  if (!Expr_isParmConst(e->e.opr[1],scope)) return 0;
+  if (e->e.opr[2] && !Expr_isParmConst(e->e.opr[2],scope)) return 0;
+
+  if (Expr_parmEvalI(e->e.opr[1],scope,&index,PEF_NONE) < 0) return 0;
+  if (e->e.opr[2] && Expr_parmEvalI(e->e.opr[2],scope,&width,PEF_NONE) < 0) return 0;
+
+  switch (e->e_type) {
+  case E_VECTORP :
+    lsb = index;
+    msb = lsb + width - 1;
+    break;
+  case E_VECTORN :
+    msb = index;
+    lsb = msb - width + 1;
+    break;
+  default :					/* E_RANGE: width is the lsb */
+    msb = index;
+    lsb = e->e.opr[2] ? width : index;
+    break;
+  }
+
+  if (lsb < 0 || msb < lsb || msb >= (int)Net_nbits(n)) return 0;
+
+  Expr_addReader(H, n, msb, lsb);
+  return 1;
+}
+
 /*****************************************************************************
  *
  * Get the set of nets that are read by an expression
  *
+ * Parameters:
+ *     e		Expression to examine
+ *     scope		Scope to use for variable lookup
+ *     H		Set of readers
+ *
+ * Each net that is read is entered in H with the NetSlice of the bits that
+ * are read.  Constant bit and part selects read only the selected bits, and
+ * any other reference to a net reads all of its bits.
+ *
  *****************************************************************************/
 void Expr_getReaders(Expr*e, Scope *scope, PHash *H)
 {
@@ -1794,7 +1929,8 @@ void Expr_getReaders(Expr*e, Scope *scope, PHash *H)
   case E_VECTORP :
   case E_VECTORN :
   case E_RANGE :
-    Expr_getReaders(e->e.opr[0], scope, H);
+    if (!Expr_getSelectReader(e, scope, H))
+      Expr_getReaders(e->e.opr[0], scope, H);
     Expr_getReaders(e->e.opr[1], scope, H);
     if (e->e.opr[2])
       Expr_getReaders(e->e.opr[2], scope, H);
@@ -1807,7 +1943,7 @@ void Expr_getReaders(Expr*e, Scope *scope, PHash *H)
 
       if (!n) break;
 
-      PHash_insert(H, n, n);
+      Expr_addReader(H, n, Net_nbits(n)-1, 0);
     } else {
       PHash_insert(H, e, e);
     }
@@ -1989,28 +2125,40 @@ void Expr_makeTriggerList(Expr *trigger,List *triggerList)
  *
  * Get the default trigger from a hash table containing all the readers.
  *
+ * Nets of which all bits are read trigger on any change, and nets of which
+ * only some bits are read trigger on a change in one of those bits.
+ *
  *****************************************************************************/
 Trigger *Expr_getDefaultTriggerFromSet(PHash *P,Circuit *c)
 {
   List posedges;
   List negedges;
+  List slices;
   HashElem *he;
   Trigger *t;
 
   List_init(&posedges);
   List_init(&negedges);
+  List_init(&slices);
 
   for (he = Hash_first(P);he;he = Hash_next(P, he)) {
-    Net *n = (Net*) HashElem_obj(he);
+    NetSlice *ns = (NetSlice*) HashElem_obj(he);
+    Net *n = ns->ns_net;
+
+    if (!NetSlice_isWhole(ns)) {
+      List_addToTail(&slices, ns);
+      continue;
+    }
     List_addToTail(&posedges, n);
     if (Net_nbits(n) == 1)
       List_addToTail(&negedges, n);
   }
 
-  t = Circuit_getTrigger(c, &posedges, &negedges);
+  t = Circuit_getTrigger(c, &posedges, &negedges, &slices);
 
   List_uninit(&posedges);
   List_uninit(&negedges);
+  List_uninit(&slices);
 
   return t;
 }
@@ -2070,7 +2218,6 @@ Trigger *Expr_getTrigger(Expr *trigger,Scope *scope, StatDecl *stat)
    */
   if (!trigger) {
     PHash P;
-    HashElem *he;
 
     if (!stat) {
       errorFile(Place::getCurrent(),ERR_NONSTATCTL);
@@ -2078,23 +2225,9 @@ Trigger *Expr_getTrigger(Expr *trigger,Scope *scope, StatDecl *stat)
     }
 
     PHash_init(&P);
-    List_init(&posedges);
-    List_init(&negedges);
-
     StatDecl_getReaders(stat, scope, &P);
-
-    for (he = Hash_first(&P);he;he = Hash_next(&P, he)) {
-      Net *n = (Net*) HashElem_obj(he);
-      List_addToTail(&posedges, n);
-      if (Net_nbits(n) == 1)
-	List_addToTail(&negedges, n);
-    }
-
-    t = Circuit_getTrigger(&vgsim.circuit(), &posedges, &negedges);
-
+    t = Expr_getDefaultTriggerFromSet(&P, &vgsim.circuit());
     PHash_uninit(&P);
-    List_uninit(&posedges);
-    List_uninit(&negedges);
     return t;
   }
 
@@ -2151,7 +2284,7 @@ Trigger *Expr_getTrigger(Expr *trigger,Scope *scope, StatDecl *stat)
     }
   }
 
-  t = Circuit_getTrigger(&vgsim.circuit(), &posedges, &negedges);
+  t = Circuit_getTrigger(&vgsim.circuit(), &posedges, &negedges, 0);
 
  abortGen:
   List_uninit(&triggerList);
@@ -2396,7 +2529,7 @@ int Expr_lhsGenerate(Expr *e,Scope *scope, CodeBlock *cb,Net **n,Value **nLsb,un
     if (!nAddr) {
       return -1;
     }
-    *nAddr = Expr_generate(VRange_getLsb(addr),SSWORDSIZE,scope,cb);
+    *nAddr = Expr_generate(VRange_getLsb(addr),SSINTSIZE,scope,cb);
   } else {
     if (nAddr) *nAddr = 0;
   }
@@ -2409,7 +2542,7 @@ int Expr_lhsGenerate(Expr *e,Scope *scope, CodeBlock *cb,Net **n,Value **nLsb,un
     *size = Net_nbits(*n);
 
   if (bits) {
-    *nLsb = Expr_generate(VRange_getLsb(bits),SSWORDSIZE,scope,cb);
+    *nLsb = Expr_generate(VRange_getLsb(bits),SSINTSIZE,scope,cb);
   } else
     *nLsb = 0;
 
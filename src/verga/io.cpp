@@ -18,15 +18,34 @@
     Last edit by hansen on Wed Oct 25 10:50:09 2006
 ****************************************************************************/
 #include <cstdlib>
-#include <csignal>
 #include <cerrno>
+#include <poll.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "verga.hpp"
 
-int do_input_check = 0;			/* Flag to indicate it is time to check input */
+std::atomic<int> do_input_check(0);	/* Flag to indicate it is time to check input */
 static char cmdin_buf[STRMAX];		/* Buffer for unread characters */
 static char *cmdin_q = cmdin_buf;	/* End of unread characters */
 
+/*
+ * Command lines read by the input thread.  The input thread is the only
+ * writer of cmdq_tail and the simulator the only writer of cmdq_head, so
+ * lines are passed from one to the other without locking.  The lock and
+ * condition variables are only used to sleep while the queue is empty or
+ * full.
+ */
+static char cmdq_lines[CMDQUEUE_SIZE][STRMAX];	/* Queued command lines */
+static std::atomic<unsigned> cmdq_head(0);	/* Next line to be read by simulator */
+static std::atomic<unsigned> cmdq_tail(0);	/* Next line to be written by input thread */
+static std::atomic<int> cmdq_eof(0);		/* Standard input has been closed */
+static std::atomic<int> input_timer(0);		/* Real time events are pending */
+static std::mutex cmdq_lock;			/* Lock for sleeping on condition variables */
+static std::condition_variable cmdq_ready;	/* Input or timer tick available */
+static std::condition_variable cmdq_space;	/* Space available in cmdq_lines */
+
 
 /*****************************************************************************
  *
@@ -58,16 +77,30 @@ void waitForExit(void)
 void
 vgio_out(const char *prefix, const char *fmt, va_list ap)
 {
-	char buf[2*STRMAX];
+	char sbuf[2*STRMAX];
+	char *buf = sbuf;
 	char *p;
-	int l;
+	va_list aq;
+	int l, n;
 
 	p = buf;
 	if (vgsim.interactive() && prefix) {
 		p += sprintf(p,"%s",prefix);
 	}
 
-	vsprintf(p,fmt,ap);
+	/*
+	 * Lines that do not fit, such as wide values, are formatted again
+	 * into an allocated buffer.
+	 */
+	n = p - buf;
+	va_copy(aq,ap);
+	l = vsnprintf(p,sizeof(sbuf)-n,fmt,aq);
+	va_end(aq);
+	if (l >= (int)sizeof(sbuf)-n) {
+		buf = (char*) malloc(n+l+1);
+		memcpy(buf,sbuf,n);
+		vsprintf(buf+n,fmt,ap);
+	}
 	l = strlen(buf);
 
 	if (vgsim.interactive()) {
@@ -89,6 +122,9 @@ vgio_out(const char *prefix, const char *fmt, va_list ap)
 		}
 	} else
 		printf("%s",buf);
+
+	if (buf != sbuf)
+		free(buf);
 }
 
 /*****************************************************************************
@@ -167,91 +203,204 @@ int get_data(void)
   return c != 0;
 }
 
-int input_ready(int doWait)
+/*****************************************************************************
+ *
+ * Extract the next complete line from the buffer of unread characters.
+ *
+ * Parameters:
+ *     s		Buffer for the line (STRMAX characters)
+ *
+ * Returns:		Non-zero if a line was extracted.
+ *
+ * A full buffer with no newline is returned as a line of its own, with its
+ * last character kept in the buffer to start the next line.
+ *
+ *****************************************************************************/
+static int next_line(char *s)
 {
-  fd_set rd,wr,ex;
-  struct timeval tv;
-  int r;
+  char *p;
 
-  if (cmdin_q != cmdin_buf) return 1;
+  for (p = cmdin_buf;p != cmdin_q && *p != '\n';p++);
 
-  FD_ZERO(&rd); FD_ZERO(&wr); FD_ZERO(&ex);
-  FD_SET(0,&rd);
-  tv.tv_sec = 0;
-  tv.tv_usec = 0;
+  if (p == cmdin_q) {
+    if (cmdin_q - cmdin_buf < STRMAX)
+      return 0;
+    p--;
+  }
 
-  for (;;) {
-    if (doWait)
-      r = select(1,&rd,&wr,&ex,0);
-    else
-      r = select(1,&rd,&wr,&ex,&tv);
-    if (r >= 0 || errno != EINTR) break;
+  memcpy(s,cmdin_buf,p-cmdin_buf);
+  s[p-cmdin_buf] = 0;
+  if (*p == '\n')
+    p++;
+  memmove(cmdin_buf,p,cmdin_q-p);
+  cmdin_q = cmdin_buf+(cmdin_q-p);
+
+  return 1;
+}
+
+/*****************************************************************************
+ *
+ * Wake up the simulator to check for input and real time events.
+ *
+ *****************************************************************************/
+static void input_notify(void)
+{
+  std::lock_guard<std::mutex> l(cmdq_lock);
+
+  do_input_check = 1;
+  cmdq_ready.notify_one();
+}
+
+/*****************************************************************************
+ *
+ * Append a command line to the queue, waiting for space if it is full.
+ *
+ * Parameters:
+ *     s		Command line to queue
+ *
+ *****************************************************************************/
+static void cmdq_put(const char *s)
+{
+  unsigned t = cmdq_tail.load(std::memory_order_relaxed);
+
+  if (t - cmdq_head.load(std::memory_order_acquire) == CMDQUEUE_SIZE) {
+    std::unique_lock<std::mutex> l(cmdq_lock);
+    cmdq_space.wait(l,[t] { return t - cmdq_head.load() < CMDQUEUE_SIZE; });
   }
 
-  return (r == 1);
+  strcpy(cmdq_lines[t % CMDQUEUE_SIZE],s);
+  cmdq_tail.store(t+1,std::memory_order_release);
+  input_notify();
 }
 
 /*****************************************************************************
  *
- * Read a line of data from the standard input.
+ * Main function of the input thread.
  *
  * Parameters:
+ *     readCommands	Non-zero to read commands from the standard input
  *
- *     s		Buffer for reading characters.
- *     n
+ * The thread waits for data on the standard input and queues each complete
+ * line.  While real time events are pending, it also wakes the simulator
+ * every POLL_RATE milliseconds to check them.
  *
  *****************************************************************************/
-int get_line(char *s,int n)
+static void input_thread(int readCommands)
 {
-  char *p;
-  int got_nl = 0;
+  struct pollfd pfd;
+  char buf[STRMAX];
+
+  pfd.fd = 0;
+  pfd.events = POLLIN;
 
   for (;;) {
-    for (p = cmdin_buf;n > 0 && p != cmdin_q;p++) {
-      *s++ = *p;
-      n--;
-      if (n <= 0 || *p == '\n') {
-	got_nl = 1;
-	p++;
-	break;
-      }
-    }
-    if (p != cmdin_q) memmove(cmdin_buf,p,cmdin_q-p);
-    cmdin_q = cmdin_buf+(cmdin_q-p);
+    int r = poll(&pfd,readCommands ? 1 : 0,POLL_RATE);
 
-    if (got_nl) {
-      *s = 0;
-      if (s[-1] == '\n') s[-1] = 0;
-      return 1;
+    if (r < 0 && errno != EINTR)
+      break;
+    if (r <= 0) {
+      if (input_timer)
+	input_notify();
+      continue;
     }
 
-    if (!get_data()) return 0;
+    if (!get_data())
+      break;
+    while (next_line(buf))
+      cmdq_put(buf);
   }
 
-  return 0;
+  cmdq_eof = 1;
+  input_notify();
 }
 
-void timer_event(int p)
+/*****************************************************************************
+ *
+ * Test for a command line from the input thread.
+ *
+ * Parameters:
+ *     doWait		Non-zero to wait until a command is available
+ *
+ * Returns:		Non-zero if a command line is available or the standard
+ *			input has been closed.
+ *
+ *****************************************************************************/
+int input_ready(int doWait)
 {
-  do_input_check = 1;
-  signal(SIGALRM,timer_event);					/* Reset timer event handler */
+  if (doWait) {
+    std::unique_lock<std::mutex> l(cmdq_lock);
+    cmdq_ready.wait(l,[] { return cmdq_head.load() != cmdq_tail.load() || cmdq_eof; });
+  }
+
+  return cmdq_head.load(std::memory_order_relaxed) != cmdq_tail.load(std::memory_order_acquire) || cmdq_eof;
+}
+
+/*****************************************************************************
+ *
+ * Read a command line queued by the input thread, waiting if necessary.
+ *
+ * Parameters:
+ *     s		Buffer for reading characters.
+ *     n		Size of buffer
+ *
+ * Returns:		zero on eof, non-zero otherwise
+ *
+ *****************************************************************************/
+int get_line(char *s,int n)
+{
+  unsigned h = cmdq_head.load(std::memory_order_relaxed);
+
+  input_ready(1);
+  if (h == cmdq_tail.load(std::memory_order_acquire))
+    return 0;
+
+  strncpy(s,cmdq_lines[h % CMDQUEUE_SIZE],n);
+  s[n-1] = 0;
+  cmdq_head.store(h+1,std::memory_order_release);
+
+  std::lock_guard<std::mutex> l(cmdq_lock);
+  cmdq_space.notify_one();
+
+  return 1;
 }
 
-void input_setup(void)
+/*****************************************************************************
+ *
+ * Wait until it is time to check for input or real time events.
+ *
+ *****************************************************************************/
+void input_wait(void)
+{
+  std::unique_lock<std::mutex> l(cmdq_lock);
+
+  cmdq_ready.wait(l,[] { return do_input_check != 0 || cmdq_eof; });
+}
+
+/*****************************************************************************
+ *
+ * Start the input thread.
+ *
+ * Parameters:
+ *     readCommands	Non-zero to read commands from the standard input
+ *
+ *****************************************************************************/
+void input_setup(int readCommands)
 {
   static int is_init = 0;
-  struct itimerval itv;
-  int ms = POLL_RATE*1000;
-  int s  = POLL_RATE/1000;
 
   if (is_init) return;
   is_init = 1;
 
-#if 0
-  fcntl(0,F_SETFL,O_NONBLOCK|fcntl(0,F_GETFL));			/* Set non-blocking I/O on stdin (does not seem necessary) */
-#endif
-  itv.it_interval.tv_sec  = itv.it_value.tv_sec  = s;		/* Set up timer interval */
-  itv.it_interval.tv_usec = itv.it_value.tv_usec = ms;
-  signal(SIGALRM,timer_event);					/* Set timer event handler */
-  setitimer(ITIMER_REAL,&itv,0);				/* Enable timer */
+  std::thread(input_thread,readCommands).detach();
+}
+
+/*****************************************************************************
+ *
+ * Enable periodic checks for real time events.
+ *
+ *****************************************************************************/
+void input_startTimer(void)
+{
+  input_timer = 1;
+  input_setup(0);
 }
@@ -20,7 +20,7 @@
 #ifndef __io_h
 #define __io_h
 
-extern int do_input_check;		/* Flag to indicate input is ready */
+extern std::atomic<int> do_input_check;	/* Flag to indicate input is ready */
 
 void vgio_echo(const char *fmt,...);
 void vgio_comment(const char *fmt,...);
@@ -29,7 +29,8 @@ void waitForExit(void);
 int get_data(void);
 int input_ready(int doWait);
 int get_line(char *s,int n);
-void timer_event(int p);
-void input_setup(void);
+void input_wait(void);
+void input_setup(int readCommands);
+void input_startTimer(void);
 
 #endif
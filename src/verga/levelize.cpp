@@ -0,0 +1,383 @@
+/****************************************************************************
+    Copyright (C) 1987-2015 by Jeffery P. Hansen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+****************************************************************************/
+#include <cstdlib>
+
+#include "verga.hpp"
+
+#if defined(__GNUC__)
+#define lz_ffs(w)		__builtin_ctzll(w)
+#else
+static int lz_ffs(unsigned long long w)
+{
+  int n = 0;
+
+  while (!(w & 1)) {
+    w >>= 1;
+    n++;
+  }
+  return n;
+}
+#endif
+
+static void Levelizer_process(EvControl *e,EvQueue *Q);
+
+static EventVTable levelizer_vtable = {
+  EV_CONTROL,
+  (EventProcess_f*) Levelizer_process,
+  0
+};
+
+/*****************************************************************************
+ *
+ * Test if a gate can be levelized
+ *
+ * Parameters:
+ *     t		Thread of the gate
+ *     g		Handler loop instruction of the gate
+ *
+ * Returns:		Non-zero if the gate can be evaluated by a levelizer.
+ *
+ * The gate must be waiting to run for the first time and must not be part
+ * of a dynamic module.  Each of its assignments must be without delay and
+ * to a net that does not store charge.  Nets with several drivers are
+ * resolved by Net_setDriver() just as when a driver event is processed.
+ *
+ *****************************************************************************/
+static int Levelizer_canLevelize(VGThread *t,BCGate *g)
+{
+  unsigned i;
+
+  if (!t->t_mitem || ModuleItem_getDynamicModule(t->t_mitem))
+    return 0;
+  if (t->t_pending != (Event*) &t->t_wakeup)
+    return 0;
+
+  for (i = 0;i < g->g_nasgn;i++) {
+    BCWireAsgnD *a = BCGate_getAsgn(g,i);
+
+    if (a->a_delay || (a->a_net->n_type & (NT_P_TRIREG|NT_P_MEMORY)))
+      return 0;
+  }
+
+  return 1;
+}
+
+/*****************************************************************************
+ *
+ * Add an input dependency to a gate
+ *
+ * Parameters:
+ *     g		Gate reading a net
+ *     n		Net read by g
+ *     drivers		Table of lists of gates by the nets they drive
+ *
+ *****************************************************************************/
+static void LzGate_addInput(LzGate *g,Net *n,PHash *drivers)
+{
+  List *l = (List*) PHash_find(drivers,n);
+  ListElem *le;
+
+  if (!l) return;
+
+  for (le = List_first(l);le;le = List_next(l,le)) {
+    LzGate *d = (LzGate*) ListElem_obj(le);
+
+    List_addToTail(&d->lg_readers,g);
+    g->lg_numIn++;
+  }
+}
+
+/*****************************************************************************
+ *
+ * Create a levelizer for the gates among a set of threads
+ *
+ * Parameters:
+ *     threads		List of VGThread* to consider
+ *     Q		Event queue of the circuit
+ *
+ * Returns:		New levelizer.
+ *
+ * Gates are sorted so that each comes after the gates driving the nets it
+ * reads.  Gates on a combinational loop, and gates that depend on them, are
+ * left to be run by their threads.  The threads of the levelized gates are
+ * taken off the event queue and never run, and all of the gates are marked
+ * dirty so that the first pass computes their initial values.
+ *
+ *****************************************************************************/
+Levelizer *new_Levelizer(List *threads,EvQueue *Q)
+{
+  Levelizer *lz = (Levelizer*) calloc(1,sizeof(Levelizer));
+  LzGate *gates = (LzGate*) calloc(List_numElems(threads)+1,sizeof(LzGate));
+  PHash drivers, triggers;
+  List driverList, triggerList;
+  ListElem *le;
+  unsigned num = 0, head, i, j;
+
+  PHash_init(&drivers);
+  PHash_init(&triggers);
+  List_init(&driverList);
+  List_init(&triggerList);
+
+  /*
+   * Find the candidate gates and the nets they drive.
+   */
+  for (le = List_first(threads);le;le = List_next(threads,le)) {
+    VGThread *t = (VGThread*) ListElem_obj(le);
+    BCGate *g = VGThread_getGate(t);
+
+    if (!g || !Levelizer_canLevelize(t,g)) continue;
+
+    gates[num].lg_thread = t;
+    gates[num].lg_gate = g;
+    List_init(&gates[num].lg_readers);
+    for (i = 0;i < g->g_nasgn;i++) {
+      Net *n = BCGate_getAsgn(g,i)->a_net;
+      List *l = (List*) PHash_find(&drivers,n);
+
+      if (!l) {
+	l = new_List();
+	PHash_insert(&drivers,n,l);
+	List_addToTail(&driverList,l);
+      }
+      if (!List_last(l) || ListElem_obj(List_last(l)) != &gates[num])
+	List_addToTail(l,&gates[num]);
+    }
+    num++;
+  }
+  lz->lz_numCandidates = num;
+
+  /*
+   * Record which gates read the outputs of each gate.
+   */
+  for (i = 0;i < num;i++) {
+    Trigger *t = BCGate_getTrigger(gates[i].lg_gate);
+
+    for (le = List_first(t->t_posedges);le;le = List_next(t->t_posedges,le))
+      LzGate_addInput(&gates[i],(Net*) ListElem_obj(le),&drivers);
+    for (le = List_first(t->t_negedges);le;le = List_next(t->t_negedges,le))
+      LzGate_addInput(&gates[i],(Net*) ListElem_obj(le),&drivers);
+    for (le = List_first(t->t_slices);le;le = List_next(t->t_slices,le))
+      LzGate_addInput(&gates[i],((NetSlice*) ListElem_obj(le))->ns_net,&drivers);
+  }
+
+  /*
+   * Order the gates, starting from those that read no other gate.
+   */
+  lz->lz_order = (LzGate**) malloc((num+1)*sizeof(LzGate*));
+  for (i = 0;i < num;i++)
+    if (!gates[i].lg_numIn)
+      lz->lz_order[lz->lz_num++] = &gates[i];
+  for (head = 0;head < lz->lz_num;head++) {
+    LzGate *g = lz->lz_order[head];
+
+    for (le = List_first(&g->lg_readers);le;le = List_next(&g->lg_readers,le)) {
+      LzGate *r = (LzGate*) ListElem_obj(le);
+
+      if (--r->lg_numIn == 0)
+	lz->lz_order[lz->lz_num++] = r;
+    }
+  }
+  for (i = 0;i < num;i++)
+    List_uninit(&gates[i].lg_readers);
+  for (le = List_first(&driverList);le;le = List_next(&driverList,le))
+    delete_List((List*) ListElem_obj(le));
+
+  /*
+   * Take over the ordered gates from their threads.
+   */
+  lz->lz_dirty = (unsigned long long*) calloc((lz->lz_num+63)/64+1,sizeof(unsigned long long));
+  for (i = 0;i < lz->lz_num;i++) {
+    LzGate *g = lz->lz_order[i];
+    VGThread *t = g->lg_thread;
+    Trigger *trig = BCGate_getTrigger(g->lg_gate);
+    List *l;
+
+    g->lg_index = i;
+    g->lg_states = (Value**) calloc(g->lg_gate->g_nasgn,sizeof(Value*));
+    for (j = 0;j < g->lg_gate->g_nasgn;j++) {
+      BCWireAsgnD *a = BCGate_getAsgn(g->lg_gate,j);
+
+      if ((unsigned) Value_nbits(a->a_value) != Net_nbits(a->a_net))
+	g->lg_states[j] = new_Value(Net_nbits(a->a_net));
+    }
+
+    EvQueue_remove(Q,t->t_pending);
+    t->t_pending = 0;
+    VGThread_suspend(t);
+
+    l = (List*) PHash_find(&triggers,trig);
+    if (!l) {
+      l = new_List();
+      PHash_insert(&triggers,trig,l);
+      List_addToTail(&triggerList,trig);
+    }
+    List_addToTail(l,g);
+
+    lz->lz_dirty[i >> 6] |= 1ULL << (i & 63);
+  }
+
+  /*
+   * Give each trigger the indices of the gates reading it.
+   */
+  for (le = List_first(&triggerList);le;le = List_next(&triggerList,le)) {
+    Trigger *trig = (Trigger*) ListElem_obj(le);
+    List *l = (List*) PHash_find(&triggers,trig);
+    ListElem *ge;
+
+    trig->t_level = (unsigned*) malloc((List_numElems(l)+1)*sizeof(unsigned));
+    for (ge = List_first(l), j = 0;ge;ge = List_next(l,ge), j++)
+      trig->t_level[j] = ((LzGate*) ListElem_obj(ge))->lg_index;
+    trig->t_level[j] = LZ_END;
+    delete_List(l);
+  }
+
+  PHash_uninit(&drivers);
+  PHash_uninit(&triggers);
+  List_uninit(&driverList);
+  List_uninit(&triggerList);
+
+  lz->lz_event.ec_base.eb_vtable = &levelizer_vtable;
+  lz->lz_event.ec_base.eb_status = ES_EMBEDDED;
+  lz->lz_event.ec_data = lz;
+  lz->lz_first = 0;
+  if (lz->lz_num) {
+    lz->lz_pending = 1;
+    EvQueue_enqueueAfter(Q,(Event*) &lz->lz_event,0);
+  }
+
+  return lz;
+}
+
+/*****************************************************************************
+ *
+ * Mark gates as dirty and schedule a pass
+ *
+ * Parameters:
+ *     lz		Levelizer
+ *     gates		Indices of the gates, ended by LZ_END
+ *
+ *****************************************************************************/
+void Levelizer_wake(Levelizer *lz,unsigned *gates)
+{
+  for (;*gates != LZ_END;gates++) {
+    unsigned i = *gates;
+
+    lz->lz_dirty[i >> 6] |= 1ULL << (i & 63);
+    if (i < lz->lz_first)
+      lz->lz_first = i;
+  }
+
+  if (!lz->lz_pending) {
+    lz->lz_pending = 1;
+    EvQueue_enqueueAssign(Circuit_getQueue(&vgsim.circuit()),(Event*) &lz->lz_event);
+  }
+}
+
+/*****************************************************************************
+ *
+ * Evaluate a gate and set its drivers
+ *
+ * Parameters:
+ *     g		Gate to evaluate
+ *
+ *****************************************************************************/
+static void LzGate_eval(LzGate *g)
+{
+  BCGate *gate = g->lg_gate;
+  unsigned i;
+
+  BCGate_evaluate(gate,g->lg_thread);
+
+  for (i = 0;i < gate->g_nasgn;i++) {
+    BCWireAsgnD *a = BCGate_getAsgn(gate,i);
+    Value *s = g->lg_states[i];
+    unsigned netLsb = 0;
+
+    if (a->a_netLsb && Value_toInt(a->a_netLsb,&netLsb) < 0) {
+      Value *xs = new_Value(Value_nbits(a->a_value));
+
+      Value_unknown(xs);
+      EvQueue_enqueueAfter(VGThread_getQueue(g->lg_thread),
+			   new_EvNet(a->a_net,0,xs,a->a_valLsb+a->a_width-1,a->a_valLsb),0);
+      delete_Value(xs);
+      continue;
+    }
+
+    if (s) {
+      Value_float(s);
+      Value_copyRange(s,netLsb,a->a_value,a->a_valLsb+a->a_width-1,a->a_valLsb);
+    } else
+      s = a->a_value;
+
+    Net_setDriver(a->a_net,a->a_id,s);
+  }
+}
+
+/*****************************************************************************
+ *
+ * Run a pass over the dirty gates
+ *
+ * Parameters:
+ *     e		Pass event of the levelizer
+ *     Q		Event queue
+ *
+ * The first dirty gate is found from lz_first, which is moved back if a
+ * gate before the current one is woken during the pass.
+ *
+ *****************************************************************************/
+static void Levelizer_process(EvControl *e,EvQueue *Q)
+{
+  Levelizer *lz = (Levelizer*) e->ec_data;
+
+  lz->lz_numPasses++;
+  while (lz->lz_first < lz->lz_num) {
+    unsigned w = lz->lz_first >> 6;
+    unsigned long long bits = lz->lz_dirty[w] & (~0ULL << (lz->lz_first & 63));
+    unsigned i;
+
+    if (!bits) {
+      lz->lz_first = (w+1) << 6;
+      continue;
+    }
+
+    i = (w << 6) | lz_ffs(bits);
+    lz->lz_dirty[w] &= ~(1ULL << (i & 63));
+    lz->lz_first = i+1;
+
+    LzGate_eval(lz->lz_order[i]);
+    lz->lz_numEvals++;
+  }
+
+  lz->lz_first = lz->lz_num;
+  lz->lz_pending = 0;
+}
+
+/*****************************************************************************
+ *
+ * Write the levelizer section of a JSON profile report
+ *
+ * Parameters:
+ *     lz		Levelizer
+ *     f		File to write to
+ *
+ *****************************************************************************/
+void Levelizer_writeProfile(Levelizer *lz,FILE *f)
+{
+  fprintf(f,"  \"levelized\": {\"gates\": %u, \"candidates\": %u, \"passes\": %llu, \"evaluations\": %llu},\n",
+	  lz->lz_num,lz->lz_numCandidates,lz->lz_numPasses,lz->lz_numEvals);
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+    Copyright (C) 1987-2015 by Jeffery P. Hansen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+****************************************************************************/
+#ifndef __levelize_h
+#define __levelize_h
+
+/*
+ * End marker of the list of levelized gates in a trigger
+ */
+#define LZ_END		(~0u)
+
+/*****************************************************************************
+ *
+ * LzGate - A gate or continuous assignment evaluated by a Levelizer
+ *
+ *****************************************************************************/
+struct LzGate_str {
+  VGThread	*lg_thread;	/* Thread of the gate (never run) */
+  BCGate	*lg_gate;	/* Handler loop instruction of the gate */
+  Value		**lg_states;	/* Driver value for each assignment (null if the source is used) */
+  unsigned	lg_index;	/* Position in evaluation order */
+  unsigned	lg_numIn;	/* Inputs from gates not yet ordered (while sorting) */
+  List		lg_readers;	/* Gates reading outputs of this gate (while sorting) */
+};
+
+/*****************************************************************************
+ *
+ * Levelizer - Evaluation of zero-delay gates and continuous assignments in
+ * a single pass in topological order.
+ *
+ * Each gate has a bit in a dirty map.  A trigger that is read by gates has
+ * their indices in t_level, and firing it sets their bits and schedules a
+ * pass if none is pending.  A pass evaluates the dirty gates in order and
+ * sets their drivers directly, so that a change propagates through any
+ * depth of logic in one event instead of a thread event and a driver event
+ * for each gate.  Since the gates are in topological order, gates woken by
+ * a pass are always later in the same pass.
+ *
+ *****************************************************************************/
+struct Levelizer_str {
+  EvControl	lz_event;	/* Event running a pass */
+  int		lz_pending;	/* Non-zero if a pass is scheduled or running */
+  unsigned	lz_num;		/* Number of gates */
+  unsigned	lz_numCandidates; /* Number of gates considered */
+  LzGate	**lz_order;	/* Gates in evaluation order */
+  unsigned long long *lz_dirty;	/* One bit for each gate with a changed input */
+  unsigned	lz_first;	/* No gate before this one is dirty */
+  unsigned long long lz_numPasses; /* Number of passes */
+  unsigned long long lz_numEvals; /* Number of gate evaluations */
+};
+
+/*****************************************************************************
+ * Levelizer member functions
+ *****************************************************************************/
+Levelizer *new_Levelizer(List *threads,EvQueue *Q);
+void Levelizer_wake(Levelizer *lz,unsigned *gates);
+void Levelizer_writeProfile(Levelizer *lz,FILE *f);
+
+#endif
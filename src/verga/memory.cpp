@@ -204,6 +204,7 @@ void Memory_get(Memory *M,unsigned A,Value *data)
   memcpy(data->one, D1, bytesPerWord);
   memcpy(data->zero, D0, bytesPerWord);
   memcpy(data->flt, Dz, bytesPerWord);
+  Value_clearKnown(data);
 }
 
 void Memory_put(Memory *M,unsigned A,Value *data)
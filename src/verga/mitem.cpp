@@ -736,7 +736,7 @@ static VGThread *MIAssign_generate(MIAssign *mia, ModuleInst *mi, CodeBlock *cod
    */
   t = Expr_getDefaultTrigger(mia->mia_rhs, ModuleInst_getScope(mi));
   BCTrigger_init(codeBlock->nextEmpty(), t);
-  BCGoto_init(codeBlock->nextEmpty(), 0, 0, codeBlock,top_bc);
+  BCGate_generate(codeBlock, top_bc);
 
 #if ASGN_DEBUG
   printf("assign trigger: ");
@@ -960,7 +960,7 @@ static VGThread *MIGate_generate_multin(MIGate *mig, ModuleInst *mi,CodeBlock *c
 	 */
 	t = Expr_getDefaultTriggerFromSet(&P, mi->circuit());
 	BCTrigger_init(codeBlock->nextEmpty(), t);
-	BCGoto_init(codeBlock->nextEmpty(), 0,0,codeBlock,top_bc);
+	BCGate_generate(codeBlock, top_bc);
 
 	/*
 	 * Create thread starting at the top of the gate instance handler code.
@@ -1104,7 +1104,7 @@ static VGThread *MIGate_generate_multout(MIGate *mig, ModuleInst *mi,CodeBlock *
    */
   t = Expr_getDefaultTriggerFromSet(&P, mi->circuit());
   BCTrigger_init(codeBlock->nextEmpty(),t);
-  BCGoto_init(codeBlock->nextEmpty(), 0,0,codeBlock,top_bc);
+  BCGate_generate(codeBlock, top_bc);
 
 
 
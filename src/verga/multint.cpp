@@ -19,25 +19,24 @@
 ****************************************************************************/
 #include <cstdlib>
 #include <cctype>
+#include <cstring>
+
 
 #include "verga.hpp"
 
 /*****************************************************************************
  *
- * Helping function for divmnu (taken from Hackers Delight)
+ * Helping function for divmnu: number of leading zeros in a word.
  *
  *****************************************************************************/
-static int nlz(unsigned x) {
-   int n;
-
-   if (x == 0) return(32);
-   n = 0;
-   if (x <= 0x0000FFFF) {n = n +16; x = x <<16;}
-   if (x <= 0x00FFFFFF) {n = n + 8; x = x << 8;}
-   if (x <= 0x0FFFFFFF) {n = n + 4; x = x << 4;}
-   if (x <= 0x3FFFFFFF) {n = n + 2; x = x << 2;}
-   if (x <= 0x7FFFFFFF) {n = n + 1;}
-   return n;
+static int nlz(ssword_t x)
+{
+  if (x == 0) return SSWORDSIZE;
+#if (SSWORDSIZE == 64)
+  return __builtin_clzll(x);
+#else
+  return __builtin_clz(x);
+#endif
 }
 
 /******************************************************************************
@@ -49,18 +48,18 @@ static int nlz(unsigned x) {
  *      r		Remainder return, size n
  *      u		Dividend (top of fraction), size m
  *      v		Divisor (bottom of fraction), size n
- *      m		Number of half-words in dividend u
- *      n		Number of half-words in divisor v
+ *      m		Number of words in dividend u
+ *      n		Number of words in divisor v
  *
- * q[0], r[0], u[0], and v[0] contain the LEAST significant halfwords.
+ * q[0], r[0], u[0], and v[0] contain the LEAST significant words.
  * (The sequence is in little-endian order).
- * This first version is a fairly precise implementation of Knuth's
- * Algorithm D, for a binary computer with base b = 2**16.  The caller
- * supplies
- *   1. Space q for the quotient, m - n + 1 halfwords (at least one).
- *   2. Space r for the remainder (optional), n halfwords.
- *   3. The dividend u, m halfwords, m >= 1.
- *   4. The divisor v, n halfwords, n >= 2.
+ * This is Knuth's Algorithm D for a binary computer with base b = 2**SSWORDSIZE.
+ * Each quotient digit is estimated from the top two words of the remainder
+ * using a double word (ssdword_t) division.  The caller supplies
+ *   1. Space q for the quotient, m - n + 1 words (at least one).
+ *   2. Space r for the remainder (optional), n words.
+ *   3. The dividend u, m words, m >= 1.
+ *   4. The divisor v, n words, n >= 1.
  * The most significant digit of the divisor, v[n-1], must be nonzero.  The
  * dividend u may have leading zeros; this just makes the algorithm take
  * longer and makes the quotient contain more leading zeros.  A value of
@@ -70,33 +69,31 @@ static int nlz(unsigned x) {
  * The quotient and remainder returned may have leading zeros.  The
  * function itself returns a value of 0 for success and 1 for invalid
  * parameters (e.g., division by 0).
- * For now, we must have m >= n.  Knuth's Algorithm D also requires
- * that the dividend be at least as long as the divisor.  (In his terms,
- * m >= 0 (unstated).  Therefore m+n >= n.)
  *
  *****************************************************************************/
-
-static int divmnu(unsigned short q[], unsigned short r[],
-     const unsigned short u[], const unsigned short v[],
+static int divmnu(ssword_t q[], ssword_t r[],
+     const ssword_t u[], const ssword_t v[],
      int m, int n) {
 
-   const unsigned b = 65536; // Number base (16 bits).
-   unsigned short *un, *vn;  // Normalized form of u, v.
-   unsigned qhat;            // Estimated quotient digit.
-   unsigned rhat;            // A remainder.
-   unsigned p;               // Product of two digits.
-   int s, i, j, t, k;
+   const ssdword_t b = (ssdword_t)1 << SSWORDSIZE; // Number base.
+   ssword_t *un, *vn;        // Normalized form of u, v.
+   ssdword_t qhat;           // Estimated quotient digit.
+   ssdword_t rhat;           // A remainder.
+   ssdword_t p;              // Product of two digits.
+   ssword_t carry, borrow, t;
+   int s, i, j, neg;
 
    if (m < n || n <= 0 || v[n-1] == 0)
       return 1;              // Return if invalid param.
 
    if (n == 1) {                        // Take care of
-      k = 0;                            // the case of a
+      ssdword_t k = 0;                  // the case of a
       for (j = m - 1; j >= 0; j--) {    // single-digit
-         q[j] = (k*b + u[j])/v[0];      // divisor here.
-         k = (k*b + u[j]) - q[j]*v[0];
+         p = (k << SSWORDSIZE) | u[j];  // divisor here.
+         q[j] = (ssword_t)(p/v[0]);
+         k = p - (ssdword_t)q[j]*v[0];
       }
-      if (r != NULL) r[0] = k;
+      if (r != NULL) r[0] = (ssword_t)k;
       return 0;
    }
 
@@ -104,58 +101,65 @@ static int divmnu(unsigned short q[], unsigned short r[],
    // its high-order bit is on, and shift u left the
    // same amount.  We may have to append a high-order
    // digit on the dividend; we do that unconditionally.
+   // The shifts right by SSWORDSIZE-s are done in a
+   // double word so that s == 0 is well defined.
 
-   s = nlz(v[n-1]) - 16;        // 0 <= s <= 16.
-   vn = (unsigned short *)alloca(2*n);
+   s = nlz(v[n-1]);             // 0 <= s < SSWORDSIZE.
+   vn = (ssword_t *)alloca(sizeof(ssword_t)*n);
    for (i = n - 1; i > 0; i--)
-      vn[i] = (v[i] << s) | (v[i-1] >> (16-s));
+      vn[i] = (v[i] << s) | (ssword_t)((ssdword_t)v[i-1] >> (SSWORDSIZE-s));
    vn[0] = v[0] << s;
 
-   un = (unsigned short *)alloca(2*(m + 1));
-   un[m] = u[m-1] >> (16-s);
+   un = (ssword_t *)alloca(sizeof(ssword_t)*(m + 1));
+   un[m] = (ssword_t)((ssdword_t)u[m-1] >> (SSWORDSIZE-s));
    for (i = m - 1; i > 0; i--)
-      un[i] = (u[i] << s) | (u[i-1] >> (16-s));
+      un[i] = (u[i] << s) | (ssword_t)((ssdword_t)u[i-1] >> (SSWORDSIZE-s));
    un[0] = u[0] << s;
 
    for (j = m - n; j >= 0; j--) {       // Main loop.
       // Compute estimate qhat of q[j].
-      qhat = (un[j+n]*b + un[j+n-1])/vn[n-1];
-      rhat = (un[j+n]*b + un[j+n-1]) - qhat*vn[n-1];
+      p = ((ssdword_t)un[j+n] << SSWORDSIZE) | un[j+n-1];
+      qhat = p/vn[n-1];
+      rhat = p - qhat*vn[n-1];
    again:
-      if (qhat >= b || qhat*vn[n-2] > b*rhat + un[j+n-2]) {
-	qhat = qhat - 1;
+      if (qhat >= b || qhat*vn[n-2] > ((rhat << SSWORDSIZE) | un[j+n-2])) {
+        qhat = qhat - 1;
         rhat = rhat + vn[n-1];
         if (rhat < b) goto again;
       }
 
       // Multiply and subtract.
-      k = 0;
+      carry = 0;
+      borrow = 0;
       for (i = 0; i < n; i++) {
-         p = qhat*vn[i];
-         t = un[i+j] - k - (p & 0xFFFF);
-         un[i+j] = t;
-         k = (p >> 16) - (t >> 16);
+         p = qhat*vn[i] + carry;
+         carry = (ssword_t)(p >> SSWORDSIZE);
+         t = un[i+j] - (ssword_t)p;
+         neg = (un[i+j] < (ssword_t)p) | (t < borrow);
+         un[i+j] = t - borrow;
+         borrow = neg;
       }
-      t = un[j+n] - k;
-      un[j+n] = t;
+      p = (ssdword_t)carry + borrow;
+      neg = ((ssdword_t)un[j+n] < p);
+      un[j+n] = (ssword_t)(un[j+n] - p);
 
-      q[j] = qhat;              // Store quotient digit.
-      if (t < 0) {              // If we subtracted too
+      q[j] = (ssword_t)qhat;    // Store quotient digit.
+      if (neg) {                // If we subtracted too
          q[j] = q[j] - 1;       // much, add back.
-         k = 0;
+         carry = 0;
          for (i = 0; i < n; i++) {
-            t = un[i+j] + vn[i] + k;
-            un[i+j] = t;
-            k = t >> 16;
+            p = (ssdword_t)un[i+j] + vn[i] + carry;
+            un[i+j] = (ssword_t)p;
+            carry = (ssword_t)(p >> SSWORDSIZE);
          }
-         un[j+n] = un[j+n] + k;
+         un[j+n] = un[j+n] + carry;
       }
    } // End j.
    // If the caller wants the remainder, unnormalize
    // it and pass it back.
    if (r != NULL) {
       for (i = 0; i < n; i++)
-         r[i] = (un[i] >> s) | (un[i+1] << (16-s));
+         r[i] = (un[i] >> s) | (ssword_t)((ssdword_t)un[i+1] << (SSWORDSIZE-s));
    }
    return 0;
 }
@@ -170,7 +174,7 @@ static int divmnu(unsigned short q[], unsigned short r[],
  *      n		Number of word parts.
  *
  *****************************************************************************/
-int multint_iszero(unsigned *x,int n)
+int multint_iszero(ssword_t *x,int n)
 {
   int i;
 
@@ -179,7 +183,7 @@ int multint_iszero(unsigned *x,int n)
   return 1;
 }
 
-void multint_makezero(unsigned *x,int n)
+void multint_makezero(ssword_t *x,int n)
 {
   int i;
 
@@ -187,7 +191,7 @@ void multint_makezero(unsigned *x,int n)
     x[i] = 0;
 }
 
-void multint_copy(unsigned *x,unsigned *a,int n)
+void multint_copy(ssword_t *x,ssword_t *a,int n)
 {
   int i;
 
@@ -197,118 +201,47 @@ void multint_copy(unsigned *x,unsigned *a,int n)
 
 /*****************************************************************************
  *
- * Divide multi-word int by ten and return the remainder.
+ * Divide multi-word int by ten and return the remainder.  The division runs
+ * from the most significant word down, one half word at a time so that
+ * each partial dividend fits in a single word.
  *
  * Parameters:
  *      x		Array of int word parts.
  *      n		Number of word parts.
  *
  *****************************************************************************/
-unsigned multint_div10(unsigned *x,int n)
+unsigned multint_div10(ssword_t *x,int n)
 {
-  const unsigned K1 = 429496729;	/* 2^32 / 10 */
-  const unsigned K2 = 6;		/* 2^32 % 10 */
-  unsigned r,ry,rx;
-  unsigned delta;
-
-  r = x[0] % 10;
-  x[0] /= 10;
-
-  if (n == 1)
-    return r;
-
-  ry = multint_div10(x+1,n-1);
-  rx = K2*ry;
-  delta = K1*ry + (rx + r) / 10;
-
-  x[0] += delta;
+  ssword_t r = 0;
+  ssword_t hi,lo;
+  int i;
 
-  r = (rx + r) % 10;
+  for (i = n-1;i >= 0;i--) {
+    hi = (r << (SSWORDSIZE/2)) | (x[i] >> (SSWORDSIZE/2));
+    r = hi % 10;
+    lo = (r << (SSWORDSIZE/2)) | (x[i] & SSHALFWORDMASK);
+    r = lo % 10;
+    x[i] = ((hi / 10) << (SSWORDSIZE/2)) | (lo / 10);
+  }
 
-  return r;
+  return (unsigned)r;
 }
 
 /*****************************************************************************
  *
- * Multiply multi-word int by ten
+ * Trim leading zero words from a multi-word integer.
  *
  * Parameters:
  *      x		Array of int word parts.
  *      n		Number of word parts.
  *
- *****************************************************************************/
-void multint_mul10(unsigned *x,int n)
-{
-  int i;
-  unsigned carry = 0;
-  unsigned xcarry = 0;
-  unsigned nextcarry;
-
-  /* 1010*/
-
-  //SSWORDSIZE
-
-  for (i = 0;i < n;i++) {
-    unsigned Xh = (x[i] >> (SSWORDSIZE/2)) & SSHALFWORDMASK;
-    unsigned Xl =  x[i] & SSHALFWORDMASK;
-    unsigned P1 = Xh*10;
-    unsigned P3 = Xl*10 >> (SSWORDSIZE/2);
-
-    xcarry = 0;
-    nextcarry = P1;
-    if (nextcarry + P3 < nextcarry) xcarry++;
-    nextcarry += P3;
-    nextcarry = (nextcarry >> (SSWORDSIZE/2)) + xcarry;
-
-    x[i] = x[i] * 10 + carry;
-    carry = nextcarry;
-  }
-}
-
-/*****************************************************************************
- *
- * Convert multi-word int to string
- *
- * Parameters:
- *      x		Array of integers with word parts
- *      n		Number  of elements in array
- *      buf		Buffer to write string to
- *      len		Size of string buffer
- *
+ * Returns:		Number of words up to and including the highest non-zero word.
  *
  *****************************************************************************/
-int multint_getstr(unsigned *x,int n,char *buf,int len)
+static int multint_len(ssword_t *x,int n)
 {
-  unsigned *v;
-  char *p = buf;
-  char *q;
-  int i;
-
-  v = (unsigned*)malloc(sizeof(unsigned)*n);
-  for (i = 0;i < n;i++)
-    v[i] = x[i];
-
-  if (multint_iszero(x,n)) {
-    sprintf(buf,"0");
-    return 0;
-  }
-
-  while (!multint_iszero(v,n)) {
-    *p++ = multint_div10(v,n) + '0';
-    if (--len <= 0) return -1;		/* Not enough space */
-  }
-  *p-- = 0;
-  q = buf;
-  while (q < p) {
-    char t = *q;
-    *q = *p;
-    *p = t;
-    q++; p--;
-  }
-
-  free(v);
-
-  return 0;
+  while (n > 0 && x[n-1] == 0) n--;
+  return n;
 }
 
 /*****************************************************************************
@@ -322,55 +255,25 @@ int multint_getstr(unsigned *x,int n,char *buf,int len)
  *      l		Number of array elements
  *
  *****************************************************************************/
-int multint_div(unsigned *x,unsigned *a,unsigned *b,int l)
+int multint_div(ssword_t *x,ssword_t *a,ssword_t *b,int l)
 {
-  static int allocLen = 0;
-  static unsigned short *q = 0,*u = 0,*v = 0;
-  int numParts = sizeof(unsigned)/2;
-  int m,n,i,j,k;
+  static thread_local int allocLen = 0;
+  static thread_local ssword_t *q = 0;
+  int m,n;
 
   /*
-   * division code assumes 16-bit shorts.
+   * Reallocate temp array if necessary
    */
-  if (sizeof(unsigned short) != 2) {
-    /* error: unsupported architecture */
-    return -2;
-  }
-
-  /*
-   * Reallocate temp arrays if necessary
-   */
-  if (allocLen < l*numParts) {
-    allocLen = l*numParts;
+  if (allocLen < l) {
+    allocLen = l;
     if (q) free(q);
-    if (u) free(u);
-    if (v) free(v);
-    q = (unsigned short*) malloc(sizeof(unsigned short)*allocLen);
-    u = (unsigned short*) malloc(sizeof(unsigned short)*allocLen);
-    v = (unsigned short*) malloc(sizeof(unsigned short)*allocLen);
-  }
-
-  m = l*numParts;
-  n = l*numParts;
-
-  k = 0;
-  for (i = 0;i < l;i++) {
-    unsigned aword = a[i];
-    unsigned bword = b[i];
-
-    for (j = 0;j < numParts;j++) {
-      u[k] = aword & 0xffff;
-      v[k] = bword & 0xffff;
-      aword >>= 16;
-      bword >>= 16;
-      k++;
-    }
+    q = (ssword_t*) malloc(sizeof(ssword_t)*allocLen);
   }
 
   /*
-   * Trim off leading zeros from dividend.  If all words are zero, then we have a divide by zero error.
+   * Trim off leading zeros from divisor.  If all words are zero, then we have a divide by zero error.
    */
-  while (n > 0 && v[n-1] == 0) n--;
+  n = multint_len(b,l);
   if (n == 0) {
     /* error: divide by zero */
     multint_makezero(x,l);
@@ -380,7 +283,7 @@ int multint_div(unsigned *x,unsigned *a,unsigned *b,int l)
   /*
    * Trim off leading zeros from dividend.  If all words are zero, then the result is zero.
    */
-  while (m > 0 && u[m-1] == 0) m--;
+  m = multint_len(a,l);
   if (m == 0) {
     multint_makezero(x,l);
     return 0;
@@ -397,21 +300,13 @@ int multint_div(unsigned *x,unsigned *a,unsigned *b,int l)
   /*
    * Do the division operation
    */
-  divmnu(q,0,u,v,m,n);
+  divmnu(q,0,a,b,m,n);
 
   /*
-   * Compute result size
+   * Copy the m-n+1 word quotient and zero the rest of the result
    */
-  m = m-n+1;
-
-  k = 0;
-  for (i = 0;i < l;i++) {
-    x[i] = 0;
-    for (j = 0;j < numParts;j++) {
-      if (k < m)
-	x[i] |= q[k++] << 16*j;
-    }
-  }
+  multint_copy(x,q,m-n+1);
+  multint_makezero(x+m-n+1,l-(m-n+1));
 
   return 0;
 }
@@ -427,57 +322,27 @@ int multint_div(unsigned *x,unsigned *a,unsigned *b,int l)
  *      n		Number of array elements
  *
  *****************************************************************************/
-int multint_mod(unsigned *x,unsigned *a,unsigned *b,int l)
+int multint_mod(ssword_t *x,ssword_t *a,ssword_t *b,int l)
 {
-  static int allocLen = 0;
-  static unsigned short *q = 0,*r = 0,*u = 0,*v = 0;
-  int numParts = sizeof(unsigned)/2;
-  int m,n,i,j,k;
-
-  /*
-   * division code assumes 16-bit shorts.
-   */
-  if (sizeof(unsigned short) != 2) {
-    /* error: unsupported architecture */
-    return -2;
-  }
+  static thread_local int allocLen = 0;
+  static thread_local ssword_t *q = 0,*r = 0;
+  int m,n;
 
   /*
    * Reallocate temp arrays if necessary
    */
-  if (allocLen < l*numParts) {
-    allocLen = l*numParts;
+  if (allocLen < l) {
+    allocLen = l;
     if (q) free(q);
     if (r) free(r);
-    if (u) free(u);
-    if (v) free(v);
-    q = (unsigned short*) malloc(sizeof(unsigned short)*allocLen);
-    r = (unsigned short*) malloc(sizeof(unsigned short)*allocLen);
-    u = (unsigned short*) malloc(sizeof(unsigned short)*allocLen);
-    v = (unsigned short*) malloc(sizeof(unsigned short)*allocLen);
-  }
-
-  m = l*numParts;
-  n = l*numParts;
-
-  k = 0;
-  for (i = 0;i < l;i++) {
-    unsigned aword = a[i];
-    unsigned bword = b[i];
-
-    for (j = 0;j < numParts;j++) {
-      u[k] = aword & 0xffff;
-      v[k] = bword & 0xffff;
-      aword >>= 16;
-      bword >>= 16;
-      k++;
-    }
+    q = (ssword_t*) malloc(sizeof(ssword_t)*allocLen);
+    r = (ssword_t*) malloc(sizeof(ssword_t)*allocLen);
   }
 
   /*
-   * Trim off leading zeros from dividend.  If all words are zero, then we have a divide by zero error.
+   * Trim off leading zeros from divisor.  If all words are zero, then we have a divide by zero error.
    */
-  while (n > 0 && v[n-1] == 0) n--;
+  n = multint_len(b,l);
   if (n == 0) {
     /* error: divide by zero */
     multint_makezero(x,l);
@@ -487,14 +352,14 @@ int multint_mod(unsigned *x,unsigned *a,unsigned *b,int l)
   /*
    * Trim off leading zeros from dividend.  If all words are zero, then the result is zero.
    */
-  while (m > 0 && u[m-1] == 0) m--;
+  m = multint_len(a,l);
   if (m == 0) {
     multint_makezero(x,l);
     return 0;
   }
 
   /*
-   * If divisor is bigger than the dividend, then the quotient is zero.
+   * If divisor is bigger than the dividend, then the remainder is the dividend.
    */
   if (n > m) {
     multint_copy(x,a,l);
@@ -504,23 +369,206 @@ int multint_mod(unsigned *x,unsigned *a,unsigned *b,int l)
   /*
    * Do the division operation
    */
-  divmnu(q,r,u,v,m,n);
+  divmnu(q,r,a,b,m,n);
 
-  k = 0;
-  for (i = 0;i < l;i++) {
-    x[i] = 0;
-    for (j = 0;j < numParts;j++) {
-      if (k < n)
-	x[i] |= r[k++] << 16*j;
+  multint_copy(x,r,n);
+  multint_makezero(x+n,l-n);
+
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Add a multi-word integer into another.
+ *
+ * Parameters:
+ *      x		Integer to add to (n words)
+ *      a		Integer to add (n words)
+ *      n		Number of words
+ *
+ * Returns:		Carry out of the top word.
+ *
+ *****************************************************************************/
+static ssword_t multint_addto(ssword_t *x,const ssword_t *a,int n)
+{
+  ssdword_t t;
+  ssword_t carry = 0;
+  int i;
+
+  for (i = 0;i < n;i++) {
+    t = (ssdword_t)x[i] + a[i] + carry;
+    x[i] = (ssword_t)t;
+    carry = (ssword_t)(t >> SSWORDSIZE);
+  }
+
+  return carry;
+}
+
+/*****************************************************************************
+ *
+ * Subtract a multi-word integer from another.
+ *
+ * Parameters:
+ *      x		Integer to subtract from (n words)
+ *      a		Integer to subtract (n words)
+ *      n		Number of words
+ *
+ * Returns:		Borrow out of the top word.
+ *
+ *****************************************************************************/
+static ssword_t multint_subfrom(ssword_t *x,const ssword_t *a,int n)
+{
+  ssword_t borrow = 0;
+  ssword_t t,b1;
+  int i;
+
+  for (i = 0;i < n;i++) {
+    t = x[i] - a[i];
+    b1 = (x[i] < a[i]);
+    x[i] = t - borrow;
+    borrow = b1 | (t < borrow);
+  }
+
+  return borrow;
+}
+
+/*****************************************************************************
+ *
+ * Propagate a carry or borrow into a multi-word integer.
+ *
+ * Parameters:
+ *      x		Integer to add carry to or subtract borrow from
+ *      carry		Carry to add to x[0] (or borrow to subtract)
+ *      n		Number of words in x
+ *
+ *****************************************************************************/
+static void multint_carry(ssword_t *x,ssword_t carry,int n)
+{
+  int i;
+
+  for (i = 0;carry && i < n;i++) {
+    x[i] += carry;
+    carry = (x[i] < carry);
+  }
+}
+
+static void multint_borrow(ssword_t *x,ssword_t borrow,int n)
+{
+  ssword_t t;
+  int i;
+
+  for (i = 0;borrow && i < n;i++) {
+    t = x[i];
+    x[i] = t - borrow;
+    borrow = (t < borrow);
+  }
+}
+
+/*****************************************************************************
+ *
+ * Comba (column-wise) multiply.  Each word of the product is the sum of
+ * one column of partial products, kept in a three word accumulator, so
+ * every product word is stored exactly once.
+ *
+ * Parameters:
+ *      x		Product return (m words, must not overlap a or b)
+ *      a		Operand 1 (n words)
+ *      b		Operand 2 (n words)
+ *      n		Number of words in the operands
+ *      m		Number of low words of the product to form (n or 2n)
+ *
+ *****************************************************************************/
+static void multint_comba(ssword_t *x,const ssword_t *a,const ssword_t *b,int n,int m)
+{
+  ssdword_t acc = 0;		/* Low two words of the column sum */
+  ssword_t over = 0;		/* Third word of the column sum */
+  ssdword_t p;
+  int i,k,lo,hi;
+
+  for (k = 0;k < m;k++) {
+    lo = (k < n) ? 0 : k-n+1;
+    hi = (k < n) ? k : n-1;
+
+    for (i = lo;i <= hi;i++) {
+      p = (ssdword_t)a[i]*b[k-i];
+      acc += p;
+      over += (acc < p);
     }
+
+    x[k] = (ssword_t)acc;
+    acc = (acc >> SSWORDSIZE) | ((ssdword_t)over << SSWORDSIZE);
+    over = 0;
+  }
+}
+
+/*****************************************************************************
+ *
+ * Karatsuba multiply giving the full 2n word product.  The operands are
+ * split into a low half of h words and a high half of l words, and the
+ * product is formed from three half size products:
+ *
+ *     a*b = z2*B^2h + (z1 - z2 - z0)*B^h + z0
+ *
+ * with z0 = a0*b0, z2 = a1*b1 and z1 = (a0+a1)*(b0+b1).  Operands below
+ * MULTINT_KARATSUBA words use the Comba multiply.
+ *
+ * Parameters:
+ *      x		Product return (2n words, must not overlap a or b)
+ *      a		Operand 1 (n words)
+ *      b		Operand 2 (n words)
+ *      n		Number of words in the operands
+ *
+ *****************************************************************************/
+static void multint_karatsuba(ssword_t *x,const ssword_t *a,const ssword_t *b,int n)
+{
+  int h = n/2;
+  int l = n-h;
+  ssword_t *sa,*sb,*z1;
+
+  if (n < MULTINT_KARATSUBA) {
+    multint_comba(x,a,b,n,2*n);
+    return;
   }
 
-  return 0;
+  sa = (ssword_t*)alloca(sizeof(ssword_t)*(l+1));
+  sb = (ssword_t*)alloca(sizeof(ssword_t)*(l+1));
+  z1 = (ssword_t*)alloca(sizeof(ssword_t)*2*(l+1));
+
+  /*
+   * z0 and z2 go straight into the low and high parts of the product.
+   */
+  multint_karatsuba(x,a,b,h);
+  multint_karatsuba(x+2*h,a+h,b+h,l);
+
+  /*
+   * Half sums a0+a1 and b0+b1, which take l+1 words.
+   */
+  multint_copy(sa,(ssword_t*)a+h,l);
+  multint_copy(sb,(ssword_t*)b+h,l);
+  sa[l] = sb[l] = 0;
+  multint_carry(sa+h,multint_addto(sa,a,h),l+1-h);
+  multint_carry(sb+h,multint_addto(sb,b,h),l+1-h);
+
+  multint_karatsuba(z1,sa,sb,l+1);
+
+  /*
+   * z1 - z0 - z2 is the middle term and is never negative.  Adding it in
+   * at word h can carry up to the top of the product.
+   */
+  multint_borrow(z1+2*h,multint_subfrom(z1,x,2*h),2*(l+1)-2*h);
+  multint_borrow(z1+2*l,multint_subfrom(z1,x+2*h,2*l),2);
+  multint_carry(x+h+2*(l+1),multint_addto(x+h,z1,2*(l+1)),h-2);
 }
 
 /*****************************************************************************
  *
- * Multiply two multi-word integers.
+ * Multiply two multi-word integers.  The result is truncated to n words.
+ * Short operands use the Comba multiply, which only forms the low n
+ * columns.  Longer ones split each operand at h = ceil(n/2) words so that
+ * only the low half product needs to be formed in full (by Karatsuba); the
+ * two cross products only matter in their low n-h words and are formed by
+ * truncated multiplies.  The split only pays once the half product is
+ * itself long enough for Karatsuba.
  *
  * Parameters:
  *      x		Product return
@@ -529,87 +577,379 @@ int multint_mod(unsigned *x,unsigned *a,unsigned *b,int l)
  *      n		Number of array elements
  *
  *****************************************************************************/
-void multint_mul(unsigned *x,unsigned *a,unsigned *b,int n)
+void multint_mul(ssword_t *x,ssword_t *a,ssword_t *b,int n)
 {
-  int i,j,k;
+  ssword_t *t;
+  int h,l;
 
-  for (i = 0;i < n;i++)
-    x[i] = 0;
+  /*
+   * The product is built in place, so the result must be separate from
+   * the operands.
+   */
+  if (x == a || x == b) {
+    t = (ssword_t*)alloca(sizeof(ssword_t)*n);
+    multint_mul(t,a,b,n);
+    multint_copy(x,t,n);
+    return;
+  }
 
-  for (i = 0;i < n;i++) {
-    for (j = 0;j < n;j++) {
-      unsigned pp[2];
-      unsigned carry;
-      unsigned Ah,Al,Bh,Bl,P1,P2,P3;
+  if (n < 2*MULTINT_KARATSUBA) {
+    multint_comba(x,a,b,n,n);
+    return;
+  }
 
-      if (i+j >= n) continue;
+  h = (n+1)/2;
+  l = n-h;
 
-      /*
-       * If either of the words is zero, then the partial product will be
-       * zero and there is no sense wasting our time on it.
-       */
-      if (a[i] == 0 || b[j] == 0) continue;
+  t = (ssword_t*)alloca(sizeof(ssword_t)*2*h);
+  multint_karatsuba(t,a,b,h);
+  multint_copy(x,t,n);
 
-      /*
-       * Use regular multiply to get low part of partial product
-       */
-      pp[0] = a[i]*b[j];
+  multint_mul(t,a,b+h,l);
+  multint_addto(x+h,t,l);
+  multint_mul(t,a+h,b,l);
+  multint_addto(x+h,t,l);
+}
 
 
-      /*
-       * Split words into high and low halves.
-       */
-      Ah = (a[i] >> (SSWORDSIZE/2)) & SSHALFWORDMASK;
-      Al =  a[i] & SSHALFWORDMASK;
-      Bh = (b[j] >> (SSWORDSIZE/2)) & SSHALFWORDMASK;
-      Bl =  b[j] & SSHALFWORDMASK;
+/*****************************************************************************
+ *
+ * Decimal conversion works on chunks of MULTINT_DECDIGITS digits, the most
+ * that fit in a single word.  Long values are split by the powers
+ * MULTINT_DECBASE^(2^k), which are built once and kept along with the
+ * reciprocal used to divide by them.
+ *
+ *****************************************************************************/
+#if SSWORDSIZE == 64
+#define MULTINT_DECDIGITS	19
+#define MULTINT_DECBASE		10000000000000000000ULL
+#else
+#define MULTINT_DECDIGITS	9
+#define MULTINT_DECBASE		1000000000U
+#endif
+
+typedef struct {
+  ssword_t	*p;		/* MULTINT_DECBASE^(2^k) */
+  ssword_t	*inv;		/* floor(B^2n/p) where B = 2^SSWORDSIZE (n+2 words) */
+  int		n;		/* Number of words in p */
+} DecPower;
+
+static DecPower decPowers[32];
+static int numDecPowers = 0;
 
-      P1 = Ah*Bl;
-      P2 = Al*Bh;
-      P3 = Al*Bl >> (SSWORDSIZE/2);
+/*****************************************************************************
+ *
+ * Get the power MULTINT_DECBASE^(2^k), building any missing powers up to it.
+ *
+ * Parameters:
+ *      k		Log2 of the number of decimal chunks in the power.
+ *
+ *****************************************************************************/
+static DecPower *multint_decpower(int k)
+{
+  while (numDecPowers <= k) {
+    DecPower *P = &decPowers[numDecPowers];
+    ssword_t *u;
+    int n;
+
+    if (numDecPowers == 0) {
+      P->p = (ssword_t*) malloc(sizeof(ssword_t));
+      P->p[0] = MULTINT_DECBASE;
+      P->n = 1;
+    } else {
+      DecPower *H = P-1;
+
+      P->p = (ssword_t*) malloc(sizeof(ssword_t)*2*H->n);
+      multint_karatsuba(P->p,H->p,H->p,H->n);
+      P->n = multint_len(P->p,2*H->n);
+    }
 
-      carry = 0;
-      pp[1] = P1;
-      if (pp[1] + P2 < pp[1]) carry++;
-      pp[1] += P2;
-      if (pp[1] + P3 < pp[1]) carry++;
-      pp[1] += P3;
-
-      pp[1] = (pp[1] >> (SSWORDSIZE/2)) + carry;
-      pp[1] += Ah*Bh;
-
-      k = i+j;
-      pp[1] += ((x[k] + pp[0]) < x[k]);
-      x[k] += pp[0];
-
-      k++;
-      if (k < n) {
-	carry = ((x[k] + pp[1]) < x[k]);
-	x[k] += pp[1];
-      }
+    n = P->n;
+    u = (ssword_t*) calloc(2*n+1,sizeof(ssword_t));
+    u[2*n] = 1;
+    P->inv = (ssword_t*) malloc(sizeof(ssword_t)*(n+2));
+    divmnu(P->inv,0,u,P->p,2*n+1,n);
+    free(u);
+
+    numDecPowers++;
+  }
+
+  return &decPowers[k];
+}
+
+/*****************************************************************************
+ *
+ * Compare two multi-word integers of the same length.
+ *
+ *****************************************************************************/
+static int multint_cmp(const ssword_t *a,const ssword_t *b,int n)
+{
+  int i;
+
+  for (i = n-1;i >= 0;i--)
+    if (a[i] != b[i])
+      return (a[i] < b[i]) ? -1 : 1;
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Divide by a cached power p of n words using Barrett reduction, so that
+ * the division costs two multiplies.  The dividend must be less than p^2.
+ *
+ * Parameters:
+ *      q		Quotient return (n words)
+ *      r		Remainder return (n words)
+ *      x		Dividend
+ *      m		Number of words in x (at most 2n)
+ *      P		Power to divide by
+ *
+ *****************************************************************************/
+static void multint_decdivide(ssword_t *q,ssword_t *r,const ssword_t *x,int m,DecPower *P)
+{
+  int n = P->n;
+  ssword_t *q1 = (ssword_t*)alloca(sizeof(ssword_t)*(n+1));
+  ssword_t *q2 = (ssword_t*)alloca(sizeof(ssword_t)*2*(n+1));
+  ssword_t *p = (ssword_t*)alloca(sizeof(ssword_t)*(n+1));
+  ssword_t *t = (ssword_t*)alloca(sizeof(ssword_t)*(n+1));
+  ssword_t *u = (ssword_t*)alloca(sizeof(ssword_t)*(n+1));
+  ssword_t *q3 = q2+n+1;
+  int i;
+
+  /*
+   * Estimate the quotient as ((x >> (n-1) words) * inv) >> (n+1) words,
+   * which is at most two below the true quotient.
+   */
+  for (i = 0;i <= n;i++)
+    q1[i] = (i+n-1 < m) ? x[i+n-1] : 0;
+  multint_karatsuba(q2,q1,P->inv,n+1);
+
+  /*
+   * Only the low n+1 words of the remainder are needed.
+   */
+  multint_copy(p,P->p,n);
+  p[n] = 0;
+  for (i = 0;i <= n;i++)
+    u[i] = (i < m) ? x[i] : 0;
+  multint_mul(t,q3,p,n+1);
+  multint_subfrom(u,t,n+1);
+
+  while (multint_cmp(u,p,n+1) >= 0) {
+    multint_subfrom(u,p,n+1);
+    multint_carry(q3,1,n+1);
+  }
+
+  multint_copy(q,q3,n);
+  multint_copy(r,u,n);
+}
+
+/*****************************************************************************
+ *
+ * Divide multi-word int by MULTINT_DECBASE and return the remainder.
+ *
+ *****************************************************************************/
+static ssword_t multint_divbase(ssword_t *x,int n)
+{
+  ssdword_t r = 0;
+  int i;
+
+  for (i = n-1;i >= 0;i--) {
+    r = (r << SSWORDSIZE) | x[i];
+    x[i] = (ssword_t)(r / MULTINT_DECBASE);
+    r -= (ssdword_t)x[i]*MULTINT_DECBASE;
+  }
+
+  return (ssword_t)r;
+}
+
+/*****************************************************************************
+ *
+ * Multiply multi-word int by a word and add a word.
+ *
+ *****************************************************************************/
+static void multint_muladd(ssword_t *x,int n,ssword_t m,ssword_t d)
+{
+  ssdword_t p;
+  ssword_t carry = d;
+  int i;
+
+  for (i = 0;i < n;i++) {
+    p = (ssdword_t)x[i]*m + carry;
+    x[i] = (ssword_t)p;
+    carry = (ssword_t)(p >> SSWORDSIZE);
+  }
+}
+
+/*****************************************************************************
+ *
+ * Write exactly MULTINT_DECDIGITS*2^k decimal digits of a multi-word int,
+ * with leading zeros.  Above MULTINT_DECSPLIT chunks the value is divided
+ * by the power for half the digits and each half is written on its own.
+ *
+ * Parameters:
+ *      x		Integer to convert, less than MULTINT_DECBASE^(2^k)
+ *      n		Number of words in x
+ *      k		Log2 of the number of chunks to write
+ *      buf		Buffer to write digits to
+ *
+ *****************************************************************************/
+static void multint_decput(const ssword_t *x,int n,int k,char *buf)
+{
+  DecPower *P;
+  ssword_t *q,*r;
+  int i,j,m;
+
+  n = multint_len((ssword_t*)x,n);
+
+  if ((1 << k) <= MULTINT_DECSPLIT) {
+    ssword_t *t = (ssword_t*)alloca(sizeof(ssword_t)*(n+1));
+
+    multint_copy(t,(ssword_t*)x,n);
+    for (i = (1 << k)-1;i >= 0;i--) {
+      ssword_t d = multint_divbase(t,n);
 
-      for (k++;k < n;k++) {
-	x[k] += carry;
-	if (x[k] != 0) break;
+      for (j = MULTINT_DECDIGITS-1;j >= 0;j--) {
+	buf[i*MULTINT_DECDIGITS+j] = '0' + d % 10;
+	d /= 10;
       }
+      n = multint_len(t,n);
     }
+    return;
   }
+
+  P = multint_decpower(k-1);
+  m = P->n;
+  q = (ssword_t*)alloca(sizeof(ssword_t)*m);
+  r = (ssword_t*)alloca(sizeof(ssword_t)*m);
+
+  multint_decdivide(q,r,x,n,P);
+  multint_decput(q,m,k-1,buf);
+  multint_decput(r,m,k-1,buf+(MULTINT_DECDIGITS << (k-1)));
 }
 
 /*****************************************************************************
  *
- * Convert stream of decimal digits into an integer
+ * Convert multi-word int to string
+ *
+ * Parameters:
+ *      x		Array of integers with word parts
+ *      n		Number  of elements in array
+ *      buf		Buffer to write string to
+ *      len		Size of string buffer
  *
  *****************************************************************************/
-int multint_cvtstr(unsigned *x,int n,const char *p)
+int multint_getstr(ssword_t *x,int n,char *buf,int len)
 {
-  multint_makezero(x,n);
+  DecPower *P;
+  char *s,*p;
+  int k;
 
-  for (;*p;p++) {
-    if (!isdigit(*p)) return -1;
-    multint_mul10(x,n);
-    x[0] += *p - '0';
+  n = multint_len(x,n);
+  if (n == 0) {
+    sprintf(buf,"0");
+    return 0;
+  }
+
+  /*
+   * Write digits for the smallest power above x and strip the leading zeros.
+   */
+  for (k = 0;;k++) {
+    P = multint_decpower(k);
+    if (P->n > n || (P->n == n && multint_cmp(x,P->p,n) < 0))
+      break;
   }
 
+  s = (char*) malloc((MULTINT_DECDIGITS << k)+1);
+  multint_decput(x,n,k,s);
+  s[MULTINT_DECDIGITS << k] = 0;
+  for (p = s;*p == '0';p++);
+
+  if ((int)strlen(p) >= len) {		/* Not enough space */
+    *buf = 0;
+    free(s);
+    return -1;
+  }
+
+  strcpy(buf,p);
+  free(s);
+
   return 0;
 }
+
+/*****************************************************************************
+ *
+ * Read l decimal digits into a multi-word int, keeping the low n words.
+ * Above MULTINT_DECSPLIT chunks the digits are split so that the low part
+ * is a power of MULTINT_DECBASE digits, and the two parts are combined
+ * with one multiply.
+ *
+ * Parameters:
+ *      x		Integer return
+ *      n		Number of words in x
+ *      p		Decimal digits
+ *      l		Number of digits
+ *
+ *****************************************************************************/
+static void multint_decget(ssword_t *x,int n,const char *p,int l)
+{
+  DecPower *P;
+  ssword_t *hi,*lo,*t;
+  int i,k,hn,ln,c;
+
+  if (l <= MULTINT_DECDIGITS*MULTINT_DECSPLIT) {
+    multint_makezero(x,n);
+
+    c = l % MULTINT_DECDIGITS;
+    if (c == 0) c = MULTINT_DECDIGITS;
+    while (l > 0) {
+      ssword_t d = 0,m = 1;
+
+      for (i = 0;i < c;i++) {
+	d = d*10 + (p[i] - '0');
+	m *= 10;
+      }
+      multint_muladd(x,n,m,d);
+      p += c;
+      l -= c;
+      c = MULTINT_DECDIGITS;
+    }
+    return;
+  }
+
+  for (k = 0;(MULTINT_DECDIGITS << (k+1)) < l;k++);
+  P = multint_decpower(k);
+  c = MULTINT_DECDIGITS << k;
+
+  hn = (int)((l-c)*3.32192809488736234791/SSWORDSIZE)+1;
+  if (hn > n) hn = n;
+  ln = (P->n < n) ? P->n : n;
+
+  hi = (ssword_t*)alloca(sizeof(ssword_t)*n);
+  lo = (ssword_t*)alloca(sizeof(ssword_t)*ln);
+  t = (ssword_t*)alloca(sizeof(ssword_t)*n);
+
+  multint_decget(hi,hn,p,l-c);
+  multint_makezero(hi+hn,n-hn);
+  multint_decget(lo,ln,p+l-c,c);
+
+  multint_copy(t,P->p,ln);
+  multint_makezero(t+ln,n-ln);
+  multint_mul(x,hi,t,n);
+  multint_carry(x+ln,multint_addto(x,lo,ln),n-ln);
+}
+
+/*****************************************************************************
+ *
+ * Convert stream of decimal digits into an integer
+ *
+ *****************************************************************************/
+int multint_cvtstr(ssword_t *x,int n,const char *p)
+{
+  int l = strspn(p,"0123456789");
+  int w = (int)(l*3.32192809488736234791/SSWORDSIZE)+1;
+
+  multint_makezero(x,n);
+  multint_decget(x,(w < n) ? w : n,p,l);
+
+  return p[l] ? -1 : 0;
+}
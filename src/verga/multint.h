@@ -20,12 +20,12 @@
 #ifndef __multint_h
 #define __multint_h
 
-int multint_cvtstr(unsigned *x,int n,const char *buf);
-int multint_getstr(unsigned *x,int n,char *buf,int len);
-unsigned multint_div10(unsigned *x,int n);
-int multint_iszero(unsigned *x,int n);
-void multint_mul(unsigned *x,unsigned *a,unsigned *b,int n);
-int multint_div(unsigned *x,unsigned *a,unsigned *b,int n);
-int multint_mod(unsigned *x,unsigned *a,unsigned *b,int n);
+int multint_cvtstr(ssword_t *x,int n,const char *buf);
+int multint_getstr(ssword_t *x,int n,char *buf,int len);
+unsigned multint_div10(ssword_t *x,int n);
+int multint_iszero(ssword_t *x,int n);
+void multint_mul(ssword_t *x,ssword_t *a,ssword_t *b,int n);
+int multint_div(ssword_t *x,ssword_t *a,ssword_t *b,int n);
+int multint_mod(ssword_t *x,ssword_t *a,ssword_t *b,int n);
 
 #endif
@@ -23,6 +23,117 @@
 
 #define NET_DEBUG 0
 
+/*****************************************************************************
+ *
+ * Allocate the changed-bit mask of a net
+ *
+ * Parameters:
+ *     n		Net
+ *
+ * Nets of up to one word keep the mask in the net itself.
+ *
+ *****************************************************************************/
+static void Net_initChanged(Net *n)
+{
+  int wc = SSNUMWORDS(n->n_nbits);
+
+  n->n_changedWord = 0;
+  if (wc <= 1)
+    n->n_changed = &n->n_changedWord;
+  else
+    n->n_changed = (ssword_t*) calloc(wc,sizeof(ssword_t));
+}
+
+/*****************************************************************************
+ *
+ * Mark every bit of a net as changed
+ *
+ * Parameters:
+ *     n		Net
+ *
+ * Used by updates that do not compute which bits they changed.
+ *
+ *****************************************************************************/
+static void Net_changedAll(Net *n)
+{
+  int wc = SSNUMWORDS(n->n_nbits);
+  int i;
+
+  n->n_changed[0] = SSWORDMASK;
+  for (i = 1;i < wc;i++)
+    n->n_changed[i] = SSWORDMASK;
+}
+
+/*****************************************************************************
+ *
+ * Make a fanout array from a list of listeners
+ *
+ * Parameters:
+ *     l		List of listeners
+ *
+ * Returns:		Null terminated array of the listeners in l.
+ *
+ * Listeners that are in l more than once are in the array only once, in
+ * the place of the first of them.
+ *
+ *****************************************************************************/
+static void **Net_makeFanout(List *l)
+{
+  int n = List_numElems(l);
+  ListElem *le;
+  void **a;
+  int i = 0;
+
+  a = (void**) malloc((n+1)*sizeof(void*));
+  if (n == 1) {
+    a[i++] = ListElem_obj(List_first(l));
+  } else if (n > 1) {
+    PHash seen;
+
+    PHash_init(&seen);
+    for (le = List_first(l);le;le = List_next(l,le)) {
+      void *x = ListElem_obj(le);
+
+      if (PHash_find(&seen,x)) continue;
+      PHash_insert(&seen,x,x);
+      a[i++] = x;
+    }
+    PHash_uninit(&seen);
+  }
+  a[i] = 0;
+
+  return a;
+}
+
+/*****************************************************************************
+ *
+ * Add a listener to a fanout array
+ *
+ * Parameters:
+ *     a		Null terminated array
+ *     x		Listener to add
+ *
+ * Returns:		Array with x at the end, or a if x is already in it.
+ *
+ * Used for listeners added after the circuit starts running, which are
+ * few enough that the array is simply searched and grown by one.
+ *
+ *****************************************************************************/
+static void **Net_addFanout(void **a,void *x)
+{
+  int n;
+
+  for (n = 0;a[n];n++)
+    if (a[n] == x)
+      return a;
+
+  a = (void**) realloc(a,(n+2)*sizeof(void*));
+  a[n] = x;
+  a[n+1] = 0;
+
+  return a;
+}
+
 Net::Net(const char *name, unsigned msb, unsigned lsb,
     unsigned beginAddr, unsigned endAddr)
 {
@@ -31,13 +142,26 @@ Net::Net(const char *name, unsigned msb, unsigned lsb,
 	this->n_lsb = lsb;
 	this->n_nbits = iabs(msb-lsb) + 1;
 	this->n_drivers = 0;
+	this->n_driverEvents = 0;
+	this->n_numEvents = 0;
 	this->n_type = NT_MEMORY;
 	this->n_flags = NA_NONE;
 	this->n_numDrivers = 0;
 	this->n_numMonitors = 0;
-	this->n_wfunc = Value_wire;
+	this->n_wresolve = Value_wireResolve;
+	this->n_wstrong = SYM_NUL1;
+	this->n_countBits = 0;
+	this->n_driverCount = 0;
+	this->n_resolved = 0;
+	this->n_charged = 0;
 	List_init(&this->n_posedgeNotify);
 	List_init(&this->n_negedgeNotify);
+	this->n_slices = 0;
+	List_init(&this->n_sliceNotify);
+	this->n_posedgeFanout = 0;
+	this->n_negedgeFanout = 0;
+	this->n_sliceFanout = 0;
+	Net_initChanged(this);
 
 	Memory_init(&this->n_data.memory, beginAddr, endAddr, this->n_nbits,
 	    this);
@@ -64,24 +188,39 @@ Net::Net(const char* name, nettype_t ntype, unsigned msb, unsigned lsb)
 	this->n_lsb = lsb;
 	this->n_nbits = iabs(msb-lsb) + 1;
 	this->n_drivers = 0;
+	this->n_driverEvents = 0;
+	this->n_numEvents = 0;
 	this->n_type = ntype;
 	this->n_flags = NA_NONE;
 	this->n_numMonitors = 0;
 	this->n_numDrivers = 0;
 	List_init(&this->n_posedgeNotify);
 	List_init(&this->n_negedgeNotify);
+	this->n_slices = 0;
+	List_init(&this->n_sliceNotify);
+	this->n_posedgeFanout = 0;
+	this->n_negedgeFanout = 0;
+	this->n_sliceFanout = 0;
+	Net_initChanged(this);
 	Value_init(Net_getValue(this), this->n_nbits);
 
-	if ((this->n_type & NT_P_AND))
-		this->n_wfunc = Value_wand;
-	else if ((this->n_type & NT_P_OR))
-		this->n_wfunc = Value_wor;
-	else if ((this->n_type & NT_P_PULL0))
-		this->n_wfunc = Value_tri0;
+	this->n_wstrong = SYM_NUL1;
+	this->n_countBits = 0;
+	this->n_driverCount = 0;
+	this->n_resolved = 0;
+	this->n_charged = 0;
+	if ((this->n_type & NT_P_AND)) {
+		this->n_wresolve = Value_wandResolve;
+		this->n_wstrong = SYM_ZERO;
+	} else if ((this->n_type & NT_P_OR)) {
+		this->n_wresolve = Value_worResolve;
+		this->n_wstrong = SYM_ONE;
+	} else if ((this->n_type & NT_P_PULL0))
+		this->n_wresolve = Value_tri0Resolve;
 	else if ((this->n_type & NT_P_PULL1))
-		this->n_wfunc = Value_tri1;
+		this->n_wresolve = Value_tri1Resolve;
 	else
-		this->n_wfunc = Value_wire;
+		this->n_wresolve = Value_wireResolve;
 
 	switch ((this->n_type & NT_P_REGTYPE_MASK)) {
 	case NT_P_REAL :
@@ -107,11 +246,32 @@ Net::Net(const char* name, nettype_t ntype, unsigned msb, unsigned lsb)
 	}
 
 	value->permFlags = (ValueFlags)(SF_NETVAL | value->flags);
+	if ((ntype & NT_P_PARAMETER))
+		value->permFlags = (ValueFlags)(value->permFlags | SF_PARAM);
 }
 
 Net::~Net()
 {
 	Value_uninit(Net_getValue(this));
+	if (this->n_changed != &this->n_changedWord)
+		std::free(this->n_changed);
+	std::free(this->n_driverCount);
+	if (this->n_resolved)
+		delete_Value(this->n_resolved);
+	if (this->n_charged)
+		delete_Value(this->n_charged);
+	while (this->n_slices) {
+		NetSlice *ns = this->n_slices;
+
+		this->n_slices = ns->ns_next;
+		List_uninit(&ns->ns_notify);
+		std::free(ns->ns_fanout);
+		std::free(ns);
+	}
+	List_uninit(&this->n_sliceNotify);
+	std::free(this->n_posedgeFanout);
+	std::free(this->n_negedgeFanout);
+	std::free(this->n_sliceFanout);
 	std::free(this->n_name);
 }
 
@@ -147,6 +307,8 @@ Net_getLocalName(Net *n)
 void Net_posedgeListen(Net*n,Trigger*t)
 {
   List_addToTail(&n->n_posedgeNotify,t);
+  if (n->n_posedgeFanout)
+    n->n_posedgeFanout = (Trigger**) Net_addFanout((void**)n->n_posedgeFanout,t);
 }
 
 /*****************************************************************************
@@ -161,6 +323,153 @@ void Net_posedgeListen(Net*n,Trigger*t)
 void Net_negedgeListen(Net*n,Trigger*t)
 {
   List_addToTail(&n->n_negedgeNotify,t);
+  if (n->n_negedgeFanout)
+    n->n_negedgeFanout = (Trigger**) Net_addFanout((void**)n->n_negedgeFanout,t);
+}
+
+/*****************************************************************************
+ *
+ * Get the slice of a net for a range of bits
+ *
+ * Parameters
+ *     n		Net
+ *     msb		Highest bit of the slice
+ *     lsb		Lowest bit of the slice
+ *
+ * Returns:		Slice for the range, shared with any other readers of
+ *			the same range.
+ *
+ *****************************************************************************/
+NetSlice *Net_getSlice(Net *n,int msb,int lsb)
+{
+  NetSlice *ns;
+
+  for (ns = n->n_slices;ns;ns = ns->ns_next)
+    if (ns->ns_msb == msb && ns->ns_lsb == lsb)
+      return ns;
+
+  ns = (NetSlice*) malloc(sizeof(NetSlice));
+  ns->ns_net = n;
+  ns->ns_msb = msb;
+  ns->ns_lsb = lsb;
+  List_init(&ns->ns_notify);
+  ns->ns_fanout = 0;
+  ns->ns_next = n->n_slices;
+  n->n_slices = ns;
+
+  return ns;
+}
+
+/*****************************************************************************
+ *
+ * Register a trigger as being a listener of a slice of a net
+ *
+ * Parameters
+ *     s		Slice on which to look for changes
+ *     t		Trigger to be registered.
+ *
+ *****************************************************************************/
+void NetSlice_listen(NetSlice *s,Trigger *t)
+{
+  Net *n = s->ns_net;
+
+  if (List_numElems(&s->ns_notify) == 0) {
+    List_addToTail(&n->n_sliceNotify,s);
+    if (n->n_sliceFanout) {
+      n->n_sliceFanout = (NetSlice**) Net_addFanout((void**)n->n_sliceFanout,s);
+      s->ns_fanout = (Trigger**) Net_makeFanout(&s->ns_notify);
+    }
+  }
+  List_addToTail(&s->ns_notify,t);
+  if (s->ns_fanout)
+    s->ns_fanout = (Trigger**) Net_addFanout((void**)s->ns_fanout,t);
+}
+
+/*****************************************************************************
+ *
+ * Freeze the fanout of a net into arrays
+ *
+ * Parameters:
+ *     n		Net
+ *
+ * This is called once for each net when the circuit starts running.  From
+ * then on the listeners of the net are notified from the arrays, and any
+ * listener added later is added to both the list and the array.
+ *
+ *****************************************************************************/
+void Net_freezeFanout(Net *n)
+{
+  NetSlice **sp;
+
+  n->n_posedgeFanout = (Trigger**) Net_makeFanout(&n->n_posedgeNotify);
+  n->n_negedgeFanout = (Trigger**) Net_makeFanout(&n->n_negedgeNotify);
+  n->n_sliceFanout = (NetSlice**) Net_makeFanout(&n->n_sliceNotify);
+  for (sp = n->n_sliceFanout;*sp;sp++)
+    (*sp)->ns_fanout = (Trigger**) Net_makeFanout(&(*sp)->ns_notify);
+}
+
+/*****************************************************************************
+ *
+ * Test the last update of a net for changes in a slice
+ *
+ * Parameters
+ *     n		Net that was updated
+ *     s		Slice of n
+ *
+ * Returns:		Non-zero if any bit of the slice is set in n_changed.
+ *
+ *****************************************************************************/
+static int Net_sliceChanged(Net *n,NetSlice *s)
+{
+  int lw = s->ns_lsb >> SSWORDSHIFT;
+  int hw = s->ns_msb >> SSWORDSHIFT;
+  ssword_t lmask = HMASKZ(s->ns_lsb & SSBITMASK);
+  ssword_t hmask = LMASK((s->ns_msb & SSBITMASK)+1);
+  int w;
+
+  if (lw == hw)
+    return (n->n_changed[lw] & lmask & hmask) != 0;
+
+  if ((n->n_changed[lw] & lmask) || (n->n_changed[hw] & hmask))
+    return 1;
+  for (w = lw+1;w < hw;w++)
+    if (n->n_changed[w])
+      return 1;
+
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Notify the listeners of a net before its fanout is frozen
+ *
+ * Parameters
+ *     n		Net that changed
+ *     l		List of edge listeners to notify
+ *     slices		Non-zero to also notify the listeners of changed slices
+ *
+ * Nets can change while the circuit is being built (e.g., by initializers
+ * of regs), before Circuit::run() makes the fanout arrays.
+ *
+ *****************************************************************************/
+static void Net_listNotify(Net *n,List *l,int slices)
+{
+  ListElem *le;
+
+  for (le = List_first(l);le;le = List_next(l,le))
+    Trigger_fire((Trigger*)ListElem_obj(le));
+
+  if (!slices) return;
+
+  for (le = List_first(&n->n_sliceNotify);le;le = List_next(&n->n_sliceNotify,le)) {
+    NetSlice *ns = (NetSlice*)ListElem_obj(le);
+    ListElem *tle;
+
+    if (!Net_sliceChanged(n,ns)) continue;
+
+    for (tle = List_first(&ns->ns_notify);tle;tle = List_next(&ns->ns_notify,tle))
+      Trigger_fire((Trigger*)ListElem_obj(tle));
+  }
 }
 
 /*****************************************************************************
@@ -173,13 +482,31 @@ void Net_negedgeListen(Net*n,Trigger*t)
  *****************************************************************************/
 void Net_posedgeNotify(Net *n)
 {
-  ListElem *le;
+  Trigger **tp;
+  NetSlice **sp;
 
   if ((n->n_flags & NA_CLOCK))
     EvQueue_clockNotify(Circuit_getQueue(&vgsim.circuit()), n, TT_POSEDGE);
 
-  for (le = List_first(&n->n_posedgeNotify);le;le = List_next(&n->n_posedgeNotify,le)) {
-    Trigger_fire((Trigger*)ListElem_obj(le));
+  if (!n->n_posedgeFanout) {
+    Net_listNotify(n,&n->n_posedgeNotify,1);
+    return;
+  }
+
+  for (tp = n->n_posedgeFanout;*tp;tp++)
+    Trigger_fire(*tp);
+
+  /*
+   * Triggers on slices of the net are fired only if a bit in the slice
+   * changed.
+   */
+  for (sp = n->n_sliceFanout;*sp;sp++) {
+    NetSlice *ns = *sp;
+
+    if (!Net_sliceChanged(n,ns)) continue;
+
+    for (tp = ns->ns_fanout;*tp;tp++)
+      Trigger_fire(*tp);
   }
 }
 
@@ -193,14 +520,18 @@ void Net_posedgeNotify(Net *n)
  *****************************************************************************/
 void Net_negedgeNotify(Net *n)
 {
-  ListElem *le;
+  Trigger **tp;
 
   if ((n->n_flags & NA_CLOCK))
     EvQueue_clockNotify(Circuit_getQueue(&vgsim.circuit()), n, TT_NEGEDGE);
 
-  for (le = List_first(&n->n_negedgeNotify);le;le = List_next(&n->n_negedgeNotify,le)) {
-    Trigger_fire((Trigger*)ListElem_obj(le));
+  if (!n->n_negedgeFanout) {
+    Net_listNotify(n,&n->n_negedgeNotify,0);
+    return;
   }
+
+  for (tp = n->n_negedgeFanout;*tp;tp++)
+    Trigger_fire(*tp);
 }
 
 /*****************************************************************************
@@ -213,16 +544,19 @@ void Net_negedgeNotify(Net *n)
  *
  * Determines the transition edge type based on the current and new values for
  * the net and sets the new value.  If the new value is the same as the current
- * value, nothing is done.  Otherwise, the EDGE, POSEDGE or NEGEDGE listeners
- * as appropriate are notified.
+ * value, nothing is done.  Otherwise, the bits that changed are left in
+ * n_changed and the EDGE, POSEDGE or NEGEDGE listeners as appropriate are
+ * notified.
  *
  *****************************************************************************/
 void Net_set(Net*n,Value*s)
 {
   EvQueue *Q;
   Value *temp_s = 0;
+  int known;
 
   if (!s) {
+    Net_changedAll(n);
     Net_posedgeNotify(n);
     return;
   }
@@ -247,6 +581,7 @@ void Net_set(Net*n,Value*s)
     else
       Value_convertR(Net_getValue(n), src);
 
+    Net_changedAll(n);
     Net_posedgeNotify(n);
     return;
   }
@@ -264,7 +599,10 @@ void Net_set(Net*n,Value*s)
     Value_convertI(s, v_u);
   }
 
-  switch (Value_transitionType(Net_getValue(n), s)) {
+  /*
+   * The new value is compared and stored in one pass.
+   */
+  switch (Value_update(Net_getValue(n), s, n->n_changed)) {
   case TT_NONE :
     break;
   case TT_EDGE :
@@ -273,7 +611,6 @@ void Net_set(Net*n,Value*s)
       Q = Circuit_getQueue(&vgsim.circuit());
       EvQueue_monitoredChangeNotify(Q);
     }
-    Value_copy(Net_getValue(n), s);
     Net_posedgeNotify(n);
     break;
   case TT_NEGEDGE :
@@ -281,18 +618,21 @@ void Net_set(Net*n,Value*s)
       Q = Circuit_getQueue(&vgsim.circuit());
       EvQueue_monitoredChangeNotify(Q);
     }
-    Value_copy(Net_getValue(n), s);
     Net_negedgeNotify(n);
     break;
   }
 
+  /*
+   * Reset the display format, but keep the known flag from the copy.
+   */
+  known = Net_getValue(n)->flags & SF_KNOWN;
   switch ((n->n_type & NT_P_REGTYPE_MASK)) {
   case  NT_P_INTEGER :
   case  NT_P_TIME :
-    Net_getValue(n)->flags = SF_INT;
+    Net_getValue(n)->flags = (ValueFlags)(SF_INT|known);
     break;
   default :
-    Net_getValue(n)->flags = SF_NONE;
+    Net_getValue(n)->flags = (ValueFlags)(SF_NONE|known);
     break;
   }
 
@@ -326,7 +666,7 @@ void Net_setRange(Net*n,int nlsb,Value*s,int smsb,int slsb)
 
   if ((n->n_flags & NA_FIXED)) return;
 
-  switch (Value_copyRange(Net_getValue(n), nlsb, s, smsb, slsb)) {
+  switch (Value_updateRange(Net_getValue(n), nlsb, s, smsb, slsb, n->n_changed)) {
   case TT_EDGE :
   case TT_POSEDGE :
     if (n->n_numMonitors > 0) {
@@ -358,6 +698,7 @@ void Net_setRange(Net*n,int nlsb,Value*s,int smsb,int slsb)
 void Net_makeUnknown(Net *n)
 {
   Value_unknown(Net_getValue(n));
+  Net_changedAll(n);
   Net_posedgeNotify(n);
 }
 
@@ -398,108 +739,238 @@ Net_addDriver(Net *n)
 {
 	int id = n->n_numDrivers++;
 
-	if (id == 0)
+	if (id == 0) {
 		n->n_drivers = (Value**) malloc(sizeof(Value*)*n->n_numDrivers);
-	else
+		n->n_driverEvents = (Event**) malloc(sizeof(Event*)*n->n_numDrivers);
+	} else {
 		n->n_drivers = (Value**) realloc(n->n_drivers, sizeof(Value*)*n->n_numDrivers);
+		n->n_driverEvents = (Event**) realloc(n->n_driverEvents, sizeof(Event*)*n->n_numDrivers);
+	}
 
 	n->n_drivers[id] = new_Value(Net_nbits(n));
 	Value_float(n->n_drivers[id]);
+	n->n_driverEvents[id] = 0;
+
+	/*
+	 * The driver counts are rebuilt with the new driver on the next change.
+	 */
+	std::free(n->n_driverCount);
+	n->n_driverCount = 0;
+	n->n_countBits = 0;
 
 	return (id);
 }
 
+/*
+ * Driver states counted for each bit of a net.
+ */
+#define NC_ONE		0	/* Drivers with their one bit set */
+#define NC_ZERO		1	/* Drivers with their zero bit set */
+#define NC_DRIVEN	2	/* Drivers that are not floating */
+#define NC_STRONG	3	/* Drivers at the overriding value (wand/wor) */
+#define NC_NUM		4
+
 /*****************************************************************************
  *
- *  Notify net that driver with id 'id' has changed.
+ * Add or remove drivers from a bit-sliced count
  *
- *  Parameters:
- *       n		Net on which a driver change has occured
- *       id		ID of driver thange changed (currently unused)
+ * Parameters:
+ *     c		Bit 0 of the counts for a word
+ *     bits		Bits in each count
+ *     wc		Words between bits of a count
+ *     m		Bits whose count changes
+ *
+ * The carry or borrow is rippled up through the counts of all of the bits
+ * in m at once.
  *
  *****************************************************************************/
-void Net_driverChangeNotify(Net *n,int id)
+static inline void Net_countAdd(ssword_t *c,int bits,int wc,ssword_t m)
 {
-  Value *s, *floatValue;
-  int i;
+  int j;
 
-#if NET_DEBUG
-  printf("   Net_driverChange %s<%d> was ",n->n_name,n->n_numDrivers);
-  Value_print(Net_getValue(n),stdout);
-  printf("\n");
-#endif
+  for (j = 0;m && j < bits;j++, c += wc) {
+    ssword_t carry = *c & m;
 
-  switch (n->n_numDrivers) {
-  case 0 :
-    s = new_Value(Net_nbits(n));
-    Value_float(s);
-    if ((n->n_type & NT_P_TRIREG))
-      Value_trireg(s,s,&n->n_data.value);
-    Net_set(n,s);
-    delete_Value(s);
-    break;
-  case 1 :
-    s = n->n_drivers[0];
-    floatValue = new_Value(Net_nbits(n));
-    Value_float(floatValue);
-    (*n->n_wfunc)(s,s,floatValue);
-    delete_Value(floatValue);
-    if (n->n_type & NT_P_TRIREG)
-      Value_trireg(s,s,Net_getValue(n));
-    Net_set(n,s);
-    break;
-  case 2:
-    s = new_Value(Net_nbits(n));
-    (*n->n_wfunc)(s,n->n_drivers[0],n->n_drivers[1]);
-    if ((n->n_type & NT_P_TRIREG))
-      Value_trireg(s,s,Net_getValue(n));
-    Net_set(n,s);
-    delete_Value(s);
-    break;
+    *c ^= m;
+    m = carry;
+  }
+}
+
+static inline void Net_countSub(ssword_t *c,int bits,int wc,ssword_t m)
+{
+  int j;
+
+  for (j = 0;m && j < bits;j++, c += wc) {
+    ssword_t borrow = ~*c & m;
+
+    *c ^= m;
+    m = borrow;
+  }
+}
+
+/*
+ * Bits of a word whose count is not zero
+ */
+static inline ssword_t Net_countAny(ssword_t *c,int bits,int wc)
+{
+  ssword_t any = 0;
+  int j;
+
+  for (j = 0;j < bits;j++, c += wc)
+    any |= *c;
+
+  return any;
+}
+
+/*
+ * Bits of word w of driver D that are at the overriding value of the net
+ */
+static inline ssword_t Net_strongWord(Net *n,Value *D,int w)
+{
+  switch (n->n_wstrong) {
+  case SYM_ZERO :
+    return ~D->one[w] & D->zero[w] & ~D->flt[w];
+  case SYM_ONE :
+    return D->one[w] & ~D->zero[w] & ~D->flt[w];
   default :
-    s = new_Value(Net_nbits(n));
-    (*n->n_wfunc)(s,n->n_drivers[0],n->n_drivers[1]);
-    for (i = 2;i < n->n_numDrivers;i++)
-      (*n->n_wfunc)(s,s,n->n_drivers[i]);
-    if ((n->n_type & NT_P_TRIREG))
-      Value_trireg(s,s,&n->n_data.value);
-    Net_set(n,s);
-    delete_Value(s);
-    break;
+    return 0;
   }
 }
-#if 0
-#if NET_DEBUG|1
-    printf("   Net_driverChange %s<%d> (%s) was ",n->n_name,n->n_numDrivers,
-	   (n->n_type & NT_P_TRIREG) ? "trireg" : "non-trireg");
-    Value_print(Net_getValue(n),stdout);
-    printf("\n");
-#endif
 
-  if (n->n_numDrivers == 1) {
-    Value *s = n->n_drivers[0];
+/*****************************************************************************
+ *
+ * Set a word of the resolved value of a net from its driver counts
+ *
+ * Parameters:
+ *     n		Net
+ *     w		Word to resolve
+ *
+ *****************************************************************************/
+static void Net_resolveWord(Net *n,int w)
+{
+  int wc = SSNUMWORDS(n->n_nbits);
+  int bits = n->n_countBits;
+  ssword_t *c = n->n_driverCount + w;
+
+  (*n->n_wresolve)(n->n_resolved,w,
+		   Net_countAny(c + NC_ONE*bits*wc,bits,wc),
+		   Net_countAny(c + NC_ZERO*bits*wc,bits,wc),
+		   ~Net_countAny(c + NC_DRIVEN*bits*wc,bits,wc),
+		   Net_countAny(c + NC_STRONG*bits*wc,bits,wc));
+}
 
-    Net_set(n,s);
-  } else {
-    Value *s = new_Value(Net_nbits(n));
-    int i;
+/*****************************************************************************
+ *
+ * Build the driver counts of a net from its current drivers
+ *
+ * Parameters:
+ *     n		Net
+ *
+ *****************************************************************************/
+static void Net_buildDriverCount(Net *n)
+{
+  int wc = SSNUMWORDS(n->n_nbits);
+  int bits, i, w;
+
+  for (bits = 1;(n->n_numDrivers >> bits) != 0;bits++);
 
-    Value_float(s);
+  n->n_countBits = bits;
+  n->n_driverCount = (ssword_t*) calloc(NC_NUM*bits*wc,sizeof(ssword_t));
+  if (!n->n_resolved)
+    n->n_resolved = new_Value(n->n_nbits);
+  if ((n->n_type & NT_P_TRIREG) && !n->n_charged)
+    n->n_charged = new_Value(n->n_nbits);
 
-    for (i = 0;i < n->n_numDrivers;i++)
-      (*n->n_wfunc)(s,s,n->n_drivers[i]);
+  for (i = 0;i < n->n_numDrivers;i++) {
+    Value *D = n->n_drivers[i];
 
-    /*
-     * If this is a trireg net, merge driver result with the current net value.
-     */
-    if ((n->n_type & NT_P_TRIREG))
-      Value_trireg(s,s,&n->n_data.value);
+    for (w = 0;w < wc;w++) {
+      ssword_t *c = n->n_driverCount + w;
 
-    Net_set(n,s);
-    delete_Value(s);
+      Net_countAdd(c + NC_ONE*bits*wc,bits,wc,D->one[w]);
+      Net_countAdd(c + NC_ZERO*bits*wc,bits,wc,D->zero[w]);
+      Net_countAdd(c + NC_DRIVEN*bits*wc,bits,wc,~D->flt[w]);
+      Net_countAdd(c + NC_STRONG*bits*wc,bits,wc,Net_strongWord(n,D,w));
+    }
   }
+
+  for (w = 0;w < wc;w++)
+    Net_resolveWord(n,w);
+}
+
+/*****************************************************************************
+ *
+ *  Change a driver of a net and update the net.
+ *
+ *  Parameters:
+ *       n		Net on which a driver change has occured
+ *       id		ID of driver that changed
+ *       s		New value of the driver
+ *
+ *  Only the words in which the driver changed are counted and resolved
+ *  again, so that a change does not depend on the number of drivers.
+ *  Nothing is done if the driver does not change.
+ *
+ *****************************************************************************/
+void Net_setDriver(Net *n,int id,Value *s)
+{
+  Value *D = n->n_drivers[id];
+  Value *r;
+  int wc = SSNUMWORDS(n->n_nbits);
+  int bits, w;
+  int changed = 0;
+
+#if NET_DEBUG
+  printf("   Net_setDriver %s<%d> was ",n->n_name,id);
+  Value_print(Net_getValue(n),stdout);
+  printf("\n");
 #endif
 
+  if (!n->n_countBits)
+    Net_buildDriverCount(n);
+  bits = n->n_countBits;
+
+  for (w = 0;w < wc;w++) {
+    ssword_t *c = n->n_driverCount + w;
+    ssword_t d1 = D->one[w] ^ s->one[w];
+    ssword_t d0 = D->zero[w] ^ s->zero[w];
+    ssword_t dz = D->flt[w] ^ s->flt[w];
+    ssword_t os, ns;
+
+    if (!(d1 | d0 | dz)) continue;
+
+    Net_countSub(c + NC_ONE*bits*wc,bits,wc,d1 & D->one[w]);
+    Net_countAdd(c + NC_ONE*bits*wc,bits,wc,d1 & s->one[w]);
+    Net_countSub(c + NC_ZERO*bits*wc,bits,wc,d0 & D->zero[w]);
+    Net_countAdd(c + NC_ZERO*bits*wc,bits,wc,d0 & s->zero[w]);
+    Net_countSub(c + NC_DRIVEN*bits*wc,bits,wc,dz & s->flt[w]);
+    Net_countAdd(c + NC_DRIVEN*bits*wc,bits,wc,dz & D->flt[w]);
+
+    os = Net_strongWord(n,D,w);
+    ns = Net_strongWord(n,s,w);
+    Net_countSub(c + NC_STRONG*bits*wc,bits,wc,os & ~ns);
+    Net_countAdd(c + NC_STRONG*bits*wc,bits,wc,ns & ~os);
+
+    Net_resolveWord(n,w);
+    changed = 1;
+  }
+  Value_copy(D,s);
+
+  if (!changed)
+    return;
+
+  /*
+   * A trireg net keeps its charge on bits that no driver drives.
+   */
+  r = n->n_resolved;
+  Value_scanLogic(r);
+  if ((n->n_type & NT_P_TRIREG)) {
+    Value_trireg(n->n_charged,r,Net_getValue(n));
+    r = n->n_charged;
+  }
+  Net_set(n,r);
+}
+
 void Net_reportValue(Net *n,const char *who,const char *name,Circuit *c)
 {
 	EvQueue *Q = c->c_evQueue;
@@ -519,6 +990,7 @@ void Net_memSet(Net *n, unsigned addr, Value *data)
 {
   Memory_put(&n->n_data.memory, addr, data);
   Memory_accessNotify(&n->n_data.memory, addr, 1);
+  Net_changedAll(n);
   Net_posedgeNotify(n);
 }
 
@@ -526,6 +998,7 @@ void Net_memSetRange(Net *n, unsigned addr,int nLsb,Value *data,int vMsb,int vLs
 {
   Memory_putRange(&n->n_data.memory, addr, nLsb, data, vMsb, vLsb);
   Memory_accessNotify(&n->n_data.memory, addr, 1);
+  Net_changedAll(n);
   Net_posedgeNotify(n);
 }
 
@@ -219,6 +219,23 @@ typedef struct {
   List/*SNetMap*/	sn_maps;		/* Mappings between net bits and supernet bits */
 } SuperNet;
 
+/*****************************************************************************
+ *
+ * NetSlice - a range of bits of a net that is read by an expression
+ *
+ * Slices are shared: there is one slice for each range of a net that is
+ * read, kept in the list of slices of the net.  Triggers on a slice are
+ * fired only when one of the bits in the slice changes.
+ *
+ *****************************************************************************/
+struct NetSlice_str {
+  Net			*ns_net;		/* Net of which this is a slice */
+  int			ns_msb, ns_lsb;		/* Range of bits in the slice */
+  List/*Trigger*/	ns_notify;		/* Triggers to notify on a change */
+  Trigger		**ns_fanout;		/* Array of ns_notify (null terminated) */
+  NetSlice		*ns_next;		/* Next slice of the same net */
+};
+
 union NetData
 {
 	Value	value;	/* Value of net */
@@ -247,6 +264,18 @@ union NetData
  *
  * the bits that are not addressed in the LHS are set to floating.
  *
+ * The drivers of a net are resolved from counts kept for each bit of the
+ * number of drivers with their one bit set, with their zero bit set, not
+ * floating and, on wand and wor nets, at the overriding value.  A change
+ * of one driver updates the counts and the resolved value only for the
+ * words in which that driver changed.  Each count is stored bit-sliced: bit
+ * j of the counts of the bits of word w is in one word of n_driverCount.
+ *
+ * Triggers that listen on a net are registered in the n_*Notify lists, but
+ * are notified from the n_*Fanout arrays made from those lists, with each
+ * trigger in an array once.  The arrays are made when the circuit starts
+ * running, and a listener added after that is added to both.
+ *
  *****************************************************************************/
 class Net
 {
@@ -267,9 +296,23 @@ public:
 	unsigned		  n_numMonitors;		/* Number of monitors on this net */
 	List/*Trigger*/		  n_posedgeNotify;	/* Triggers to notify on posedge */
 	List/*Trigger*/		  n_negedgeNotify;	/* Triggers to notify on negedge */
+	NetSlice		 *n_slices;		/* Slices of the net that are read */
+	List/*NetSlice*/	  n_sliceNotify;	/* Slices with triggers to notify */
+	Trigger			**n_posedgeFanout;	/* Array of n_posedgeNotify (null terminated) */
+	Trigger			**n_negedgeFanout;	/* Array of n_negedgeNotify (null terminated) */
+	NetSlice		**n_sliceFanout;	/* Array of n_sliceNotify (null terminated) */
 	int			  n_numDrivers;		/* Number of drivers (if WIRE) */
 	Value			**n_drivers;	/* Drivers (if WIRE) */
-	wirefunc_f		 *n_wfunc;	/* Wire function */
+	Event			**n_driverEvents;	/* Pending driver events (if WIRE) */
+	unsigned long long	  n_numEvents;		/* Number of events scheduled on net */
+	wireresolve_f		 *n_wresolve;	/* Wire resolution function */
+	StateSymbol		  n_wstrong;	/* Driver value that overrides others (wand/wor) */
+	int			  n_countBits;	/* Bits in each driver count (0 if not built) */
+	ssword_t		 *n_driverCount;	/* Bit-sliced per-bit counts of driver states */
+	Value			 *n_resolved;	/* Value resolved from the drivers */
+	Value			 *n_charged;	/* Resolved value merged with charge (trireg) */
+	ssword_t		 *n_changed;	/* Bits changed by the last update */
+	ssword_t		  n_changedWord;	/* Storage for n_changed on narrow nets */
 	NetData		  	  n_data;
 private:
 	char			 *n_name;		/* Full path name */
@@ -286,16 +329,23 @@ SNetMap *new_SNetMap(Net *net,int netLsb,int snLsb,int width);
 void Net_print(Net*,FILE*);
 void Net_posedgeListen(Net*n,Trigger*t);
 void Net_negedgeListen(Net*n,Trigger*t);
+NetSlice *Net_getSlice(Net *n,int msb,int lsb);
+void NetSlice_listen(NetSlice *s,Trigger *t);
 void Net_makeUnknown(Net *n);
 void Net_posedgeNotify(Net*n);
 void Net_negedgeNotify(Net*n);
+void Net_freezeFanout(Net *n);
 int Net_addDriver(Net *n);
-void Net_driverChangeNotify(Net *n, int id);
+void Net_setDriver(Net *n, int id, Value *s);
 void Net_reportValue(Net *n,const char *who,const char *name,Circuit *C);
 const char *Net_getLocalName(Net*);
 #define Net_getDriver(n, id)	((n)->n_drivers[(id)])
+#define Net_getDriverEvent(n, id)	((n)->n_driverEvents[(id)])
+#define Net_setDriverEvent(n, id, e)	((n)->n_driverEvents[(id)] = (e))
 #define Net_nbits(n) 		(n)->n_nbits
 #define Net_getValue(n)		(&(n)->n_data.value)
+#define Net_getChanged(n)	(n)->n_changed
+#define NetSlice_isWhole(s)	((s)->ns_lsb == 0 && (s)->ns_msb+1 == (int)Net_nbits((s)->ns_net))
 #define Net_getMemory(n)	(&(n)->n_data.memory)
 #define Net_getType(n)		(n)->n_type
 #define Net_getMsb(n) 		(n)->n_msb
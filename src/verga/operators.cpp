@@ -19,6 +19,7 @@
 ****************************************************************************/
 #include <cassert>
 #include <cctype>
+#include <cstring>
 
 #include "verga.hpp"
 
@@ -100,6 +101,32 @@ OpDesc opTable[] = {
 };
 int opTable_size = sizeof(opTable)/sizeof(opTable[0]);
 
+/*
+ * Operator calls that test their operands for x, z, L and H bits, and the
+ * number of those that were decided by SF_KNOWN alone.  Both are reported
+ * by EvQueue_printProfile().  Each thread counts its own, and the threads
+ * of the parallel executor add theirs to those of the main thread.
+ */
+thread_local unsigned long long Value_opCalls = 0;
+thread_local unsigned long long Value_opFast = 0;
+
+/*
+ * Operand tests.  Value_opKnown2() is true if both operands have SF_KNOWN
+ * set.  Value_opLogic() and Value_opLogic2() fall back on scanning the
+ * operands as Value_isLogic() does.
+ */
+#define Value_opKnown(B)	(Value_opCalls++, Value_isKnown(B) && (Value_opFast++, 1))
+#define Value_opKnown2(A,B)	(Value_opCalls++, Value_isKnown(A) && Value_isKnown(B) && (Value_opFast++, 1))
+#define Value_opLogic(B)	(Value_opKnown(B) || Value_scanLogic(B))
+#define Value_opLogic2(A,B)	(Value_opKnown2(A,B) || (Value_isLogic(A) && Value_isLogic(B)))
+
+/*
+ * Result flags.  SF_KNOWN is not inherited from the operands; it is set by
+ * the functions that store 2-state results.
+ */
+#define Value_opFlags(A,B)	((ValueFlags)(((A)->flags | (B)->flags) & ~SF_KNOWN))
+#define Value_opFlags1(B)	((ValueFlags)((B)->flags & ~SF_KNOWN))
+
 /*****************************************************************************
  *
  * Functions below here implement Verilog operators.  They must all have
@@ -124,7 +151,17 @@ int opTable_size = sizeof(opTable)/sizeof(opTable[0]);
  *****************************************************************************/
 int Value_w_not(Value *R,Value *A,Value *B,Value *C)
 {
-  R->flags = B->flags;
+  int known = Value_opKnown(B);
+
+  R->flags = Value_opFlags1(B);
+
+  if (known) {
+    R->zero[0] = B->one[0];
+    R->one[0] = ~R->zero[0];
+    R->flt[0] = 0;
+    Value_setKnown(R);
+    return 0;
+  }
 
   R->one[0] = B->zero[0] | B->flt[0];
   R->zero[0] = B->one[0] | B->flt[0];
@@ -145,13 +182,24 @@ int Value_w_not(Value *R,Value *A,Value *B,Value *C)
 int Value_not(Value *R,Value *A,Value *B,Value *C)
 {
   int wc = SSNUMWORDS(R->nbits);
+  int known = Value_opKnown(B);
   int i;
 
-  R->flags = B->flags;
+  R->flags = Value_opFlags1(B);
+
+  if (known) {
+    for (i = 0;i < wc;i++) {
+      R->zero[i] = B->one[i];
+      R->one[i] = ~R->zero[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
 
   for (i = 0;i < wc;i++) {
-    register unsigned one = B->zero[i];
-    register unsigned zero = B->one[i];
+    register ssword_t one = B->zero[i];
+    register ssword_t zero = B->one[i];
     R->one[i] = one|B->flt[i];
     R->zero[i] = zero|B->flt[i];
     R->flt[i] = B->flt[i];
@@ -176,6 +224,17 @@ int Value_buf(Value *R,Value *A,Value *B,Value *C)
   int wc = SSNUMWORDS(R->nbits);
   int i;
 
+  if (Value_opKnown(B)) {
+    for (i = 0;i < wc;i++) {
+      R->one[i] = B->one[i];
+      R->zero[i] = ~B->one[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
+
+  Value_clearKnown(R);
   for (i = 0;i < wc;i++) {
     R->one[i] = B->one[i]|B->flt[i];
     R->zero[i] = B->zero[i]|B->flt[i];
@@ -207,13 +266,24 @@ int Value_buf(Value *R,Value *A,Value *B,Value *C)
 int Value_or(Value *R,Value *A,Value *B,Value *C)
 {
   int wc = SSNUMWORDS(R->nbits);
+  int known = Value_opKnown2(A,B);
   register int i;
 
-  R->flags = (ValueFlags)(A->flags | B->flags);
+  R->flags = Value_opFlags(A,B);
+
+  if (known) {
+    for (i = 0;i < wc;i++) {
+      R->one[i] = A->one[i]|B->one[i];
+      R->zero[i] = ~R->one[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
 
   for (i = 0;i < wc;i++) {
-    register unsigned RisOne = (A->one[i]&~A->flt[i])|(B->one[i]&~B->flt[i]);
-    register unsigned inHasFloat = A->flt[i]|B->flt[i];
+    register ssword_t RisOne = (A->one[i]&~A->flt[i])|(B->one[i]&~B->flt[i]);
+    register ssword_t inHasFloat = A->flt[i]|B->flt[i];
 
     R->one[i] = RisOne|inHasFloat;
     R->zero[i] = ~RisOne;
@@ -237,9 +307,20 @@ int Value_nor(Value *R,Value *A,Value *B,Value *C)
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
+  if (Value_opKnown2(A,B)) {
+    for (i = 0;i < wc;i++) {
+      R->one[i] = ~(A->one[i]|B->one[i]);
+      R->zero[i] = ~R->one[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
+
+  Value_clearKnown(R);
   for (i = 0;i < wc;i++) {
-    register unsigned RisOne = (A->one[i]&~A->flt[i])|(B->one[i]&~B->flt[i]);
-    register unsigned inHasFloat = A->flt[i]|B->flt[i];
+    register ssword_t RisOne = (A->one[i]&~A->flt[i])|(B->one[i]&~B->flt[i]);
+    register ssword_t inHasFloat = A->flt[i]|B->flt[i];
 
     R->one[i] = ~RisOne;
     R->zero[i] = RisOne|inHasFloat;
@@ -271,13 +352,24 @@ int Value_nor(Value *R,Value *A,Value *B,Value *C)
 int Value_and(Value *R,Value *A,Value *B,Value *C)
 {
   int wc = SSNUMWORDS(R->nbits);
+  int known = Value_opKnown2(A,B);
   register int i;
 
-  R->flags = (ValueFlags)(A->flags | B->flags);
+  R->flags = Value_opFlags(A,B);
+
+  if (known) {
+    for (i = 0;i < wc;i++) {
+      R->one[i] = A->one[i]&B->one[i];
+      R->zero[i] = ~R->one[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
 
   for (i = 0;i < wc;i++) {
-    register unsigned RisZero = (A->zero[i]&~A->flt[i])|(B->zero[i]&~B->flt[i]);
-    register unsigned inHasFloat = A->flt[i]|B->flt[i];
+    register ssword_t RisZero = (A->zero[i]&~A->flt[i])|(B->zero[i]&~B->flt[i]);
+    register ssword_t inHasFloat = A->flt[i]|B->flt[i];
 
     R->one[i] = ~RisZero;
     R->zero[i] = RisZero|inHasFloat;
@@ -299,13 +391,24 @@ int Value_and(Value *R,Value *A,Value *B,Value *C)
 int Value_nand(Value *R,Value *A,Value *B,Value *C)
 {
   int wc = SSNUMWORDS(R->nbits);
+  int known = Value_opKnown2(A,B);
   register int i;
 
-  R->flags = (ValueFlags)(A->flags | B->flags);
+  R->flags = Value_opFlags(A,B);
+
+  if (known) {
+    for (i = 0;i < wc;i++) {
+      R->one[i] = ~(A->one[i]&B->one[i]);
+      R->zero[i] = ~R->one[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
 
   for (i = 0;i < wc;i++) {
-    register unsigned RisZero = (A->zero[i]&~A->flt[i])|(B->zero[i]&~B->flt[i]);
-    register unsigned inHasFloat = A->flt[i]|B->flt[i];
+    register ssword_t RisZero = (A->zero[i]&~A->flt[i])|(B->zero[i]&~B->flt[i]);
+    register ssword_t inHasFloat = A->flt[i]|B->flt[i];
 
     R->one[i] = RisZero|inHasFloat;
     R->zero[i] = ~RisZero;
@@ -337,13 +440,24 @@ int Value_nand(Value *R,Value *A,Value *B,Value *C)
 int Value_xor(Value *R,Value *A,Value *B,Value *C)
 {
   int wc = SSNUMWORDS(R->nbits);
+  int known = Value_opKnown2(A,B);
   register int i;
 
-  R->flags = (ValueFlags)(A->flags | B->flags);
+  R->flags = Value_opFlags(A,B);
+
+  if (known) {
+    for (i = 0;i < wc;i++) {
+      R->one[i] = A->one[i]^B->one[i];
+      R->zero[i] = ~R->one[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
 
   for (i = 0;i < wc;i++) {
-    register unsigned RisOne = A->one[i]^B->one[i];
-    register unsigned inHasFloat = A->flt[i]|B->flt[i];
+    register ssword_t RisOne = A->one[i]^B->one[i];
+    register ssword_t inHasFloat = A->flt[i]|B->flt[i];
 
     R->one[i]  = RisOne|inHasFloat;
     R->zero[i] = ~(RisOne)|inHasFloat;
@@ -365,13 +479,24 @@ int Value_xor(Value *R,Value *A,Value *B,Value *C)
 int Value_nxor(Value *R,Value *A,Value *B,Value *C)
 {
   int wc = SSNUMWORDS(R->nbits);
+  int known = Value_opKnown2(A,B);
   register int i;
 
-  R->flags = (ValueFlags)(A->flags | B->flags);
+  R->flags = Value_opFlags(A,B);
+
+  if (known) {
+    for (i = 0;i < wc;i++) {
+      R->one[i] = ~(A->one[i]^B->one[i]);
+      R->zero[i] = ~R->one[i];
+      R->flt[i] = 0;
+    }
+    Value_setKnown(R);
+    return 0;
+  }
 
   for (i = 0;i < wc;i++) {
-    register unsigned RisOne = A->one[i]^B->one[i];
-    register unsigned inHasFloat = A->flt[i]|B->flt[i];
+    register ssword_t RisOne = A->one[i]^B->one[i];
+    register ssword_t inHasFloat = A->flt[i]|B->flt[i];
 
     R->one[i]  = ~(RisOne)|inHasFloat;
     R->zero[i] = RisOne|inHasFloat;
@@ -391,10 +516,10 @@ int Value_uand(Value *r,Value *a,Value *b,Value *c)
   register int i;
   int has_unknown = 0;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   for (i = 0;i < wc;i++) {
-    unsigned mask = (i==(wc-1)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+    ssword_t mask = (i==(wc-1) && (b->nbits&SSBITMASK)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
     /*
      * If there are any zero bits, return zero.
@@ -427,9 +552,9 @@ int Value_uand(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_uand(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(b->nbits&SSBITMASK);
+  ssword_t mask = (b->nbits&SSBITMASK) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   /*
    * If there are any zero bits, return zero.
@@ -462,10 +587,10 @@ int Value_uor(Value *r,Value *a,Value *b,Value *c)
   register int i;
   int has_unknown = 0;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   for (i = 0;i < wc;i++) {
-    unsigned mask = (i==(wc-1)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+    ssword_t mask = (i==(wc-1) && (b->nbits&SSBITMASK)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
     /*
      * If there are any one bits, return 1.
@@ -498,9 +623,9 @@ int Value_uor(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_uor(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(b->nbits&SSBITMASK);
+  ssword_t mask = (b->nbits&SSBITMASK) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   /*
    * If there are any one bits, return one.
@@ -534,11 +659,11 @@ int Value_uxor(Value *r,Value *a,Value *b,Value *c)
   register int i,j;
   int n = 0;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   for (i = 0;i < wc;i++) {
-    unsigned mask = (i==(wc-1)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
-    int wsize = (i==(wc-1)) ? (b->nbits&SSBITMASK) : SSWORDSIZE;
+    ssword_t mask = (i==(wc-1) && (b->nbits&SSBITMASK)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+    int wsize = (i==(wc-1) && (b->nbits&SSBITMASK)) ? (b->nbits&SSBITMASK) : SSWORDSIZE;
 
     /*
      * If there are any unknown bits, return unknown
@@ -552,7 +677,7 @@ int Value_uxor(Value *r,Value *a,Value *b,Value *c)
      * count one bits
      */
     for (j = 0;j < wsize;j++)
-      if ((b->one[i] & (1 << j))) n++;
+      if ((b->one[i] & ((ssword_t)1 << j))) n++;
   }
 
   /*
@@ -574,10 +699,11 @@ int Value_uxor(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_uxor(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(b->nbits&SSBITMASK);
-  unsigned x,count;
+  ssword_t mask = (b->nbits&SSBITMASK) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+  ssword_t x;
+  unsigned count;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   /*
    * If there are any unknown bits, return unknown
@@ -616,10 +742,10 @@ int Value_unand(Value *r,Value *a,Value *b,Value *c)
   register int i;
   int has_unknown = 0;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   for (i = 0;i < wc;i++) {
-    unsigned mask = (i==(wc-1)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+    ssword_t mask = (i==(wc-1) && (b->nbits&SSBITMASK)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
     /*
      * If there are any zero bits, return one.
@@ -652,9 +778,9 @@ int Value_unand(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_unand(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(b->nbits&SSBITMASK);
+  ssword_t mask = (b->nbits&SSBITMASK) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   /*
    * If there are any zero bits, return one.
@@ -688,10 +814,10 @@ int Value_unor(Value *r,Value *a,Value *b,Value *c)
   register int i;
   int has_unknown = 0;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   for (i = 0;i < wc;i++) {
-    unsigned mask = (i==(wc-1)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+    ssword_t mask = (i==(wc-1) && (b->nbits&SSBITMASK)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
     /*
      * If there are any one bits, return 0.
@@ -719,9 +845,9 @@ int Value_unor(Value *r,Value *a,Value *b,Value *c)
 
 int Value_w_unor(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(b->nbits&SSBITMASK);
+  ssword_t mask = (b->nbits&SSBITMASK) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   /*
    * If there are any one bits, return one.
@@ -754,11 +880,11 @@ int Value_unxor(Value *r,Value *a,Value *b,Value *c)
   register int i,j;
   int n = 0;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   for (i = 0;i < wc;i++) {
-    unsigned mask = (i==(wc-1)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
-    int wsize = (i==(wc-1)) ? (b->nbits&SSBITMASK) : SSWORDSIZE;
+    ssword_t mask = (i==(wc-1) && (b->nbits&SSBITMASK)) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+    int wsize = (i==(wc-1) && (b->nbits&SSBITMASK)) ? (b->nbits&SSBITMASK) : SSWORDSIZE;
 
     /*
      * If there are any unknown bits, return unknown
@@ -772,7 +898,7 @@ int Value_unxor(Value *r,Value *a,Value *b,Value *c)
      * count one bits
      */
     for (j = 0;j < wsize;j++)
-      if ((b->one[i] & (1 << j))) n++;
+      if ((b->one[i] & ((ssword_t)1 << j))) n++;
   }
 
   /*
@@ -789,10 +915,11 @@ int Value_unxor(Value *r,Value *a,Value *b,Value *c)
 
 int Value_w_unxor(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(b->nbits&SSBITMASK);
-  unsigned x,count;
+  ssword_t mask = (b->nbits&SSBITMASK) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+  ssword_t x;
+  unsigned count;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   /*
    * If there are any unknown bits, return unknown
@@ -826,9 +953,9 @@ int Value_w_unxor(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_lnot(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
-  if (!Value_isLogic(b))
+  if (!Value_opLogic(b))
     Value_unknown(r);
   else if (Value_isZero(b))
     Value_lone(r);
@@ -849,16 +976,16 @@ int Value_neg(Value *r,Value *a,Value *b,Value *c)
   int carry = 1;
   int i;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
-  if (!Value_isLogic(b)) {
+  if (!Value_opLogic(b)) {
     Value_unknown(r);
     return 0;
   }
 
   for (i = 0;i < wc;i++) {
     r->one[i] = ~b->one[i] + carry;
-    carry = (b->one[i] == ~0);
+    carry = carry && (b->one[i] == 0);
   }
 
   Value_normalize(r);
@@ -873,9 +1000,9 @@ int Value_neg(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_neg(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
-  if (!Value_isLogic(b)) {
+  if (!Value_opLogic(b)) {
     Value_unknown(r);
     return 0;
   }
@@ -894,12 +1021,12 @@ int Value_w_neg(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_mul(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = SSWORDMASK;
+  ssword_t mask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
   int wc = SSNUMWORDS(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -920,11 +1047,11 @@ int Value_mul(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_mul(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -943,13 +1070,13 @@ int Value_w_mul(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_div(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = SSWORDMASK;
+  ssword_t mask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
   int wc = SSNUMWORDS(r->nbits);
   int ecode;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -971,11 +1098,11 @@ int Value_div(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_div(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -999,13 +1126,13 @@ int Value_w_div(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_mod(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = SSWORDMASK;
+  ssword_t mask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
   int wc = SSNUMWORDS(r->nbits);
   int ecode;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1027,11 +1154,11 @@ int Value_mod(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_mod(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1054,11 +1181,11 @@ int Value_w_mod(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_add(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1080,11 +1207,11 @@ int Value_add(Value *r,Value *a,Value *b,Value *c)
   int wc = SSNUMWORDS(r->nbits);
   register int i;
   int carry = 0;
-  unsigned mask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
+  ssword_t mask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1116,11 +1243,11 @@ int Value_add(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_sub(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1144,11 +1271,11 @@ int Value_sub(Value *r,Value *a,Value *b,Value *c)
   int wc = SSNUMWORDS(r->nbits);
   register int i;
   int carry = 1;
-  unsigned mask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
+  ssword_t mask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1161,7 +1288,7 @@ int Value_sub(Value *r,Value *a,Value *b,Value *c)
      * Generate carry for next word.
      */
     ncarry = ((a->one[i] & 0x1) + (~b->one[i] & 0x1) + carry) >> 1;
-    ncarry = ((a->one[i]>>1) + (~b->one[i]>>1) + carry) >> (SSWORDSIZE-1);
+    ncarry = ((a->one[i]>>1) + (~b->one[i]>>1) + ncarry) >> (SSWORDSIZE-1);
 
     r->one[i] = a->one[i] + ~b->one[i] + carry;
 
@@ -1182,11 +1309,11 @@ int Value_sub(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_rshift(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned smask = (b->nbits < SSWORDSIZE) ? LMASK(b->nbits) : ~0;
+  ssword_t smask = (b->nbits < SSWORDSIZE) ? LMASK(b->nbits) : ~0;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(b))
+  if (!Value_opLogic(b))
     Value_unknown(r);
   else
     Value_shift(r, a, -(b->one[0]&smask), 0, 1, 0);
@@ -1201,15 +1328,15 @@ int Value_rshift(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_arshift(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned smask = (b->nbits < SSWORDSIZE) ? LMASK(b->nbits) : ~0;
+  ssword_t smask = (b->nbits < SSWORDSIZE) ? LMASK(b->nbits) : ~0;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(b)) {
+  if (!Value_opLogic(b)) {
     Value_unknown(r);
   } else {
     int wc = SSNUMWORDS(a->nbits);
-    int hb = 1 << SSHIGHBIT(a->nbits);
+    ssword_t hb = (ssword_t)1 << SSHIGHBIT(a->nbits);
     int in1 = (a->one[wc-1] & hb) != 0;
     int in0 = (a->zero[wc-1] & hb) != 0;
     int inZ = (a->flt[wc-1] & hb) != 0;
@@ -1227,11 +1354,11 @@ int Value_arshift(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_lshift(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned smask = (b->nbits < SSWORDSIZE) ? LMASK(b->nbits) : ~0;
+  ssword_t smask = (b->nbits < SSWORDSIZE) ? LMASK(b->nbits) : ~0;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(b))
+  if (!Value_opLogic(b))
     Value_unknown(r);
   else
     Value_shift(r, a, b->one[0]&smask, 0, 1, 0);
@@ -1256,9 +1383,9 @@ int Value_alshift(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_rshift(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(b))
+  if (!Value_opLogic(b))
     Value_unknown(r);
   else
     Value_w_shift(r, a, -(b->one[0]&LMASK(b->nbits)), 0, 1, 0);
@@ -1273,12 +1400,12 @@ int Value_w_rshift(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_arshift(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(b)) {
+  if (!Value_opLogic(b)) {
     Value_unknown(r);
   } else {
-    int hb = 1 << SSHIGHBIT(a->nbits);
+    ssword_t hb = (ssword_t)1 << SSHIGHBIT(a->nbits);
     int in1 = (a->one[0] & hb) != 0;
     int in0 = (a->zero[0] & hb) != 0;
     int inZ = (a->flt[0] & hb) != 0;
@@ -1296,9 +1423,9 @@ int Value_w_arshift(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_lshift(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(b))
+  if (!Value_opLogic(b))
     Value_unknown(r);
   else
     Value_w_shift(r, a, b->one[0]&LMASK(b->nbits), 0, 1, 0);
@@ -1323,11 +1450,11 @@ int Value_w_alshift(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_gt(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1348,11 +1475,11 @@ int Value_gt(Value *r,Value *a,Value *b,Value *c)
 {
   int i;
   int wc = SSNUMWORDS(r->nbits);
-  unsigned mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
+  ssword_t mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1381,11 +1508,11 @@ int Value_gt(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_lt(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1406,11 +1533,11 @@ int Value_lt(Value *r,Value *a,Value *b,Value *c)
 {
   int i;
   int wc = SSNUMWORDS(r->nbits);
-  unsigned mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
+  ssword_t mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1439,11 +1566,11 @@ int Value_lt(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_ge(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1464,11 +1591,11 @@ int Value_ge(Value *r,Value *a,Value *b,Value *c)
 {
   int i;
   int wc = SSNUMWORDS(r->nbits);
-  unsigned mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
+  ssword_t mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1497,11 +1624,11 @@ int Value_ge(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_le(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1522,11 +1649,11 @@ int Value_le(Value *r,Value *a,Value *b,Value *c)
 {
   int i;
   int wc = SSNUMWORDS(r->nbits);
-  unsigned mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
+  ssword_t mask = (r->nbits & SSBITMASK) ? LMASK(r->nbits & SSBITMASK) : SSWORDMASK;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1608,21 +1735,21 @@ int Value_eq(Value *r,Value *a,Value *b,Value *c)
   int wc = SSNUMWORDS(a->nbits);
   int i;
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
   if (a->nbits != b->nbits) {
     Value_lone(r);
     return -1;
   }
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
 
   for (i = 0;i < wc;i++) {
     if (i == wc-1 && (r->nbits & SSBITMASK)) {
-      unsigned mask = LMASK((r->nbits & SSBITMASK));
+      ssword_t mask = LMASK((r->nbits & SSBITMASK));
 
       if ((a->one[i]&mask) != (b->one[i]&mask)) {
 	Value_zero(r);
@@ -1659,11 +1786,11 @@ int Value_neq(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_land(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1682,9 +1809,9 @@ int Value_w_land(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_land(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1703,11 +1830,11 @@ int Value_land(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_w_lor(Value *r,Value *a,Value *b,Value *c)
 {
-  unsigned mask = LMASK(r->nbits);
+  ssword_t mask = LMASK(r->nbits);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1726,9 +1853,9 @@ int Value_w_lor(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_lor(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (!Value_isLogic(a) || !Value_isLogic(b)) {
+  if (!Value_opLogic2(a,b)) {
     Value_unknown(r);
     return 0;
   }
@@ -1747,9 +1874,9 @@ int Value_lor(Value *r,Value *a,Value *b,Value *c)
  *****************************************************************************/
 int Value_ifelse(Value *r,Value *a,Value *b,Value *c)
 {
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
-  if (Value_isLogic(a)) {
+  if (Value_opLogic(a)) {
     if (Value_isZero(a))
       Value_copy(r,c);
     else
@@ -1764,7 +1891,7 @@ int Value_ifelse(Value *r,Value *a,Value *b,Value *c)
      */
 
     for (i = 0;i < wc;i++) {
-      unsigned unknown = b->flt[i] | c->flt[i] | (b->one[i] ^ c->one[i]);
+      ssword_t unknown = b->flt[i] | c->flt[i] | (b->one[i] ^ c->one[i]);
 
       r->one[i]  = (b->one[i] &c->one[i]) | unknown;
       r->zero[i] = (b->zero[i]&c->zero[i]) | unknown;
@@ -1786,11 +1913,12 @@ int Value_ifelse(Value *r,Value *a,Value *b,Value *c)
 int Value_concat(Value *r,Value *a,Value *b,Value *c)
 {
   int rhs_nbits = a->nbits + b->nbits;
+  int known = Value_isKnown(a) && Value_isKnown(b);
 
-  r->flags = (ValueFlags)(a->flags | b->flags);
+  r->flags = Value_opFlags(a,b);
 
   if (rhs_nbits <= SSWORDSIZE) {
-    unsigned mask = LMASK(b->nbits);
+    ssword_t mask = LMASK(b->nbits);
 
     r->one[0] = (b->one[0] & mask) | (a->one[0] << b->nbits);
     r->zero[0] = (b->zero[0] & mask) | (a->zero[0] << b->nbits);
@@ -1809,7 +1937,8 @@ int Value_concat(Value *r,Value *a,Value *b,Value *c)
 	r->zero[i] = ~0;
 	r->flt[i] = 0;
       }
-    }
+    } else if (known)
+      Value_setKnown(r);
   } else {
     Value_zero(r);
     Value_copyRange(r,0,b,b->nbits-1,0);
@@ -1884,7 +2013,7 @@ int Value_repcat(Value *r,Value *a,Value *b,Value *c)
   unsigned n,i;
   int rhs_nbits;
 
-  r->flags = b->flags;
+  r->flags = Value_opFlags1(b);
 
   if (Value_toInt(a,&n)) return -1;	/* Must be a number */
 
@@ -1897,7 +2026,7 @@ int Value_repcat(Value *r,Value *a,Value *b,Value *c)
 
   rhs_nbits = n*b->nbits;
   if (rhs_nbits <= SSWORDSIZE) {
-    unsigned mask = LMASK(b->nbits);
+    ssword_t mask = LMASK(b->nbits);
 
     r->one[0]  = b->one[0]&mask;
     r->zero[0] = b->zero[0]&mask;
@@ -1912,7 +2041,7 @@ int Value_repcat(Value *r,Value *a,Value *b,Value *c)
     //
     if (r->nbits > rhs_nbits) {
       if (rhs_nbits < SSWORDSIZE) {
-	unsigned mask = LMASK(rhs_nbits);
+	ssword_t mask = LMASK(rhs_nbits);
 	r->zero[0] |= ~mask;
       }
       for (i = 1;i < rwc;i++) {
@@ -1921,6 +2050,8 @@ int Value_repcat(Value *r,Value *a,Value *b,Value *c)
 	r->flt[i] = 0;
       }
     }
+    if (Value_isKnown(b))
+      Value_setKnown(r);
   } else {
     Value_zero(r);
     for (i = 0;i < n;i++)
@@ -1957,11 +2088,12 @@ int Value_bufif1(Value *R,Value *I,Value *E,Value *dummy)
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
+  Value_clearKnown(R);
   for (i = 0;i < wc;i++) {
-    register unsigned IisZero = I->zero[i] & ~I->one[i] & ~I->flt[i];
-    register unsigned EisZero = E->zero[i] & ~E->one[i] & ~E->flt[i];
-    register unsigned IisOne  = ~I->zero[i] & I->one[i] & ~I->flt[i];
-    register unsigned EisOne  = ~E->zero[i] & E->one[i] & ~E->flt[i];
+    register ssword_t IisZero = I->zero[i] & ~I->one[i] & ~I->flt[i];
+    register ssword_t EisZero = E->zero[i] & ~E->one[i] & ~E->flt[i];
+    register ssword_t IisOne  = ~I->zero[i] & I->one[i] & ~I->flt[i];
+    register ssword_t EisOne  = ~E->zero[i] & E->one[i] & ~E->flt[i];
     R->one[i] = ~(IisZero|EisZero);
     R->zero[i] = ~(EisZero|IisOne);
     R->flt[i] = ~((IisZero|IisOne)&EisOne);
@@ -1997,11 +2129,12 @@ int Value_bufif0(Value *R,Value *I,Value *E,Value *dummy)
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
+  Value_clearKnown(R);
   for (i = 0;i < wc;i++) {
-    register unsigned IisZero = I->zero[i] & ~I->one[i] & ~I->flt[i];
-    register unsigned EisZero = E->zero[i] & ~E->one[i] & ~E->flt[i];
-    register unsigned IisOne  = ~I->zero[i] & I->one[i] & ~I->flt[i];
-    register unsigned EisOne  = ~E->zero[i] & E->one[i] & ~E->flt[i];
+    register ssword_t IisZero = I->zero[i] & ~I->one[i] & ~I->flt[i];
+    register ssword_t EisZero = E->zero[i] & ~E->one[i] & ~E->flt[i];
+    register ssword_t IisOne  = ~I->zero[i] & I->one[i] & ~I->flt[i];
+    register ssword_t EisOne  = ~E->zero[i] & E->one[i] & ~E->flt[i];
     R->one[i] = ~(IisZero|EisOne);
     R->zero[i] = ~(EisOne|IisOne);
     R->flt[i] = ~((IisZero|IisOne)&EisZero);
@@ -2036,10 +2169,11 @@ int Value_nmos(Value *R,Value *I,Value *G,Value *dummy)
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
+  Value_clearKnown(R);
   for (i = 0;i < wc;i++) {
-    register unsigned GisZero = G->zero[i] & ~G->one[i] & ~G->flt[i];
-    register unsigned GisOne = ~G->zero[i] & G->one[i] & ~G->flt[i];
-    register unsigned IisLogic = (I->zero[i] ^ I->one[i]) & ~I->flt[i];
+    register ssword_t GisZero = G->zero[i] & ~G->one[i] & ~G->flt[i];
+    register ssword_t GisOne = ~G->zero[i] & G->one[i] & ~G->flt[i];
+    register ssword_t IisLogic = (I->zero[i] ^ I->one[i]) & ~I->flt[i];
 
     R->one[i]  = I->one[i] & ~GisZero;
     R->zero[i] = I->zero[i] & ~GisZero;
@@ -2075,10 +2209,11 @@ int Value_pmos(Value *R, Value *I, Value *G, Value *dummy)
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
+  Value_clearKnown(R);
   for (i = 0;i < wc;i++) {
-    register unsigned GisZero = G->zero[i] & ~G->one[i] & ~G->flt[i];
-    register unsigned GisOne = ~G->zero[i] & G->one[i] & ~G->flt[i];
-    register unsigned IisLogic = (I->zero[i] ^ I->one[i]) & ~I->flt[i];
+    register ssword_t GisZero = G->zero[i] & ~G->one[i] & ~G->flt[i];
+    register ssword_t GisOne = ~G->zero[i] & G->one[i] & ~G->flt[i];
+    register ssword_t IisLogic = (I->zero[i] ^ I->one[i]) & ~I->flt[i];
 
     R->one[i]  = I->one[i] & ~GisOne;
     R->zero[i] = I->zero[i] & ~GisOne;
@@ -2283,3 +2418,1004 @@ int Value_f_caseNeq(Value *r,Value *a,Value *b,Value *c)
 
   return 0;
 }
+
+/*****************************************************************************
+ *
+ * Width-specialized operator kernels
+ *
+ * The functions above work on any value through loops over the three bit
+ * planes, calling Value_isLogic() and Value_normalize() on the way.  The
+ * kernels below are generated from templates for a fixed number of words so
+ * that the loops unroll and the plane tests inline.  BCOpr_init() replaces
+ * the handler of an operation with a kernel when all of its values fall in
+ * one of the width classes:
+ *
+ *    VK_BIT		Every value is a single bit
+ *    VK_WORD		Every value fits in one word
+ *    VK_DWORD		Every value fills exactly two words
+ *
+ * Bitwise kernels work on the one planes alone when their operands have
+ * SF_KNOWN set, and use the 4-state plane formulas otherwise.  Arithmetic and
+ * comparison kernels test the flags, then the float planes, of their operands
+ * once and take the known 2-state form, which works on one integer of the
+ * class width, when no bit is floating.
+ *
+ * Kernels leave bits above nbits in the same don't-care state as the word
+ * functions they replace.
+ *
+ *****************************************************************************/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VK_SIMD		1		/* Vector kernels for wide values */
+#endif
+
+enum {
+  VK_BIT = 0,
+  VK_WORD = 1,
+  VK_DWORD = 2,
+  VK_MAX = 3
+};
+
+/*
+ * How a bitwise kernel sets the result flags
+ */
+enum {
+  VKF_NONE = 0,		/* Flags are left alone */
+  VKF_BINARY = 1,	/* Flags are the union of A and B flags */
+  VKF_UNARY = 2		/* Flags are copied from B */
+};
+
+/*
+ * The three planes of one word, or of one vector of words
+ */
+template<class T> struct VKPlanes {
+  T one, zero, flt;
+};
+
+struct VKAnd {
+  static const int flags = VKF_BINARY;
+  static const int unary = 0;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = a & b; }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T RisZero = (A.zero&~A.flt)|(B.zero&~B.flt);
+    T inHasFloat = A.flt|B.flt;
+
+    R.one = ~RisZero;
+    R.zero = RisZero|inHasFloat;
+    R.flt = (inHasFloat&~RisZero);
+  }
+};
+
+struct VKNand {
+  static const int flags = VKF_BINARY;
+  static const int unary = 0;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = ~(a & b); }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T RisZero = (A.zero&~A.flt)|(B.zero&~B.flt);
+    T inHasFloat = A.flt|B.flt;
+
+    R.one = RisZero|inHasFloat;
+    R.zero = ~RisZero;
+    R.flt = (inHasFloat&~RisZero);
+  }
+};
+
+struct VKOr {
+  static const int flags = VKF_BINARY;
+  static const int unary = 0;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = a | b; }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T RisOne = (A.one&~A.flt)|(B.one&~B.flt);
+    T inHasFloat = A.flt|B.flt;
+
+    R.one = RisOne|inHasFloat;
+    R.zero = ~RisOne;
+    R.flt = (inHasFloat&~RisOne);
+  }
+};
+
+struct VKNor {
+  static const int flags = VKF_NONE;
+  static const int unary = 0;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = ~(a | b); }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T RisOne = (A.one&~A.flt)|(B.one&~B.flt);
+    T inHasFloat = A.flt|B.flt;
+
+    R.one = ~RisOne;
+    R.zero = RisOne|inHasFloat;
+    R.flt = (inHasFloat&~RisOne);
+  }
+};
+
+struct VKXor {
+  static const int flags = VKF_BINARY;
+  static const int unary = 0;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = a ^ b; }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T RisOne = A.one^B.one;
+    T inHasFloat = A.flt|B.flt;
+
+    R.one  = RisOne|inHasFloat;
+    R.zero = ~(RisOne)|inHasFloat;
+    R.flt  = inHasFloat;
+  }
+};
+
+struct VKNxor {
+  static const int flags = VKF_BINARY;
+  static const int unary = 0;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = ~(a ^ b); }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T RisOne = A.one^B.one;
+    T inHasFloat = A.flt|B.flt;
+
+    R.one  = ~(RisOne)|inHasFloat;
+    R.zero = RisOne|inHasFloat;
+    R.flt  = inHasFloat;
+  }
+};
+
+struct VKNot {
+  static const int flags = VKF_UNARY;
+  static const int unary = 1;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = ~b; }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T one = B.zero;
+    T zero = B.one;
+    T flt = B.flt;
+
+    R.one = one|flt;
+    R.zero = zero|flt;
+    R.flt = flt;
+  }
+};
+
+struct VKBuf {
+  static const int flags = VKF_NONE;
+  static const int unary = 1;
+  template<class T> static inline void eval1(T &r,const T &a,const T &b) { r = b; }
+  template<class T> static inline void eval(VKPlanes<T> &R,const VKPlanes<T> &A,const VKPlanes<T> &B) {
+    T flt = B.flt;
+
+    R.one = B.one|flt;
+    R.zero = B.zero|flt;
+    R.flt = flt;
+  }
+};
+
+/*
+ * Apply a bitwise operator to word i of its values.  Unary operators only
+ * read B.  Value_k_word1() is for operands with SF_KNOWN set and works on
+ * the one planes only.
+ */
+template<class Op>
+static inline void Value_k_word(Value *R,Value *A,Value *B,int i)
+{
+  VKPlanes<ssword_t> a, b, r;
+
+  b.one = B->one[i];
+  b.zero = B->zero[i];
+  b.flt = B->flt[i];
+  if (Op::unary)
+    a = b;
+  else {
+    a.one = A->one[i];
+    a.zero = A->zero[i];
+    a.flt = A->flt[i];
+  }
+
+  Op::eval(r,a,b);
+
+  R->one[i] = r.one;
+  R->zero[i] = r.zero;
+  R->flt[i] = r.flt;
+}
+
+template<class Op>
+static inline void Value_k_word1(Value *R,Value *A,Value *B,int i)
+{
+  ssword_t b = B->one[i];
+  ssword_t a = Op::unary ? b : A->one[i];
+
+  Op::eval1(R->one[i],a,b);
+  R->zero[i] = ~R->one[i];
+  R->flt[i] = 0;
+}
+
+/*****************************************************************************
+ *
+ * Bitwise kernel on values of NW words
+ *
+ * Parameters:
+ *     R		Return value
+ *     A,B		Operands (A is unused by unary operators)
+ *     C		Unused
+ *
+ *****************************************************************************/
+template<class Op,int NW>
+static int Value_k_bitwise(Value *R,Value *A,Value *B,Value *C)
+{
+  int known = Op::unary ? Value_opKnown(B) : Value_opKnown2(A,B);
+  int i;
+
+  if (Op::flags == VKF_BINARY)
+    R->flags = Value_opFlags(A,B);
+  else if (Op::flags == VKF_UNARY)
+    R->flags = Value_opFlags1(B);
+
+  if (known) {
+    for (i = 0;i < NW;i++)
+      Value_k_word1<Op>(R,A,B,i);
+    Value_setKnown(R);
+    return 0;
+  }
+
+  Value_clearKnown(R);
+  for (i = 0;i < NW;i++)
+    Value_k_word<Op>(R,A,B,i);
+
+  return 0;
+}
+
+/*
+ * Width classes for arithmetic kernels.  Each class gives the integer type
+ * holding the one plane of a value, the mask of the bits in use, a test for
+ * a value having no floating bits, and load and store of the one plane.
+ */
+template<int W> struct VKWidth;
+
+template<> struct VKWidth<VK_BIT> {
+  typedef ssword_t word_t;
+  static inline word_t mask(Value *S) { return 1; }
+  static inline int known(Value *S) { return !(S->flt[0] & 1); }
+  static inline word_t load(Value *S) { return S->one[0]; }
+  static inline void store(Value *S,word_t v) {
+    S->one[0] = v;
+    S->zero[0] = ~v;
+    S->flt[0] = 0;
+  }
+  static inline void unknown(Value *S) {
+    S->one[0] = S->zero[0] = S->flt[0] = ~0;
+  }
+};
+
+template<> struct VKWidth<VK_WORD> {
+  typedef ssword_t word_t;
+  static inline word_t mask(Value *S) { return SSWORDMASK >> (SSWORDSIZE-S->nbits); }
+  static inline int known(Value *S) { return !(S->flt[0] & mask(S)); }
+  static inline word_t load(Value *S) { return S->one[0]; }
+  static inline void store(Value *S,word_t v) {
+    S->one[0] = v;
+    S->zero[0] = ~v;
+    S->flt[0] = 0;
+  }
+  static inline void unknown(Value *S) {
+    S->one[0] = S->zero[0] = S->flt[0] = ~0;
+  }
+};
+
+template<> struct VKWidth<VK_DWORD> {
+  typedef ssdword_t word_t;
+  static inline ssword_t top(Value *S) {
+    return (S->nbits & SSBITMASK) ? LMASK(S->nbits & SSBITMASK) : SSWORDMASK;
+  }
+  static inline word_t mask(Value *S) { return ((word_t)top(S) << SSWORDSIZE) | SSWORDMASK; }
+  static inline int known(Value *S) { return !(S->flt[0] | (S->flt[1] & top(S))); }
+  static inline word_t load(Value *S) { return ((word_t)S->one[1] << SSWORDSIZE) | S->one[0]; }
+  static inline void store(Value *S,word_t v) {
+    S->one[0] = (ssword_t)v;
+    S->one[1] = (ssword_t)(v >> SSWORDSIZE);
+    S->zero[0] = ~S->one[0];
+    S->zero[1] = ~S->one[1];
+    S->flt[0] = S->flt[1] = 0;
+  }
+  static inline void unknown(Value *S) {
+    S->one[0] = S->zero[0] = S->flt[0] = ~0;
+    S->one[1] = S->zero[1] = S->flt[1] = ~0;
+  }
+};
+
+struct VKAdd { template<class T> static inline T eval(T a,T b) { return a + b; } };
+struct VKSub { template<class T> static inline T eval(T a,T b) { return a - b; } };
+struct VKGt  { template<class T> static inline T eval(T a,T b) { return a > b; } };
+struct VKLt  { template<class T> static inline T eval(T a,T b) { return a < b; } };
+struct VKGe  { template<class T> static inline T eval(T a,T b) { return a >= b; } };
+struct VKLe  { template<class T> static inline T eval(T a,T b) { return a <= b; } };
+
+/*****************************************************************************
+ *
+ * Arithmetic and comparison kernel for width class W
+ *
+ * Parameters:
+ *     R		Return value
+ *     A,B		Operands
+ *     C		Unused
+ *
+ * Operands are masked to the width of R as in the word functions.
+ *
+ *****************************************************************************/
+template<class Op,int W>
+static int Value_k_arith(Value *R,Value *A,Value *B,Value *C)
+{
+  typedef VKWidth<W> Wd;
+  typename Wd::word_t mask = Wd::mask(R);
+  int known = Value_opKnown2(A,B);
+
+  /*
+   * Operands found to be 2-state by their float planes are marked so that
+   * the flag test decides them next time.
+   */
+  if (!known && Wd::known(A) && Wd::known(B)) {
+    Value_setKnown(A);
+    Value_setKnown(B);
+    known = 1;
+  }
+
+  R->flags = Value_opFlags(A,B);
+
+  if (!known) {
+    Wd::unknown(R);
+    return 0;
+  }
+
+  Wd::store(R,Op::eval(Wd::load(A) & mask,Wd::load(B) & mask));
+  Value_setKnown(R);
+
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Vector kernels for wide values
+ *
+ * Bitwise, reduction and equality operators on operands of at least
+ * THYMEVALUE_SIMDBITS bits work on several words at a time.  Each kernel is
+ * written once with GCC vector types of VB bytes and compiled for SSE2
+ * (16 bytes), AVX2 (32 bytes) and AVX-512 (64 bytes) by the wrappers
+ * below.  Value_kernel() uses the widest set the processor supports, or the
+ * one chosen with Value_setSimd().  The top word of a value is handled one
+ * word at a time exactly as in the word functions, so that the results are
+ * identical to theirs, bits above nbits included.
+ *
+ *****************************************************************************/
+#if VK_SIMD
+
+enum {
+  VKS_NONE = 0,
+  VKS_SSE2 = 1,
+  VKS_AVX2 = 2,
+  VKS_AVX512 = 3,
+  VKS_MAX = 4
+};
+
+template<int VB> struct VKVec {
+  typedef ssword_t vec_t __attribute__((vector_size(VB)));
+};
+
+#define VK_INLINE	inline __attribute__((always_inline))
+
+template<int VB>
+static VK_INLINE void VK_load(typename VKVec<VB>::vec_t &v,const ssword_t *p)
+{
+  memcpy(&v,p,VB);
+}
+
+template<int VB>
+static VK_INLINE void VK_store(ssword_t *p,const typename VKVec<VB>::vec_t &v)
+{
+  memcpy(p,&v,VB);
+}
+
+/*
+ * OR or XOR of the words in a vector
+ */
+template<int VB>
+static VK_INLINE ssword_t VK_or(const typename VKVec<VB>::vec_t &v)
+{
+  ssword_t x = 0;
+  int i;
+
+  for (i = 0;i < (int)(VB/sizeof(ssword_t));i++)
+    x |= v[i];
+  return x;
+}
+
+template<int VB>
+static VK_INLINE ssword_t VK_xor(const typename VKVec<VB>::vec_t &v)
+{
+  ssword_t x = 0;
+  int i;
+
+  for (i = 0;i < (int)(VB/sizeof(ssword_t));i++)
+    x ^= v[i];
+  return x;
+}
+
+/*
+ * Bitwise operator.  The vector loop covers whole vectors of R and the
+ * remaining words are done by Value_k_word().  Known operands only have
+ * their one planes read.
+ */
+template<class Op> struct VKSBitwise {
+  template<int VB>
+  static VK_INLINE int run(Value *R,Value *A,Value *B,Value *C) {
+    typedef typename VKVec<VB>::vec_t V;
+    const int W = VB/sizeof(ssword_t);
+    int wc = SSNUMWORDS(R->nbits);
+    int known = Op::unary ? Value_opKnown(B) : Value_opKnown2(A,B);
+    VKPlanes<V> a, b, r;
+    int i;
+
+    if (Op::flags == VKF_BINARY)
+      R->flags = Value_opFlags(A,B);
+    else if (Op::flags == VKF_UNARY)
+      R->flags = Value_opFlags1(B);
+
+    if (known) {
+      V zeros = {};
+
+      for (i = 0;i+W <= wc;i += W) {
+	VK_load<VB>(b.one,B->one+i);
+	if (Op::unary)
+	  a.one = b.one;
+	else
+	  VK_load<VB>(a.one,A->one+i);
+
+	Op::eval1(r.one,a.one,b.one);
+
+	VK_store<VB>(R->one+i,r.one);
+	VK_store<VB>(R->zero+i,~r.one);
+	VK_store<VB>(R->flt+i,zeros);
+      }
+
+      for (;i < wc;i++)
+	Value_k_word1<Op>(R,A,B,i);
+
+      Value_setKnown(R);
+      return 0;
+    }
+
+    Value_clearKnown(R);
+    for (i = 0;i+W <= wc;i += W) {
+      VK_load<VB>(b.one,B->one+i);
+      VK_load<VB>(b.zero,B->zero+i);
+      VK_load<VB>(b.flt,B->flt+i);
+      if (Op::unary)
+	a = b;
+      else {
+	VK_load<VB>(a.one,A->one+i);
+	VK_load<VB>(a.zero,A->zero+i);
+	VK_load<VB>(a.flt,A->flt+i);
+      }
+
+      Op::eval(r,a,b);
+
+      VK_store<VB>(R->one+i,r.one);
+      VK_store<VB>(R->zero+i,r.zero);
+      VK_store<VB>(R->flt+i,r.flt);
+    }
+
+    for (;i < wc;i++)
+      Value_k_word<Op>(R,A,B,i);
+
+    return 0;
+  }
+};
+
+/*
+ * Reduction operator.  Whole words are scanned for a deciding bit (a zero
+ * for AND, a one for OR), a floating bit and the parity of the one plane;
+ * the top word is masked to nbits.
+ */
+enum {
+  VKR_AND = 0,
+  VKR_OR = 1,
+  VKR_XOR = 2
+};
+
+template<int Red,int Neg> struct VKSReduce {
+  template<int VB>
+  static VK_INLINE int run(Value *r,Value *a,Value *b,Value *c) {
+    typedef typename VKVec<VB>::vec_t V;
+    const int W = VB/sizeof(ssword_t);
+    int wc = SSNUMWORDS(b->nbits);
+    ssword_t mask = (b->nbits&SSBITMASK) ? LMASK(b->nbits&SSBITMASK) : SSWORDMASK;
+    const ssword_t *p = (Red == VKR_AND) ? b->zero : b->one;
+    V vhit = {}, vflt = {}, vpar = {};
+    ssword_t hit, flt, par;
+    int i;
+
+    r->flags = Value_opFlags1(b);
+
+    /*
+     * A known operand has a zero wherever the one plane does, and no floating
+     * bits, so only the one plane is read.
+     */
+    if (Value_opKnown(b)) {
+      for (i = 0;i+W < wc;i += W) {
+	V x;
+
+	VK_load<VB>(x,b->one+i);
+	if (Red == VKR_XOR)
+	  vpar ^= x;
+	else if (Red == VKR_AND)
+	  vhit |= ~x;
+	else
+	  vhit |= x;
+      }
+
+      hit = VK_or<VB>(vhit);
+      par = VK_xor<VB>(vpar);
+      for (;i < wc;i++) {
+	ssword_t m = (i == wc-1) ? mask : SSWORDMASK;
+
+	hit |= ((Red == VKR_AND) ? ~b->one[i] : b->one[i]) & m;
+	par ^= b->one[i] & m;
+      }
+
+      if (Red == VKR_XOR)
+	hit = __builtin_parityll(par);
+      else if (Red == VKR_AND)
+	hit = !hit;
+      else
+	hit = (hit != 0);
+
+      if (hit != Neg)
+	Value_lone(r);
+      else
+	Value_zero(r);
+      return 0;
+    }
+
+    for (i = 0;i+W < wc;i += W) {
+      V f, x;
+
+      VK_load<VB>(f,b->flt+i);
+      VK_load<VB>(x,p+i);
+      vflt |= f;
+      if (Red == VKR_XOR)
+	vpar ^= x;
+      else
+	vhit |= x & ~f;
+    }
+
+    hit = VK_or<VB>(vhit);
+    flt = VK_or<VB>(vflt);
+    par = VK_xor<VB>(vpar);
+    for (;i < wc;i++) {
+      ssword_t m = (i == wc-1) ? mask : SSWORDMASK;
+
+      hit |= p[i] & ~b->flt[i] & m;
+      flt |= b->flt[i] & m;
+      par ^= b->one[i] & m;
+    }
+
+    if (Red == VKR_XOR) {
+      if (flt)
+	Value_unknown(r);
+      else if (__builtin_parityll(par) != Neg)
+	Value_lone(r);
+      else
+	Value_zero(r);
+    } else {
+      if (hit) {
+	if ((Red == VKR_OR) != Neg)
+	  Value_lone(r);
+	else
+	  Value_zero(r);
+      } else if (flt)
+	Value_unknown(r);
+      else if ((Red == VKR_AND) != Neg)
+	Value_lone(r);
+      else
+	Value_zero(r);
+    }
+
+    return 0;
+  }
+};
+
+/*
+ * Logical equality.  As in Value_eq(), the top word of the one planes is
+ * masked by the width of r.  The float planes of known operands are not
+ * read.
+ */
+template<int Neg> struct VKSEq {
+  template<int VB>
+  static VK_INLINE int run(Value *r,Value *a,Value *b,Value *c) {
+    typedef typename VKVec<VB>::vec_t V;
+    const int W = VB/sizeof(ssword_t);
+    int wc = SSNUMWORDS(a->nbits);
+    ssword_t mask = (a->nbits&SSBITMASK) ? LMASK(a->nbits&SSBITMASK) : SSWORDMASK;
+    ssword_t rmask = (r->nbits&SSBITMASK) ? LMASK(r->nbits&SSBITMASK) : SSWORDMASK;
+    V vdiff = {}, vflt = {};
+    ssword_t diff, flt;
+    int known;
+    int i;
+
+    r->flags = Value_opFlags(a,b);
+
+    if (a->nbits != b->nbits) {
+      Value_lone(r);
+      if (Neg) {
+	Value_lnot(r,0,r,0);
+	return 0;
+      }
+      return -1;
+    }
+
+    known = Value_opKnown2(a,b);
+    if (known) {
+      for (i = 0;i+W < wc;i += W) {
+	V a1, b1;
+
+	VK_load<VB>(a1,a->one+i);
+	VK_load<VB>(b1,b->one+i);
+	vdiff |= a1 ^ b1;
+      }
+    } else {
+      for (i = 0;i+W < wc;i += W) {
+	V af, bf, a1, b1;
+
+	VK_load<VB>(af,a->flt+i);
+	VK_load<VB>(bf,b->flt+i);
+	VK_load<VB>(a1,a->one+i);
+	VK_load<VB>(b1,b->one+i);
+	vflt |= af | bf;
+	vdiff |= a1 ^ b1;
+      }
+    }
+
+    diff = VK_or<VB>(vdiff);
+    flt = VK_or<VB>(vflt);
+    for (;i < wc;i++) {
+      if (i == wc-1) {
+	flt |= (a->flt[i] | b->flt[i]) & mask;
+	diff |= (a->one[i] ^ b->one[i]) & rmask;
+      } else {
+	flt |= a->flt[i] | b->flt[i];
+	diff |= a->one[i] ^ b->one[i];
+      }
+    }
+    if (known)
+      flt = 0;
+
+    if (flt)
+      Value_unknown(r);
+    else if (diff)
+      Value_zero(r);
+    else
+      Value_lone(r);
+
+    if (Neg)
+      Value_lnot(r,0,r,0);
+
+    return 0;
+  }
+};
+
+/*
+ * Case equality on operands of the same width.  Other widths are left to
+ * Value_caseEq(), which extends the narrower operand.  Like Value_caseEq(),
+ * the scan stops at the first vector with a difference, and only the one
+ * planes of known operands are compared.
+ */
+template<int Neg> struct VKSCaseEq {
+  template<int VB>
+  static VK_INLINE int run(Value *r,Value *a,Value *b,Value *c) {
+    typedef typename VKVec<VB>::vec_t V;
+    const int W = VB/sizeof(ssword_t);
+    int wc = SSNUMWORDS(a->nbits);
+    ssword_t mask = (a->nbits&SSBITMASK) ? LMASK(a->nbits&SSBITMASK) : SSWORDMASK;
+    V vdiff;
+    ssword_t diff;
+    int i;
+
+    if (a->nbits != b->nbits)
+      return Neg ? Value_caseNeq(r,a,b,c) : Value_caseEq(r,a,b,c);
+
+    if (Value_opKnown2(a,b)) {
+      for (i = 0;i+W < wc;i += W) {
+	V x, y;
+
+	VK_load<VB>(x,a->one+i);
+	VK_load<VB>(y,b->one+i);
+	vdiff = x ^ y;
+	if (VK_or<VB>(vdiff))
+	  break;
+      }
+
+      diff = (i+W < wc) ? 1 : 0;
+      for (;!diff && i < wc;i++) {
+	ssword_t m = (i == wc-1) ? mask : SSWORDMASK;
+
+	diff |= (a->one[i] ^ b->one[i]) & m;
+      }
+
+      if ((diff == 0) != Neg)
+	Value_lone(r);
+      else
+	Value_zero(r);
+
+      return 0;
+    }
+
+    for (i = 0;i+W < wc;i += W) {
+      VKPlanes<V> x, y;
+
+      VK_load<VB>(x.one,a->one+i);
+      VK_load<VB>(x.zero,a->zero+i);
+      VK_load<VB>(x.flt,a->flt+i);
+      VK_load<VB>(y.one,b->one+i);
+      VK_load<VB>(y.zero,b->zero+i);
+      VK_load<VB>(y.flt,b->flt+i);
+      vdiff = (x.one ^ y.one) | (x.zero ^ y.zero) | (x.flt ^ y.flt);
+      if (VK_or<VB>(vdiff))
+	break;
+    }
+
+    diff = (i+W < wc) ? 1 : 0;
+    for (;!diff && i < wc;i++) {
+      ssword_t m = (i == wc-1) ? mask : SSWORDMASK;
+
+      diff |= ((a->one[i] ^ b->one[i]) | (a->zero[i] ^ b->zero[i]) | (a->flt[i] ^ b->flt[i])) & m;
+    }
+
+    if ((diff == 0) != Neg)
+      Value_lone(r);
+    else
+      Value_zero(r);
+
+    return 0;
+  }
+};
+
+typedef VKSReduce<VKR_AND,0> VKSUand;
+typedef VKSReduce<VKR_OR,0> VKSUor;
+typedef VKSReduce<VKR_XOR,0> VKSUxor;
+typedef VKSReduce<VKR_AND,1> VKSUnand;
+typedef VKSReduce<VKR_OR,1> VKSUnor;
+typedef VKSReduce<VKR_XOR,1> VKSUnxor;
+
+/*
+ * Instruction set wrappers.  The kernel body is inlined into each wrapper
+ * and so compiled for the wrapper's target.
+ */
+template<class K> __attribute__((target("sse2")))
+static int Value_s_sse2(Value *R,Value *A,Value *B,Value *C)
+{
+  return K::template run<16>(R,A,B,C);
+}
+
+template<class K> __attribute__((target("avx2")))
+static int Value_s_avx2(Value *R,Value *A,Value *B,Value *C)
+{
+  return K::template run<32>(R,A,B,C);
+}
+
+template<class K> __attribute__((target("avx512f")))
+static int Value_s_avx512(Value *R,Value *A,Value *B,Value *C)
+{
+  return K::template run<64>(R,A,B,C);
+}
+
+#define VK_SIMD_KERNELS(k) {Value_s_sse2<k>, Value_s_avx2<k>, Value_s_avx512<k>}
+
+/*
+ * Vector kernels for each handler function, one for each instruction set
+ * from VKS_SSE2 up.
+ */
+static struct {
+  valueop_f	*vs_func;			/* Handler function */
+  valueop_f	*vs_kernel[VKS_MAX-1];		/* Kernel for each instruction set */
+} simdTable[] = {
+  {Value_and,		VK_SIMD_KERNELS(VKSBitwise<VKAnd>)},
+  {Value_nand,		VK_SIMD_KERNELS(VKSBitwise<VKNand>)},
+  {Value_or,		VK_SIMD_KERNELS(VKSBitwise<VKOr>)},
+  {Value_nor,		VK_SIMD_KERNELS(VKSBitwise<VKNor>)},
+  {Value_xor,		VK_SIMD_KERNELS(VKSBitwise<VKXor>)},
+  {Value_nxor,		VK_SIMD_KERNELS(VKSBitwise<VKNxor>)},
+  {Value_not,		VK_SIMD_KERNELS(VKSBitwise<VKNot>)},
+  {Value_buf,		VK_SIMD_KERNELS(VKSBitwise<VKBuf>)},
+
+  {Value_uand,		VK_SIMD_KERNELS(VKSUand)},
+  {Value_uor,		VK_SIMD_KERNELS(VKSUor)},
+  {Value_uxor,		VK_SIMD_KERNELS(VKSUxor)},
+  {Value_unand,		VK_SIMD_KERNELS(VKSUnand)},
+  {Value_unor,		VK_SIMD_KERNELS(VKSUnor)},
+  {Value_unxor,		VK_SIMD_KERNELS(VKSUnxor)},
+
+  {Value_eq,		VK_SIMD_KERNELS(VKSEq<0>)},
+  {Value_neq,		VK_SIMD_KERNELS(VKSEq<1>)},
+  {Value_caseEq,	VK_SIMD_KERNELS(VKSCaseEq<0>)},
+  {Value_caseNeq,	VK_SIMD_KERNELS(VKSCaseEq<1>)},
+};
+static int simdTable_size = sizeof(simdTable)/sizeof(simdTable[0]);
+
+static int simdLevel = -1;		/* Instruction set used by vector kernels */
+
+/*
+ * Best instruction set supported by the processor
+ */
+static int Value_simdSupported()
+{
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return VKS_AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return VKS_AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return VKS_SSE2;
+  return VKS_NONE;
+}
+
+#endif
+
+/*****************************************************************************
+ *
+ * Choose the instruction set for vector kernels
+ *
+ * Parameters:
+ *     name		One of "none", "sse2", "avx2" or "avx512"
+ *
+ * Returns:		0 on success, -1 if the name is not recognized.
+ *
+ * A set the processor does not support is replaced by the best one it does.
+ * On other than x86 processors there are no vector kernels and only the
+ * name is checked.
+ *
+ *****************************************************************************/
+int Value_setSimd(const char *name)
+{
+  static const char *names[] = {"none", "sse2", "avx2", "avx512"};
+  int i;
+
+  for (i = 0;i < 4;i++)
+    if (strcmp(name,names[i]) == 0)
+      break;
+  if (i == 4)
+    return -1;
+
+#if VK_SIMD
+  simdLevel = Value_simdSupported();
+  if (i < simdLevel)
+    simdLevel = i;
+#endif
+
+  return 0;
+}
+
+#define VK_ARITH(op,dword) {Value_k_arith<op,VK_BIT>, Value_k_arith<op,VK_WORD>, (dword) ? Value_k_arith<op,VK_DWORD> : 0}
+#define VK_BITWISE(op) {Value_k_bitwise<op,1>, Value_k_bitwise<op,1>, Value_k_bitwise<op,2>}
+
+/*
+ * Kernels for each handler function.  The word (_w_) functions only get
+ * kernels for the classes they are used on.
+ */
+static struct {
+  valueop_f	*vk_func;		/* Handler function */
+  valueop_f	*vk_kernel[VK_MAX];	/* Kernel for each width class */
+} kernelTable[] = {
+  {Value_and,	VK_BITWISE(VKAnd)},
+  {Value_nand,	VK_BITWISE(VKNand)},
+  {Value_or,	VK_BITWISE(VKOr)},
+  {Value_nor,	VK_BITWISE(VKNor)},
+  {Value_xor,	VK_BITWISE(VKXor)},
+  {Value_nxor,	VK_BITWISE(VKNxor)},
+  {Value_not,	VK_BITWISE(VKNot)},
+  {Value_w_not,	VK_BITWISE(VKNot)},
+  {Value_buf,	VK_BITWISE(VKBuf)},
+
+  {Value_add,	VK_ARITH(VKAdd,1)},
+  {Value_w_add,	VK_ARITH(VKAdd,0)},
+  {Value_sub,	VK_ARITH(VKSub,1)},
+  {Value_w_sub,	VK_ARITH(VKSub,0)},
+  {Value_gt,	VK_ARITH(VKGt,1)},
+  {Value_w_gt,	VK_ARITH(VKGt,0)},
+  {Value_lt,	VK_ARITH(VKLt,1)},
+  {Value_w_lt,	VK_ARITH(VKLt,0)},
+  {Value_ge,	VK_ARITH(VKGe,1)},
+  {Value_w_ge,	VK_ARITH(VKGe,0)},
+  {Value_le,	VK_ARITH(VKLe,1)},
+  {Value_w_le,	VK_ARITH(VKLe,0)},
+};
+static int kernelTable_size = sizeof(kernelTable)/sizeof(kernelTable[0]);
+
+/*****************************************************************************
+ *
+ * Select a width-specialized kernel for an operation
+ *
+ * Parameters:
+ *     func		Handler function for the operation
+ *     r		Return value
+ *     a,b,c		Operands (unused operands are null)
+ *
+ * Returns:		Kernel to use in place of func, or func if there is none.
+ *
+ *****************************************************************************/
+valueop_f *Value_kernel(valueop_f *func,Value *r,Value *a,Value *b,Value *c)
+{
+  Value *v[4];
+  int maxbits = 0;
+  int minopbits = -1;
+  int minwc = 3, maxwc = 0;
+  int vk;
+  int i;
+
+  v[0] = r; v[1] = a; v[2] = b; v[3] = c;
+  for (i = 0;i < 4;i++) {
+    int wc;
+
+    if (!v[i]) continue;
+    if ((v[i]->flags & SF_REAL))
+      return func;
+
+    wc = SSNUMWORDS(v[i]->nbits);
+    if (v[i]->nbits > maxbits) maxbits = v[i]->nbits;
+    if (wc < minwc) minwc = wc;
+    if (wc > maxwc) maxwc = wc;
+    if (i > 0 && (minopbits < 0 || v[i]->nbits < minopbits)) minopbits = v[i]->nbits;
+  }
+
+  if (maxbits == 1)
+    vk = VK_BIT;
+  else if (maxwc == 1)
+    vk = VK_WORD;
+  else if (minwc == 2 && maxwc == 2)
+    vk = VK_DWORD;
+  else {
+#if VK_SIMD
+    /*
+     * Operands wide enough for the vector kernels
+     */
+    if (minopbits >= THYMEVALUE_SIMDBITS) {
+      if (simdLevel < 0)
+	simdLevel = Value_simdSupported();
+      if (simdLevel == VKS_NONE)
+	return func;
+
+      for (i = 0;i < simdTable_size;i++) {
+	if (simdTable[i].vs_func == func)
+	  return simdTable[i].vs_kernel[simdLevel-1];
+      }
+    }
+#endif
+    return func;
+  }
+
+  for (i = 0;i < kernelTable_size;i++) {
+    if (kernelTable[i].vk_func == func)
+      return kernelTable[i].vk_kernel[vk] ? kernelTable[i].vk_kernel[vk] : func;
+  }
+
+  return func;
+}
+
+/*****************************************************************************
+ *
+ * Get the handler function a kernel was selected for
+ *
+ * Parameters:
+ *     func		Kernel or handler function
+ *
+ * Returns:		Handler function that func replaces, or func itself.
+ *
+ *****************************************************************************/
+valueop_f *Value_kernelBase(valueop_f *func)
+{
+  int i, j;
+
+  for (i = 0;i < kernelTable_size;i++)
+    for (j = 0;j < VK_MAX;j++)
+      if (kernelTable[i].vk_kernel[j] == func)
+	return kernelTable[i].vk_func;
+
+#if VK_SIMD
+  for (i = 0;i < simdTable_size;i++)
+    for (j = 0;j < VKS_MAX-1;j++)
+      if (simdTable[i].vs_kernel[j] == func)
+	return simdTable[i].vs_func;
+#endif
+
+  return func;
+}
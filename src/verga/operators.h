@@ -119,4 +119,19 @@ int Value_f_neg(Value *r,Value *a,Value *b,Value *c);
 int Value_f_caseEq(Value *r,Value *a,Value *b,Value *c);
 int Value_f_caseNeq(Value *r,Value *a,Value *b,Value *c);
 
+/*****************************************************************************
+ * Width-specialized kernels
+ *
+ *****************************************************************************/
+valueop_f *Value_kernel(valueop_f *func,Value *r,Value *a,Value *b,Value *c);
+valueop_f *Value_kernelBase(valueop_f *func);
+int Value_setSimd(const char *name);
+
+/*
+ * Operator calls that tested their operands for x and z bits, and those of
+ * them decided by SF_KNOWN without a scan
+ */
+extern thread_local unsigned long long Value_opCalls;
+extern thread_local unsigned long long Value_opFast;
+
 #endif
@@ -0,0 +1,994 @@
+/****************************************************************************
+    Copyright (C) 1987-2015 by Jeffery P. Hansen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+****************************************************************************/
+#include <cstdlib>
+
+#include "verga.hpp"
+
+/*****************************************************************************
+ *
+ * This file implements the bytecode optimizer.  The optimizer is run on each
+ * CodeBlock when it is closed, before the block is converted to threaded
+ * code.  Optimization level 1 removes BCNoop instructions and threads BCGoto
+ * chains.  Level 2 also folds operations on constants and parameters,
+ * propagates copies and removes computations of temporaries that are never
+ * used.
+ *
+ * A Value is treated as a constant if it is not a net value (or it is the
+ * value of a parameter) and no instruction in the block writes it.  A Value
+ * is a temporary if it is not a net value.  Values passed to system tasks
+ * and semaphore values are never optimized.
+ *
+ * Instructions that are copied into other blocks (for task contexts) and the
+ * instructions used by a BCGate are left alone.  Branch targets in the block
+ * and in its copies, thread start offsets and user task offsets are updated
+ * after instructions are removed.
+ *
+ *****************************************************************************/
+
+/*
+ * Instruction kinds recognized by the optimizer.
+ */
+enum {
+  OK_UNKNOWN = 0,
+  OK_END,
+  OK_NOOP,
+  OK_OPR,
+  OK_COPY,
+  OK_COPYRANGE,
+  OK_ASGN,
+  OK_RAISE,
+  OK_NBASGND,
+  OK_NBASGNE,
+  OK_WIREASGND,
+  OK_GOTO,
+  OK_SPAWN,
+  OK_WAIT,
+  OK_TASK,
+  OK_DELAY,
+  OK_TRIGGER,
+  OK_LOCK,
+  OK_MEMFETCH,
+  OK_MEMPUT,
+  OK_NBMEMPUTD,
+  OK_NBMEMPUTE,
+  OK_SUBR,
+  OK_RETURN,
+  OK_DEBUGPRINT,
+  OK_GATE
+};
+
+static struct {
+  BCfunc	*ok_func;	/* Handler function */
+  int		ok_kind;	/* Instruction kind */
+} opt_kinds[] = {
+  {(BCfunc*) BCEnd_exec,	OK_END},
+  {(BCfunc*) BCNoop_exec,	OK_NOOP},
+  {(BCfunc*) BCOpr_exec,	OK_OPR},
+  {(BCfunc*) BCCopy_exec,	OK_COPY},
+  {(BCfunc*) BCCopyRange_exec,	OK_COPYRANGE},
+  {(BCfunc*) BCAsgn_exec,	OK_ASGN},
+  {(BCfunc*) BCRaise_exec,	OK_RAISE},
+  {(BCfunc*) BCNbAsgnD_exec,	OK_NBASGND},
+  {(BCfunc*) BCNbAsgnE_exec,	OK_NBASGNE},
+  {(BCfunc*) BCWireAsgnD_exec,	OK_WIREASGND},
+  {(BCfunc*) BCGoto_exec,	OK_GOTO},
+  {(BCfunc*) BCSpawn_exec,	OK_SPAWN},
+  {(BCfunc*) BCWait_exec,	OK_WAIT},
+  {(BCfunc*) BCTask_exec,	OK_TASK},
+  {(BCfunc*) BCDelay_exec,	OK_DELAY},
+  {(BCfunc*) BCTrigger_exec,	OK_TRIGGER},
+  {(BCfunc*) BCLock_exec,	OK_LOCK},
+  {(BCfunc*) BCMemFetch_exec,	OK_MEMFETCH},
+  {(BCfunc*) BCMemPut_exec,	OK_MEMPUT},
+  {(BCfunc*) BCNbMemPutD_exec,	OK_NBMEMPUTD},
+  {(BCfunc*) BCNbMemPutE_exec,	OK_NBMEMPUTE},
+  {(BCfunc*) BCSubr_exec,	OK_SUBR},
+  {(BCfunc*) BCReturn_exec,	OK_RETURN},
+  {(BCfunc*) BCDebugPrint_exec,	OK_DEBUGPRINT},
+  {(BCfunc*) BCGate_exec,	OK_GATE},
+  {(BCfunc*) BCGate1_exec,	OK_GATE},
+};
+static int opt_kinds_len = sizeof(opt_kinds)/sizeof(opt_kinds[0]);
+
+/*
+ * Instruction flags
+ */
+#define OF_REMOVED	0x1	/* Instruction has been removed */
+#define OF_PINNED	0x2	/* Instruction may not be removed or rewritten */
+#define OF_ENTRY	0x4	/* Instruction can be reached other than from the previous one */
+
+/*
+ * Usage of a Value in a block
+ */
+typedef struct {
+  int		ov_writers;	/* Number of instructions writing the value */
+  int		ov_readers;	/* Number of operands reading the value */
+  int		ov_pinned;	/* Value is used where it can not be analyzed */
+} OptValue;
+
+/*
+ * Optimization statistics for a module
+ */
+typedef struct {
+  ModuleDecl	*os_module;	/* Module declaration */
+  unsigned	os_instances;	/* Number of instances */
+  unsigned	os_before;	/* Instructions before optimization */
+  unsigned	os_after;	/* Instructions after optimization */
+  unsigned	os_noops;	/* BCNoops removed */
+  unsigned	os_jumps;	/* BCGotos retargeted or removed */
+  unsigned	os_folded;	/* Operations and branches folded */
+  unsigned	os_copies;	/* Copies propagated */
+  unsigned	os_dead;	/* Dead temporaries removed */
+} OptStats;
+
+/*
+ * State of the optimizer for one block
+ */
+typedef struct {
+  CodeBlock	*o_cb;		/* Block being optimized */
+  unsigned	o_n;		/* Number of instructions in block */
+  unsigned char	*o_kind;	/* Kind of each instruction */
+  unsigned char	*o_flags;	/* Flags for each instruction */
+  PHash		o_values;	/* Usage of each Value (OptValue) */
+  OptStats	*o_stats;	/* Statistics for module */
+  int		o_changed;	/* Non-zero if the last pass changed anything */
+} Optimizer;
+
+static int opt_level = 2;		/* Optimization level */
+static PHash opt_statsTable;		/* Statistics by module declaration */
+static List opt_statsList;		/* Statistics in order of first instance */
+static int opt_statsInit = 0;
+
+/*****************************************************************************
+ *
+ * Set the optimization level for code blocks
+ *
+ * Parameters:
+ *     level		0 for no optimization, 1 to remove BCNoops and thread
+ *			BCGoto chains, 2 to also fold constants, propagate
+ *			copies and remove dead temporaries.
+ *
+ * This must be set before any code blocks are closed.
+ *
+ *****************************************************************************/
+void ByteCode_setOptLevel(int level)
+{
+  opt_level = level;
+}
+
+/*****************************************************************************
+ *
+ * Print optimization statistics for each module
+ *
+ *****************************************************************************/
+void ByteCode_printOptStats(void)
+{
+  ListElem *le;
+
+  printf("%-16s %9s %8s %8s %6s %6s %6s %6s %6s\n","module","instances",
+	 "before","after","noops","jumps","folded","copies","dead");
+  if (!opt_statsInit) return;
+
+  for (le = List_first(&opt_statsList);le;le = List_next(&opt_statsList,le)) {
+    OptStats *os = (OptStats*) ListElem_obj(le);
+
+    printf("%-16s %9u %8u %8u %6u %6u %6u %6u %6u\n",os->os_module->name(),
+	   os->os_instances,os->os_before,os->os_after,os->os_noops,
+	   os->os_jumps,os->os_folded,os->os_copies,os->os_dead);
+  }
+}
+
+/*****************************************************************************
+ *
+ * Get the statistics record for a module
+ *
+ *****************************************************************************/
+static OptStats *OptStats_find(ModuleDecl *m)
+{
+  OptStats *os;
+
+  if (!opt_statsInit) {
+    PHash_init(&opt_statsTable);
+    List_init(&opt_statsList);
+    opt_statsInit = 1;
+  }
+
+  os = (OptStats*) PHash_find(&opt_statsTable,m);
+  if (!os) {
+    os = (OptStats*) calloc(1,sizeof(OptStats));
+    os->os_module = m;
+    PHash_insert(&opt_statsTable,m,os);
+    List_addToTail(&opt_statsList,os);
+  }
+
+  return os;
+}
+
+/*****************************************************************************
+ *
+ * Return the kind of an instruction
+ *
+ *****************************************************************************/
+static int Opt_kind(ByteCode *bc)
+{
+  int i;
+
+  for (i = 0;i < opt_kinds_len;i++)
+    if (opt_kinds[i].ok_func == bc->bc_func)
+      return opt_kinds[i].ok_kind;
+
+  return OK_UNKNOWN;
+}
+
+/*****************************************************************************
+ *
+ * Get the Value operands read by an instruction
+ *
+ * Parameters:
+ *     bc		Instruction
+ *     kind		Kind of instruction
+ *     slots		Array in which to return pointers to the operands
+ *
+ * Returns:		Number of operands
+ *
+ * Operands of system tasks and semaphores are not included.
+ *
+ *****************************************************************************/
+static int Opt_reads(ByteCode *bc,int kind,Value **slots[4])
+{
+  int n = 0;
+  int i;
+
+  switch (kind) {
+  case OK_OPR :
+    for (i = 0;i < 3;i++)
+      if (bc->bc_opr.o_opr[i]) slots[n++] = &bc->bc_opr.o_opr[i];
+    break;
+  case OK_COPY :
+    slots[n++] = &bc->bc_copy.c_src;
+    break;
+  case OK_COPYRANGE :
+    slots[n++] = &bc->bc_copyrange.r_src;
+    if (bc->bc_copyrange.r_sLsb) slots[n++] = &bc->bc_copyrange.r_sLsb;
+    break;
+  case OK_MEMFETCH :
+    slots[n++] = &bc->bc_memfetch.m_addr;
+    break;
+  case OK_MEMPUT :
+    slots[n++] = &bc->bc_memput.m_addr;
+    if (bc->bc_memput.m_netLsb) slots[n++] = &bc->bc_memput.m_netLsb;
+    slots[n++] = &bc->bc_memput.m_data;
+    break;
+  case OK_NBMEMPUTD :
+    slots[n++] = &bc->bc_nbmemputd.m_addr;
+    if (bc->bc_nbmemputd.m_netLsb) slots[n++] = &bc->bc_nbmemputd.m_netLsb;
+    slots[n++] = &bc->bc_nbmemputd.m_data;
+    break;
+  case OK_NBMEMPUTE :
+    slots[n++] = &bc->bc_nbmempute.m_addr;
+    if (bc->bc_nbmempute.m_netLsb) slots[n++] = &bc->bc_nbmempute.m_netLsb;
+    slots[n++] = &bc->bc_nbmempute.m_data;
+    break;
+  case OK_ASGN :
+    slots[n++] = &bc->bc_asgn.a_value;
+    if (bc->bc_asgn.a_netLsb) slots[n++] = &bc->bc_asgn.a_netLsb;
+    break;
+  case OK_NBASGND :
+    slots[n++] = &bc->bc_nbasgnd.a_value;
+    if (bc->bc_nbasgnd.a_netLsb) slots[n++] = &bc->bc_nbasgnd.a_netLsb;
+    break;
+  case OK_NBASGNE :
+    slots[n++] = &bc->bc_nbasgne.a_value;
+    if (bc->bc_nbasgne.a_netLsb) slots[n++] = &bc->bc_nbasgne.a_netLsb;
+    break;
+  case OK_WIREASGND :
+    slots[n++] = &bc->bc_wireasgnd.a_value;
+    if (bc->bc_wireasgnd.a_netLsb) slots[n++] = &bc->bc_wireasgnd.a_netLsb;
+    break;
+  case OK_GOTO :
+    if (bc->bc_goto.g_cond) slots[n++] = &bc->bc_goto.g_cond;
+    break;
+  }
+
+  return n;
+}
+
+/*****************************************************************************
+ *
+ * Get the Value written by an instruction
+ *
+ * Parameters:
+ *     bc		Instruction
+ *     kind		Kind of instruction
+ *
+ * Returns:		Value written or null if the instruction does not write
+ *			a Value directly.
+ *
+ *****************************************************************************/
+static Value *Opt_dest(ByteCode *bc,int kind)
+{
+  switch (kind) {
+  case OK_OPR :		return bc->bc_opr.o_dest;
+  case OK_COPY :	return bc->bc_copy.c_dst;
+  case OK_COPYRANGE :	return bc->bc_copyrange.r_dst;
+  case OK_MEMFETCH :	return bc->bc_memfetch.m_data;
+  }
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Return non-zero if an instruction may change nets or simulation state, or
+ * transfer control.  Only sequences of instructions without barriers are
+ * considered for propagation of copies from nets.
+ *
+ *****************************************************************************/
+static int Opt_isBarrier(int kind)
+{
+  switch (kind) {
+  case OK_NOOP :
+  case OK_OPR :
+  case OK_COPY :
+  case OK_COPYRANGE :
+  case OK_MEMFETCH :
+    return 0;
+  }
+  return 1;
+}
+
+/*****************************************************************************
+ *
+ * Return non-zero if an instruction uses its operands only while it is
+ * executed, so that operands can be replaced by equivalent Values.
+ *
+ *****************************************************************************/
+static int Opt_isRewritable(int kind)
+{
+  switch (kind) {
+  case OK_OPR :
+  case OK_COPY :
+  case OK_COPYRANGE :
+  case OK_MEMFETCH :
+  case OK_MEMPUT :
+  case OK_ASGN :
+  case OK_GOTO :
+    return 1;
+  }
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Get the usage record for a Value
+ *
+ *****************************************************************************/
+static OptValue *Opt_value(Optimizer *o,Value *v)
+{
+  OptValue *ov = (OptValue*) PHash_find(&o->o_values,v);
+
+  if (!ov) {
+    ov = (OptValue*) calloc(1,sizeof(OptValue));
+    PHash_insert(&o->o_values,v,ov);
+  }
+
+  return ov;
+}
+
+/*****************************************************************************
+ *
+ * Return non-zero if a Value is a constant in the block being optimized.  A
+ * missing operand is also treated as a constant.
+ *
+ *****************************************************************************/
+static int Opt_isConst(Optimizer *o,Value *v)
+{
+  OptValue *ov;
+
+  if (!v) return 1;
+  if ((Value_getAllFlags(v) & (SF_NETVAL|SF_PARAM)) == SF_NETVAL) return 0;
+
+  ov = Opt_value(o,v);
+  return !ov->ov_writers && !ov->ov_pinned;
+}
+
+/*****************************************************************************
+ *
+ * Return non-zero if a Value is a temporary that may be optimized.
+ *
+ *****************************************************************************/
+static int Opt_isTemp(Optimizer *o,Value *v)
+{
+  if (!v || (Value_getAllFlags(v) & SF_NETVAL)) return 0;
+
+  return !Opt_value(o,v)->ov_pinned;
+}
+
+/*****************************************************************************
+ *
+ * Return non-zero if an instruction is an unconditional jump within the
+ * block being optimized.
+ *
+ *****************************************************************************/
+static int Opt_isJump(Optimizer *o,unsigned i)
+{
+  BCGoto *g = &CodeBlock_get(o->o_cb,i)->bc_goto;
+
+  return o->o_kind[i] == OK_GOTO && !g->g_cond && !g->g_neg && g->g_block == o->o_cb;
+}
+
+/*****************************************************************************
+ *
+ * Return the first instruction at or after i that has not been removed
+ *
+ *****************************************************************************/
+static unsigned Opt_skip(Optimizer *o,unsigned i)
+{
+  while (i < o->o_n && (o->o_flags[i] & OF_REMOVED))
+    i++;
+  return i;
+}
+
+/*****************************************************************************
+ *
+ * Find where control ends up after a branch to an instruction
+ *
+ * Parameters:
+ *     o		Optimizer
+ *     i		Branch target
+ *
+ * Returns:		First instruction at or after i that has not been removed,
+ *			following any unconditional jumps.
+ *
+ *****************************************************************************/
+static unsigned Opt_resolve(Optimizer *o,unsigned i)
+{
+  unsigned first = Opt_skip(o,i);
+  unsigned steps;
+
+  i = first;
+  for (steps = 0;i < o->o_n && Opt_isJump(o,i);steps++) {
+    if (steps >= o->o_n) return first;		/* Loop of jumps */
+    i = Opt_skip(o,CodeBlock_get(o->o_cb,i)->bc_goto.g_offset);
+  }
+
+  return i;
+}
+
+/*****************************************************************************
+ *
+ * Remove an instruction and update the usage of its Values
+ *
+ *****************************************************************************/
+static void Opt_remove(Optimizer *o,unsigned i)
+{
+  ByteCode *bc = CodeBlock_get(o->o_cb,i);
+  Value **slots[4];
+  Value *dest;
+  int n,j;
+
+  n = Opt_reads(bc,o->o_kind[i],slots);
+  for (j = 0;j < n;j++)
+    Opt_value(o,*slots[j])->ov_readers--;
+  if ((dest = Opt_dest(bc,o->o_kind[i])))
+    Opt_value(o,dest)->ov_writers--;
+
+  o->o_flags[i] |= OF_REMOVED;
+  o->o_changed = 1;
+}
+
+/*****************************************************************************
+ *
+ * Mark an instruction in the block as an entry point
+ *
+ *****************************************************************************/
+static void Opt_markEntry(Optimizer *o,unsigned i)
+{
+  if (i < o->o_n)
+    o->o_flags[i] |= OF_ENTRY;
+}
+
+/*****************************************************************************
+ *
+ * Mark branch targets in a block that are in the block being optimized
+ *
+ * Parameters:
+ *     o		Optimizer
+ *     cb		Block being optimized or one of its copies
+ *     offset		Offset in the block being optimized of instruction 0
+ *
+ *****************************************************************************/
+static void Opt_markTargets(Optimizer *o,CodeBlock *cb,int offset)
+{
+  int i;
+
+  for (i = 0;i < cb->size();i++) {
+    ByteCode *bc = CodeBlock_get(cb,i);
+
+    switch (o->o_kind[i+offset]) {
+    case OK_GOTO :
+      if (bc->bc_goto.g_block == o->o_cb)
+	Opt_markEntry(o,bc->bc_goto.g_offset);
+      break;
+    case OK_SPAWN :
+      if (bc->bc_spawn.s_block == o->o_cb)
+	Opt_markEntry(o,bc->bc_spawn.s_offset);
+      break;
+    case OK_SUBR :
+      if (bc->bc_subr.s_block == o->o_cb)
+	Opt_markEntry(o,bc->bc_subr.s_offset);
+      Opt_markEntry(o,i+offset+1);
+      break;
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * Classify the instructions in the block and find the use of each Value
+ *
+ * Returns:		Non-zero if the block contains instructions that can
+ *			not be analyzed.
+ *
+ *****************************************************************************/
+static int Opt_scan(Optimizer *o)
+{
+  CodeBlock *cb = o->o_cb;
+  ModuleInst *mi = cb->module();
+  ListElem *le;
+  HashElem *he;
+  unsigned i;
+
+  for (i = 0;i < o->o_n;i++) {
+    ByteCode *bc = CodeBlock_get(cb,i);
+    Value **slots[4];
+    Value *dest;
+    int n,j;
+
+    o->o_kind[i] = Opt_kind(bc);
+    switch (o->o_kind[i]) {
+    case OK_UNKNOWN :
+      return -1;
+    case OK_TASK :
+      if (bc->bc_task.t_rvalue)
+	Opt_value(o,bc->bc_task.t_rvalue)->ov_writers++;
+      for (j = 0;j < bc->bc_task.t_numArgs;j++) {
+	OptValue *ov = Opt_value(o,(Value*)bc->bc_task.t_args[j]);
+
+	ov->ov_writers++;
+	ov->ov_readers++;
+	ov->ov_pinned = 1;
+      }
+      break;
+    case OK_LOCK :
+      {
+	OptValue *ov = Opt_value(o,bc->bc_lock.l_value);
+
+	ov->ov_writers++;
+	ov->ov_readers++;
+	ov->ov_pinned = 1;
+      }
+      break;
+    case OK_GATE :
+      for (j = bc->bc_gate.g_neval + bc->bc_gate.g_nasgn + 1;j >= 0;j--)
+	o->o_flags[i-j] |= OF_PINNED;
+      break;
+    }
+
+    n = Opt_reads(bc,o->o_kind[i],slots);
+    for (j = 0;j < n;j++)
+      Opt_value(o,*slots[j])->ov_readers++;
+    if ((dest = Opt_dest(bc,o->o_kind[i])))
+      Opt_value(o,dest)->ov_writers++;
+  }
+
+  /*
+   * Instructions copied into other blocks must stay as they are.
+   */
+  for (le = List_first(&cb->cb_copies);le;le = List_next(&cb->cb_copies,le)) {
+    CodeBlock *copy = (CodeBlock*) ListElem_obj(le);
+
+    for (i = 0;i < (unsigned)copy->size();i++)
+      o->o_flags[i+copy->cb_copyOffset] |= OF_PINNED;
+    Opt_markTargets(o,copy,copy->cb_copyOffset);
+  }
+  Opt_markTargets(o,cb,0);
+
+  if (mi) {
+    for (le = List_first(&mi->_threads);le;le = List_next(&mi->_threads,le)) {
+      VGThread *t = (VGThread*) ListElem_obj(le);
+
+      if (t->t_start_block == cb)
+	Opt_markEntry(o,t->t_start_pc);
+    }
+    for (he = Hash_first(&mi->mc_scope.s_tasks);he;he = Hash_next(&mi->mc_scope.s_tasks,he)) {
+      UserTask *ut = (UserTask*) HashElem_obj(he);
+
+      if (ut->ut_block == cb)
+	Opt_markEntry(o,ut->ut_offset);
+    }
+  }
+
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Fold an operation, copy or branch on constant operands
+ *
+ * Returns:		Non-zero if the instruction was folded.
+ *
+ *****************************************************************************/
+static int Opt_fold(Optimizer *o,unsigned i)
+{
+  ByteCode *bc = CodeBlock_get(o->o_cb,i);
+  Value *dest = Opt_dest(bc,o->o_kind[i]);
+
+  switch (o->o_kind[i]) {
+  case OK_OPR :
+    {
+      BCOpr *op = &bc->bc_opr;
+
+      if (!Opt_isTemp(o,dest) || Opt_value(o,dest)->ov_writers != 1)
+	return 0;
+      if (!Opt_isConst(o,op->o_opr[0]) || !Opt_isConst(o,op->o_opr[1])
+	  || !Opt_isConst(o,op->o_opr[2]))
+	return 0;
+
+      (*op->o_op)(op->o_dest,op->o_opr[0],op->o_opr[1],op->o_opr[2]);
+      Opt_remove(o,i);
+    }
+    return 1;
+  case OK_COPY :
+    if (!Opt_isTemp(o,dest) || Opt_value(o,dest)->ov_writers != 1)
+      return 0;
+    if (!Opt_isConst(o,bc->bc_copy.c_src))
+      return 0;
+
+    BCCopy_copy(&bc->bc_copy);
+    Opt_remove(o,i);
+    return 1;
+  case OK_GOTO :
+    {
+      BCGoto *g = &bc->bc_goto;
+      int doskip;
+
+      if (!g->g_cond || !Opt_isConst(o,g->g_cond))
+	return 0;
+
+      doskip = Value_isZero(g->g_cond) || !Value_isLogic(g->g_cond);
+      if (g->g_neg) doskip = !doskip;
+
+      if (doskip)
+	Opt_remove(o,i);
+      else {
+	Opt_value(o,g->g_cond)->ov_readers--;
+	g->g_cond = 0;
+	g->g_neg = 0;
+	o->o_changed = 1;
+      }
+    }
+    return 1;
+  }
+
+  return 0;
+}
+
+/*****************************************************************************
+ *
+ * Propagate the source of a copy to the instructions reading its destination
+ *
+ * Returns:		Non-zero if the copy was removed.
+ *
+ * The copy is removed if every read of the destination follows the copy
+ * without any intervening entry point, write of the source or barrier
+ * instruction.  A BCGoto that is not taken does not change anything, so
+ * reads after a conditional branch can be replaced.
+ *
+ *****************************************************************************/
+static int Opt_propagate(Optimizer *o,unsigned i)
+{
+  BCCopy *c = &CodeBlock_get(o->o_cb,i)->bc_copy;
+  Value *dst = c->c_dst;
+  Value *src = c->c_src;
+  OptValue *ov_dst,*ov_src;
+  int found = 0;
+  unsigned j;
+
+  if (src == dst || Value_nbits(src) != Value_nbits(dst)) return 0;
+  if (!Opt_isTemp(o,dst)) return 0;
+  ov_dst = Opt_value(o,dst);
+  ov_src = Opt_value(o,src);
+  if (ov_dst->ov_writers != 1 || ov_src->ov_pinned) return 0;
+
+  /*
+   * Count the reads of dst that can be replaced.
+   */
+  for (j = i+1;j < o->o_n && found < ov_dst->ov_readers;j++) {
+    ByteCode *bc = CodeBlock_get(o->o_cb,j);
+    Value **slots[4];
+    int n,k;
+
+    if ((o->o_flags[j] & OF_ENTRY)) break;
+    if ((o->o_flags[j] & OF_REMOVED)) continue;
+    if (Opt_dest(bc,o->o_kind[j]) == src) break;
+
+    n = Opt_reads(bc,o->o_kind[j],slots);
+    for (k = 0;k < n;k++) {
+      if (*slots[k] != dst) continue;
+      if (!Opt_isRewritable(o->o_kind[j]) || (o->o_flags[j] & OF_PINNED))
+	return 0;
+      found++;
+    }
+
+    if (Opt_isBarrier(o->o_kind[j]) && o->o_kind[j] != OK_GOTO)
+      break;
+  }
+  if (found != ov_dst->ov_readers)
+    return 0;
+
+  /*
+   * Replace them.
+   */
+  for (j = i+1;found > 0;j++) {
+    ByteCode *bc = CodeBlock_get(o->o_cb,j);
+    Value **slots[4];
+    int n,k;
+
+    if ((o->o_flags[j] & OF_REMOVED)) continue;
+
+    n = Opt_reads(bc,o->o_kind[j],slots);
+    for (k = 0;k < n;k++) {
+      if (*slots[k] != dst) continue;
+      *slots[k] = src;
+      ov_dst->ov_readers--;
+      ov_src->ov_readers++;
+      found--;
+    }
+  }
+
+  Opt_remove(o,i);
+  return 1;
+}
+
+/*****************************************************************************
+ *
+ * Run the dataflow optimizations until nothing changes
+ *
+ *****************************************************************************/
+static void Opt_dataflow(Optimizer *o)
+{
+  unsigned i;
+
+  do {
+    o->o_changed = 0;
+    for (i = 0;i < o->o_n;i++) {
+      ByteCode *bc = CodeBlock_get(o->o_cb,i);
+      Value *dest;
+
+      if ((o->o_flags[i] & (OF_REMOVED|OF_PINNED))) continue;
+
+      if (Opt_fold(o,i)) {
+	o->o_stats->os_folded++;
+	continue;
+      }
+
+      if (o->o_kind[i] == OK_COPY && Opt_propagate(o,i)) {
+	o->o_stats->os_copies++;
+	continue;
+      }
+
+      switch (o->o_kind[i]) {
+      case OK_OPR :
+      case OK_COPY :
+      case OK_COPYRANGE :
+	dest = Opt_dest(bc,o->o_kind[i]);
+	if (Opt_isTemp(o,dest) && Opt_value(o,dest)->ov_readers == 0) {
+	  Opt_remove(o,i);
+	  o->o_stats->os_dead++;
+	}
+	break;
+      }
+    }
+  } while (o->o_changed);
+}
+
+/*****************************************************************************
+ *
+ * Remove BCNoops and jumps to the next instruction
+ *
+ *****************************************************************************/
+static void Opt_jumps(Optimizer *o)
+{
+  unsigned i;
+
+  for (i = 0;i < o->o_n;i++) {
+    if (o->o_kind[i] == OK_NOOP && !(o->o_flags[i] & (OF_REMOVED|OF_PINNED))) {
+      Opt_remove(o,i);
+      o->o_stats->os_noops++;
+    }
+  }
+
+  do {
+    o->o_changed = 0;
+    for (i = 0;i < o->o_n;i++) {
+      if ((o->o_flags[i] & (OF_REMOVED|OF_PINNED)) || !Opt_isJump(o,i)) continue;
+
+      if (Opt_resolve(o,CodeBlock_get(o->o_cb,i)->bc_goto.g_offset) == Opt_resolve(o,i+1)) {
+	Opt_remove(o,i);
+	o->o_stats->os_jumps++;
+      }
+    }
+  } while (o->o_changed);
+}
+
+/*****************************************************************************
+ *
+ * Retarget branches in the block or one of its copies past any chain of
+ * unconditional jumps
+ *
+ * Parameters:
+ *     o		Optimizer
+ *     cb		Block being optimized or one of its copies
+ *     offset		Offset in the block being optimized of instruction 0
+ *
+ *****************************************************************************/
+static void Opt_thread(Optimizer *o,CodeBlock *cb,int offset)
+{
+  int i;
+
+  for (i = 0;i < cb->size();i++) {
+    BCGoto *g = &CodeBlock_get(cb,i)->bc_goto;
+    unsigned target;
+
+    if (o->o_kind[i+offset] != OK_GOTO || g->g_block != o->o_cb) continue;
+    if (cb == o->o_cb && (o->o_flags[i] & OF_REMOVED)) continue;
+
+    target = Opt_resolve(o,g->g_offset);
+    if (cb == o->o_cb && target != Opt_skip(o,g->g_offset))
+      o->o_stats->os_jumps++;
+    g->g_offset = target;
+  }
+}
+
+/*****************************************************************************
+ *
+ * Update offsets of branches in the block or one of its copies
+ *
+ * Parameters:
+ *     o		Optimizer
+ *     cb		Block being optimized or one of its copies
+ *     offset		Offset in the block being optimized of instruction 0
+ *     map		New offset of each instruction
+ *
+ *****************************************************************************/
+static void Opt_relocate(Optimizer *o,CodeBlock *cb,int offset,unsigned *map)
+{
+  int i;
+
+  for (i = 0;i < cb->size();i++) {
+    ByteCode *bc = CodeBlock_get(cb,i);
+
+    switch (o->o_kind[i+offset]) {
+    case OK_GOTO :
+      if (bc->bc_goto.g_block == o->o_cb)
+	bc->bc_goto.g_offset = map[bc->bc_goto.g_offset];
+      break;
+    case OK_SPAWN :
+      if (bc->bc_spawn.s_block == o->o_cb)
+	bc->bc_spawn.s_offset = map[bc->bc_spawn.s_offset];
+      break;
+    case OK_SUBR :
+      if (bc->bc_subr.s_block == o->o_cb)
+	bc->bc_subr.s_offset = map[bc->bc_subr.s_offset];
+      break;
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * Optimize the instructions in a CodeBlock
+ *
+ * This is called when the block is closed.  Instructions that are removed
+ * are deleted from the block, and all offsets into the block are updated.
+ *
+ *****************************************************************************/
+void
+CodeBlock::optimize()
+{
+	ModuleInst *mi = this->_module;
+	Optimizer O;
+	unsigned *map;
+	unsigned i,n;
+	ListElem *le;
+	HashElem *he;
+
+	if (!mi)
+		return;
+
+	O.o_cb = this;
+	O.o_n = this->_length;
+	O.o_stats = OptStats_find(mi->_declaration);
+	O.o_stats->os_instances++;
+	O.o_stats->os_before += this->_length;
+
+	if (opt_level <= 0 || this->cb_threaded) {
+		O.o_stats->os_after += this->_length;
+		return;
+	}
+
+	O.o_kind = (unsigned char*) calloc(O.o_n+1,1);
+	O.o_flags = (unsigned char*) calloc(O.o_n+1,1);
+	PHash_init(&O.o_values);
+
+	if (Opt_scan(&O) == 0) {
+		if (opt_level >= 2)
+			Opt_dataflow(&O);
+		Opt_jumps(&O);
+
+		/*
+		 * Compute new offsets.  A removed instruction maps to the next
+		 * instruction that is kept.
+		 */
+		map = (unsigned*) malloc((O.o_n+1)*sizeof(unsigned));
+		for (i = n = 0;i <= O.o_n;i++) {
+			map[i] = n;
+			if (i < O.o_n && !(O.o_flags[i] & OF_REMOVED))
+				n++;
+		}
+
+		for (le = List_first(&this->cb_copies);le;
+		    le = List_next(&this->cb_copies,le)) {
+			CodeBlock *copy = (CodeBlock*) ListElem_obj(le);
+			Opt_thread(&O, copy, copy->cb_copyOffset);
+			Opt_relocate(&O, copy, copy->cb_copyOffset, map);
+		}
+		Opt_thread(&O, this, 0);
+		Opt_relocate(&O, this, 0, map);
+
+		for (le = List_first(&mi->_threads);le;
+		    le = List_next(&mi->_threads,le)) {
+			VGThread *t = (VGThread*) ListElem_obj(le);
+
+			if (t->t_start_block == this)
+				t->t_start_pc = map[t->t_start_pc];
+		}
+		for (he = Hash_first(&mi->mc_scope.s_tasks);he;
+		    he = Hash_next(&mi->mc_scope.s_tasks,he)) {
+			UserTask *ut = (UserTask*) HashElem_obj(he);
+
+			if (ut->ut_block == this)
+				ut->ut_offset = map[ut->ut_offset];
+		}
+
+		for (i = 0;i < O.o_n;i++)
+			if (!(O.o_flags[i] & OF_REMOVED))
+				this->cb_instructions[map[i]] = this->cb_instructions[i];
+		this->_length = n;
+
+		free(map);
+	}
+
+	O.o_stats->os_after += this->_length;
+
+	for (he = Hash_first(&O.o_values);he;he = Hash_next(&O.o_values,he))
+		free(HashElem_obj(he));
+	PHash_uninit(&O.o_values);
+	free(O.o_kind);
+	free(O.o_flags);
+}
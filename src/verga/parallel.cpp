@@ -0,0 +1,365 @@
+/****************************************************************************
+    Copyright (C) 1987-2015 by Jeffery P. Hansen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+****************************************************************************/
+#include <cstdlib>
+#include <thread>
+
+#include "verga.hpp"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define par_pause()		__builtin_ia32_pause()
+#else
+#define par_pause()
+#endif
+
+/*
+ * Worker of the calling thread while it is running events of a batch, null
+ * otherwise.
+ */
+thread_local ParWorker *par_worker = 0;
+
+/*****************************************************************************
+ *
+ * Record a queue operation made by a thread run on a worker
+ *
+ * Parameters:
+ *     w		Worker running the thread
+ *     t		Trigger the event waits on (null to place it in the queue)
+ *     e		Event
+ *
+ *****************************************************************************/
+void ParWorker_defer(ParWorker *w,Trigger *t,Event *e)
+{
+  ParAction *a;
+
+  if (w->w_numActions == w->w_maxActions) {
+    w->w_maxActions = w->w_maxActions ? 2*w->w_maxActions : 64;
+    w->w_actions = (ParAction*) realloc(w->w_actions,w->w_maxActions*sizeof(ParAction));
+  }
+
+  a = &w->w_actions[w->w_numActions++];
+  a->pa_trigger = t;
+  a->pa_event = e;
+}
+
+/*****************************************************************************
+ *
+ * Run one event of the current batch
+ *
+ * Parameters:
+ *     w		Worker running the event
+ *     pt		Event to run
+ *
+ *****************************************************************************/
+static void ParWorker_runTask(ParWorker *w,ParTask *pt)
+{
+  pt->pt_worker = w->w_id;
+  pt->pt_first = w->w_numActions;
+  Event_process(pt->pt_event,w->w_pool->p_queue);
+  pt->pt_last = w->w_numActions;
+  w->w_numTasks++;
+}
+
+/*****************************************************************************
+ *
+ * Run events of the current batch until none are left
+ *
+ * Parameters:
+ *     w		Worker
+ *
+ * The worker first runs the events of its own partition, then takes events
+ * from the other workers in turn.
+ *
+ *****************************************************************************/
+static void ParWorker_work(ParWorker *w)
+{
+  Parallel *P = w->w_pool;
+  unsigned i, k;
+
+  par_worker = w;
+
+  while ((i = w->w_next.fetch_add(1)) < w->w_end)
+    ParWorker_runTask(w,&P->p_tasks[P->p_order[i]]);
+
+  for (k = 1;k < P->p_numWorkers;k++) {
+    ParWorker *v = &P->p_workers[(w->w_id + k) % P->p_numWorkers];
+
+    while ((i = v->w_next.fetch_add(1)) < v->w_end) {
+      ParWorker_runTask(w,&P->p_tasks[P->p_order[i]]);
+      w->w_numSteals++;
+    }
+  }
+
+  par_worker = 0;
+}
+
+/*****************************************************************************
+ *
+ * Body of a worker thread
+ *
+ * Parameters:
+ *     w		Worker
+ *
+ * Waits for each batch by spinning for a while, then by sleeping.
+ *
+ *****************************************************************************/
+static void ParWorker_main(ParWorker *w)
+{
+  Parallel *P = w->w_pool;
+  unsigned seen = 0;
+
+  Event_usePools(w->w_events);
+  Value_usePool(&w->w_values);
+
+  for (;;) {
+    int n;
+
+    for (n = 0;n < THYMEPAR_SPIN && P->p_generation.load(std::memory_order_acquire) == seen;n++)
+      par_pause();
+    if (P->p_generation.load(std::memory_order_acquire) == seen) {
+      std::unique_lock<std::mutex> lock(P->p_lock);
+
+      while (P->p_generation.load(std::memory_order_acquire) == seen)
+	P->p_wake.wait(lock);
+    }
+    seen = P->p_generation.load(std::memory_order_acquire);
+
+    ParWorker_work(w);
+
+    w->w_opCalls = Value_opCalls;
+    w->w_opFast = Value_opFast;
+    Value_opCalls = Value_opFast = 0;
+    P->p_numDone.fetch_add(1,std::memory_order_release);
+  }
+}
+
+/*****************************************************************************
+ *
+ * Create a parallel executor
+ *
+ * Parameters:
+ *     numWorkers	Number of threads to run events on, including the
+ *			main thread
+ *     pt		Partitions of the threads (one for each worker)
+ *
+ * Returns:		New executor.
+ *
+ *****************************************************************************/
+Parallel *new_Parallel(unsigned numWorkers,Partitioner *pt)
+{
+  Parallel *P = new Parallel;
+  unsigned i;
+
+  P->p_numWorkers = numWorkers;
+  P->p_workers = new ParWorker[numWorkers];
+  P->p_partitioner = pt;
+  P->p_maxTasks = THYMEPAR_MAXBATCH;
+  P->p_tasks = (ParTask*) malloc(P->p_maxTasks*sizeof(ParTask));
+  P->p_order = (unsigned*) malloc(P->p_maxTasks*sizeof(unsigned));
+  P->p_numTasks = 0;
+  P->p_queue = 0;
+  P->p_batch = 0;
+  P->p_generation = 0;
+  P->p_numDone = 0;
+  P->p_numBatches = 0;
+  P->p_numEvents = 0;
+  P->p_numSerial = 0;
+
+  for (i = 0;i < numWorkers;i++) {
+    ParWorker *w = &P->p_workers[i];
+
+    w->w_pool = P;
+    w->w_id = i;
+    w->w_first = 0;
+    w->w_next = 0;
+    w->w_end = 0;
+    w->w_actions = 0;
+    w->w_numActions = 0;
+    w->w_maxActions = 0;
+    Event_initPools(w->w_events);
+    w->w_values.vp_free = 0;
+    w->w_values.vp_numOut = 0;
+    w->w_opCalls = w->w_opFast = 0;
+    w->w_numTasks = 0;
+    w->w_numSteals = 0;
+  }
+
+  for (i = 1;i < numWorkers;i++)
+    std::thread(ParWorker_main,&P->p_workers[i]).detach();
+
+  return P;
+}
+
+/*****************************************************************************
+ *
+ * Make the queue operations recorded by the workers and finish the events
+ *
+ * Parameters:
+ *     P		Executor
+ *     Q		Event queue
+ *
+ * Operations are made in the order of the events in the batch, and in the
+ * order each event made them, which is the order they would have been made
+ * in had the events been run one after another.
+ *
+ *****************************************************************************/
+static void Parallel_merge(Parallel *P,EvQueue *Q)
+{
+  unsigned i, j;
+
+  for (i = 0;i < P->p_numTasks;i++) {
+    ParTask *pt = &P->p_tasks[i];
+    ParWorker *w = &P->p_workers[pt->pt_worker];
+
+    for (j = pt->pt_first;j < pt->pt_last;j++) {
+      ParAction *a = &w->w_actions[j];
+
+      if (a->pa_trigger)
+	Trigger_enqueue(a->pa_trigger,a->pa_event);
+      else {
+	if (Event_getType(a->pa_event) == EV_NET)
+	  a->pa_event->ev_net.en_net->n_numEvents++;
+	EvQueue_enqueue(Q,a->pa_event);
+      }
+    }
+
+    if (!pt->pt_embedded)
+      delete_Event(pt->pt_event);
+  }
+
+  for (i = 0;i < P->p_numWorkers;i++) {
+    ParWorker *w = &P->p_workers[i];
+
+    w->w_numActions = 0;
+    if (i > 0) {
+      Event_settlePools(w->w_events);
+      Value_settlePool(&w->w_values);
+      Value_opCalls += w->w_opCalls;
+      Value_opFast += w->w_opFast;
+    }
+  }
+}
+
+/*****************************************************************************
+ *
+ * Run a thread event together with the thread events after it
+ *
+ * Parameters:
+ *     P		Executor
+ *     Q		Event queue
+ *     e		Thread event taken from the queue (Event_isParallel() is true)
+ *
+ * Thread events that can be run in parallel are taken from the head of the
+ * current time slot, stopping at any other kind of event or at a second
+ * wakeup of a thread already taken.  A batch too small to be worth waking
+ * the workers for is run by the main thread alone.
+ *
+ *****************************************************************************/
+void Parallel_run(Parallel *P,EvQueue *Q,Event *e)
+{
+  unsigned n, i, k;
+
+  P->p_batch++;
+  e->ev_thread.et_thread->t_batch = P->p_batch;
+  P->p_tasks[0].pt_event = e;
+  for (n = 1;n < P->p_maxTasks && (e = EvQueue_dequeueParallel(Q,P->p_batch));n++)
+    P->p_tasks[n].pt_event = e;
+  P->p_numTasks = n;
+
+  if (n < THYMEPAR_MINBATCH) {
+    for (i = 0;i < n;i++) {
+      e = P->p_tasks[i].pt_event;
+      Event_run(e,Q);
+    }
+    P->p_numSerial += n;
+    return;
+  }
+
+  for (i = 0;i < n;i++)
+    P->p_tasks[i].pt_embedded = (P->p_tasks[i].pt_event->ev_base.eb_status == ES_EMBEDDED);
+
+  /*
+   * Give each worker the events of the threads in its partition, in the
+   * order of the batch, and release them.
+   */
+  P->p_queue = Q;
+  for (i = 0;i < P->p_numWorkers;i++)
+    P->p_workers[i].w_end = 0;
+  for (i = 0;i < n;i++)
+    Parallel_taskWorker(P,&P->p_tasks[i])->w_end++;
+  for (i = 0, k = 0;i < P->p_numWorkers;i++) {
+    ParWorker *w = &P->p_workers[i];
+
+    w->w_first = k;
+    k += w->w_end;
+    w->w_end = k;
+    w->w_next.store(w->w_first,std::memory_order_relaxed);
+  }
+  for (i = 0;i < n;i++) {
+    ParWorker *w = Parallel_taskWorker(P,&P->p_tasks[i]);
+
+    P->p_order[w->w_next.fetch_add(1,std::memory_order_relaxed)] = i;
+  }
+  for (i = 0;i < P->p_numWorkers;i++) {
+    ParWorker *w = &P->p_workers[i];
+
+    w->w_next.store(w->w_first,std::memory_order_relaxed);
+  }
+  P->p_numDone.store(0,std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(P->p_lock);
+
+    P->p_generation.fetch_add(1,std::memory_order_release);
+  }
+  P->p_wake.notify_all();
+
+  ParWorker_work(&P->p_workers[0]);
+  for (i = 0;P->p_numDone.load(std::memory_order_acquire) < P->p_numWorkers-1;i++) {
+    if (i < THYMEPAR_SPIN)
+      par_pause();
+    else
+      std::this_thread::yield();
+  }
+
+  Parallel_merge(P,Q);
+
+  P->p_numBatches++;
+  P->p_numEvents += n;
+}
+
+/*****************************************************************************
+ *
+ * Write the parallel section of a JSON profile report
+ *
+ * Parameters:
+ *     P		Executor
+ *     f		File to write to
+ *
+ *****************************************************************************/
+void Parallel_writeProfile(Parallel *P,FILE *f)
+{
+  unsigned long long steals = 0;
+  unsigned i;
+
+  for (i = 0;i < P->p_numWorkers;i++)
+    steals += P->p_workers[i].w_numSteals;
+
+  fprintf(f,"  \"parallel\": {\"workers\": %u, \"batches\": %llu, \"events\": %llu, \"serial\": %llu, \"steals\": %llu},\n",
+	  P->p_numWorkers,P->p_numBatches,P->p_numEvents,P->p_numSerial,steals);
+  if (P->p_partitioner)
+    Partitioner_writeProfile(P->p_partitioner,f);
+}
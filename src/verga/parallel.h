@@ -0,0 +1,122 @@
+/****************************************************************************
+    Copyright (C) 1987-2015 by Jeffery P. Hansen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+****************************************************************************/
+#ifndef __parallel_h
+#define __parallel_h
+
+#include <mutex>
+#include <condition_variable>
+
+/*****************************************************************************
+ *
+ * ParAction - Queue operation deferred by a worker until its batch is merged
+ *
+ *****************************************************************************/
+typedef struct {
+  Trigger	*pa_trigger;	/* Trigger to wait on (null to enqueue pa_event) */
+  Event		*pa_event;	/* Event to place */
+} ParAction;
+
+/*****************************************************************************
+ *
+ * ParTask - A thread event run by the parallel executor
+ *
+ *****************************************************************************/
+typedef struct {
+  Event		*pt_event;	/* Thread event to run */
+  int		pt_embedded;	/* Event is part of its thread */
+  unsigned	pt_worker;	/* Worker that ran the event */
+  unsigned	pt_first;	/* First action of the event in the worker */
+  unsigned	pt_last;	/* End of the actions of the event */
+} ParTask;
+
+/*****************************************************************************
+ *
+ * ParWorker - A thread of the parallel executor.  Worker 0 is the main
+ * thread, which uses the main event and value pools.
+ *
+ *****************************************************************************/
+struct ParWorker_str {
+  Parallel	*w_pool;		/* Executor of the worker */
+  unsigned	w_id;			/* Index of the worker */
+  unsigned	w_first;		/* Start of the range of the worker in p_order */
+  std::atomic<unsigned> w_next;		/* Next task in the range of the worker */
+  unsigned	w_end;			/* End of the range of the worker */
+  ParAction	*w_actions;		/* Deferred queue operations */
+  unsigned	w_numActions;		/* Number of deferred operations */
+  unsigned	w_maxActions;		/* Size of w_actions */
+  EvPool	w_events[EV_NUMTYPES];	/* Event pools of the worker */
+  ValuePool	w_values;		/* Value pool of the worker */
+  unsigned long long w_opCalls;		/* Operator counts of the last batch */
+  unsigned long long w_opFast;
+  unsigned long long w_numTasks;	/* Number of events run */
+  unsigned long long w_numSteals;	/* Number of events taken from other workers */
+};
+
+/*****************************************************************************
+ *
+ * Parallel - Executor running thread events of the same time slot at once.
+ *
+ * Only threads marked by VGThread_canParallel() are run this way.  They
+ * compute values, schedule non-blocking assignments and wait on triggers,
+ * so that the only shared state they change is the event queue and the
+ * waiting lists of triggers.  Those changes are recorded by each worker
+ * and made by the main thread in the order of the events once all of them
+ * have run, so the result is the same as running them one after another.
+ *
+ * The threads are divided by a Partitioner into one partition for each
+ * worker, so that threads using the same nets are run on the same worker.
+ * Each worker is given the events of a batch whose threads are in its
+ * partition.  A worker that finishes its own events takes events from the
+ * other workers.
+ *
+ *****************************************************************************/
+class Parallel
+{
+public:
+  unsigned	p_numWorkers;		/* Number of workers (including main thread) */
+  ParWorker	*p_workers;		/* Workers */
+  Partitioner	*p_partitioner;		/* Partitions of the threads */
+  ParTask	*p_tasks;		/* Events of the current batch */
+  unsigned	*p_order;		/* Tasks sorted by the worker of their partition */
+  unsigned	p_numTasks;		/* Number of events in the batch */
+  unsigned	p_maxTasks;		/* Size of p_tasks */
+  EvQueue	*p_queue;		/* Event queue of the batch */
+  unsigned	p_batch;		/* Serial number of the current batch */
+  std::atomic<unsigned> p_generation;	/* Batches released to the workers */
+  std::atomic<unsigned> p_numDone;	/* Workers finished with the batch */
+  std::mutex	p_lock;			/* Lock for sleeping workers */
+  std::condition_variable p_wake;	/* A batch has been released */
+  unsigned long long p_numBatches;	/* Batches run by the workers */
+  unsigned long long p_numEvents;	/* Events run by the workers */
+  unsigned long long p_numSerial;	/* Events run alone (batch too small) */
+};
+
+extern thread_local ParWorker *par_worker;
+
+/*****************************************************************************
+ * Parallel member functions
+ *****************************************************************************/
+Parallel *new_Parallel(unsigned numWorkers,Partitioner *pt);
+void Parallel_run(Parallel *P,EvQueue *Q,Event *e);
+void Parallel_writeProfile(Parallel *P,FILE *f);
+void ParWorker_defer(ParWorker *w,Trigger *t,Event *e);
+#define Parallel_inWorker()	(par_worker != 0)
+#define Event_isParallel(e)	(Event_getType(e) == EV_THREAD && (e)->ev_thread.et_thread->t_parallel)
+#define Parallel_taskWorker(P,pt) (&(P)->p_workers[(pt)->pt_event->ev_thread.et_thread->t_partition % (P)->p_numWorkers])
+
+#endif
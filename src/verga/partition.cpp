@@ -0,0 +1,620 @@
+/****************************************************************************
+    Copyright (C) 1987-2015 by Jeffery P. Hansen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+****************************************************************************/
+#include <cstdlib>
+
+#include "verga.hpp"
+
+/*****************************************************************************
+ *
+ * Compare threads by the path of their module instance (for qsort)
+ *
+ *****************************************************************************/
+static int PtNode_compare(const void *va,const void *vb)
+{
+  const PtNode *a = (const PtNode*) va;
+  const PtNode *b = (const PtNode*) vb;
+  int d = strcmp(a->pn_path,b->pn_path);
+
+  if (d) return d;
+
+  return (a->pn_index < b->pn_index) ? -1 : (a->pn_index > b->pn_index);
+}
+
+/*****************************************************************************
+ *
+ * Split a placement given with -p into an instance path and a partition
+ *
+ * Parameters:
+ *     placement	Placement of the form "path=partition"
+ *     part		Returns the partition
+ *
+ * Returns:		Length of the path, or -1 if the placement is malformed.
+ *
+ *****************************************************************************/
+static int Partitioner_parsePlacement(const char *placement,unsigned *part)
+{
+  const char *eq = strrchr(placement,'=');
+  char c;
+
+  if (!eq || eq == placement)
+    return -1;
+  if (sscanf(eq+1,"%u%c",part,&c) != 1)
+    return -1;
+
+  return eq-placement;
+}
+
+/*****************************************************************************
+ *
+ * Test if a placement given with -p is well formed
+ *
+ * Parameters:
+ *     placement	Placement of the form "path=partition"
+ *
+ * Returns:		Non-zero if the placement is well formed.
+ *
+ *****************************************************************************/
+int Partitioner_checkPlacement(const char *placement)
+{
+  unsigned part;
+
+  return Partitioner_parsePlacement(placement,&part) >= 0;
+}
+
+/*****************************************************************************
+ *
+ * Find the partition a thread is placed in with -p
+ *
+ * Parameters:
+ *     path		Path of the module instance of the thread
+ *     placements	List of placements of the form "path=partition"
+ *     part		Returns the partition
+ *
+ * Returns:		Non-zero if the thread is placed.
+ *
+ * A placement covers an instance and all of the instances below it.  When
+ * several cover the same instance, the one with the longest path is used.
+ *
+ *****************************************************************************/
+static int Partitioner_findPlacement(const char *path,List *placements,unsigned *part)
+{
+  ListElem *le;
+  int best = -1;
+
+  for (le = List_first(placements);le;le = List_next(placements,le)) {
+    const char *placement = (const char*) ListElem_obj(le);
+    unsigned p;
+    int len = Partitioner_parsePlacement(placement,&p);
+
+    if (len <= best || strncmp(path,placement,len) != 0)
+      continue;
+    if (path[len] != 0 && path[len] != '.')
+      continue;
+
+    best = len;
+    *part = p;
+  }
+
+  return best >= 0;
+}
+
+/*****************************************************************************
+ *
+ * Create a graph
+ *
+ * Parameters:
+ *     numVerts		Number of vertices
+ *
+ * Returns:		New graph with no nets.
+ *
+ *****************************************************************************/
+static PtGraph *new_PtGraph(unsigned numVerts)
+{
+  PtGraph *G = (PtGraph*) malloc(sizeof(PtGraph));
+
+  G->pg_numVerts = numVerts;
+  G->pg_weight = (unsigned*) calloc(numVerts+1,sizeof(unsigned));
+  G->pg_fixed = (unsigned*) malloc((numVerts+1)*sizeof(unsigned));
+  G->pg_part = (unsigned*) calloc(numVerts+1,sizeof(unsigned));
+  G->pg_first = (unsigned*) calloc(numVerts+1,sizeof(unsigned));
+  G->pg_nets = 0;
+  G->pg_map = 0;
+
+  return G;
+}
+
+/*****************************************************************************
+ *
+ * Delete a graph
+ *
+ *****************************************************************************/
+static void delete_PtGraph(PtGraph *G)
+{
+  free(G->pg_weight);
+  free(G->pg_fixed);
+  free(G->pg_part);
+  free(G->pg_first);
+  free(G->pg_nets);
+  free(G->pg_map);
+  free(G);
+}
+
+/*****************************************************************************
+ *
+ * Make the graph of a set of threads
+ *
+ * Parameters:
+ *     pt		Partitioner
+ *     c		Circuit of the threads
+ *     nodes		Threads in order of the paths of their instances
+ *     placements	List of placements given with -p
+ *
+ * Returns:		Graph with one vertex for each thread.
+ *
+ * Nets are found from the values each thread reads, assigns or waits on.
+ *
+ *****************************************************************************/
+static PtGraph *Partitioner_buildGraph(Partitioner *pt,Circuit *c,PtNode *nodes,List *placements)
+{
+  PtGraph *G = new_PtGraph(pt->pt_numNodes);
+  PHash valueNets, netIndex;
+  NetHash::iterator it;
+  unsigned *stamp = 0;
+  unsigned maxNets = 0, numPins = 0, maxPins = 0, v;
+
+  PHash_init(&valueNets);
+  PHash_init(&netIndex);
+  for (it = c->c_nets.begin(); it != c->c_nets.end(); ++it) {
+    Net *n = it->second;
+
+    if (!(n->n_type & NT_P_MEMORY))
+      PHash_insert(&valueNets,Net_getValue(n),n);
+  }
+
+  for (v = 0;v < G->pg_numVerts;v++) {
+    List values;
+    ListElem *le;
+
+    G->pg_weight[v] = 1;
+    G->pg_fixed[v] = PT_FREE;
+    if (Partitioner_findPlacement(nodes[v].pn_path,placements,&G->pg_fixed[v])) {
+      G->pg_fixed[v] %= pt->pt_numParts;
+      pt->pt_numFixed++;
+    }
+
+    List_init(&values);
+    VGThread_getValues(nodes[v].pn_thread,&values);
+
+    G->pg_first[v] = numPins;
+    for (le = List_first(&values);le;le = List_next(&values,le)) {
+      Net *n = (Net*) PHash_find(&valueNets,ListElem_obj(le));
+      uintptr_t idx;
+
+      if (!n) continue;
+
+      idx = (uintptr_t) PHash_find(&netIndex,n);
+      if (!idx) {
+	idx = ++pt->pt_numNets;
+	PHash_insert(&netIndex,n,(void*)idx);
+	if (pt->pt_numNets > maxNets) {
+	  maxNets = 2*pt->pt_numNets;
+	  stamp = (unsigned*) realloc(stamp,maxNets*sizeof(unsigned));
+	}
+	stamp[idx-1] = PT_FREE;
+      }
+      if (stamp[idx-1] == v)
+	continue;
+      stamp[idx-1] = v;
+
+      if (numPins == maxPins) {
+	maxPins = maxPins ? 2*maxPins : 1024;
+	G->pg_nets = (unsigned*) realloc(G->pg_nets,maxPins*sizeof(unsigned));
+      }
+      G->pg_nets[numPins++] = idx-1;
+    }
+
+    List_uninit(&values);
+  }
+  G->pg_first[G->pg_numVerts] = numPins;
+
+  PHash_uninit(&valueNets);
+  PHash_uninit(&netIndex);
+  free(stamp);
+
+  return G;
+}
+
+/*****************************************************************************
+ *
+ * Group the vertices of a graph in pairs
+ *
+ * Parameters:
+ *     G		Graph
+ *     numNets		Number of nets
+ *     maxWeight	Most threads in a vertex of the coarser graph
+ *
+ * Returns:		Coarser graph, or null if too few vertices could be
+ *			grouped to be worth it.  The vertex of each vertex of G
+ *			is set in pg_map.
+ *
+ * Each vertex not yet grouped is joined with the vertex not yet grouped
+ * that shares the most nets with it.  Nets used by more than
+ * THYMEPART_MAXFANOUT vertices, such as clocks, are not counted.
+ *
+ *****************************************************************************/
+static PtGraph *PtGraph_coarsen(PtGraph *G,unsigned numNets,unsigned maxWeight)
+{
+  unsigned n = G->pg_numVerts;
+  unsigned *pinFirst = (unsigned*) calloc(numNets+1,sizeof(unsigned));
+  unsigned *pins = (unsigned*) malloc((G->pg_first[n]+1)*sizeof(unsigned));
+  unsigned *match = (unsigned*) malloc((n+1)*sizeof(unsigned));
+  unsigned *score = (unsigned*) calloc(n+1,sizeof(unsigned));
+  unsigned *touched = (unsigned*) malloc((n+1)*sizeof(unsigned));
+  unsigned *stamp;
+  unsigned numCoarse = 0, numPins = 0, u, v, i, j;
+  PtGraph *C;
+
+  /*
+   * Find the vertices using each net.
+   */
+  for (i = 0;i < G->pg_first[n];i++)
+    pinFirst[G->pg_nets[i]+1]++;
+  for (i = 0;i < numNets;i++)
+    pinFirst[i+1] += pinFirst[i];
+  for (v = 0;v < n;v++)
+    for (i = G->pg_first[v];i < G->pg_first[v+1];i++)
+      pins[pinFirst[G->pg_nets[i]]++] = v;
+  for (i = numNets;i > 0;i--)
+    pinFirst[i] = pinFirst[i-1];
+  pinFirst[0] = 0;
+
+  /*
+   * Pair each vertex with the free neighbour it shares the most nets with.
+   */
+  for (v = 0;v < n;v++)
+    match[v] = PT_FREE;
+  for (v = 0;v < n;v++) {
+    unsigned best = v, bestScore = 0, numTouched = 0;
+
+    if (match[v] != PT_FREE) continue;
+
+    if (G->pg_fixed[v] == PT_FREE) {
+      for (i = G->pg_first[v];i < G->pg_first[v+1];i++) {
+	unsigned e = G->pg_nets[i];
+
+	if (pinFirst[e+1] - pinFirst[e] > THYMEPART_MAXFANOUT)
+	  continue;
+	for (j = pinFirst[e];j < pinFirst[e+1];j++) {
+	  u = pins[j];
+	  if (u == v || match[u] != PT_FREE || G->pg_fixed[u] != PT_FREE)
+	    continue;
+	  if (G->pg_weight[u] + G->pg_weight[v] > maxWeight)
+	    continue;
+	  if (!score[u]++)
+	    touched[numTouched++] = u;
+	}
+      }
+      for (i = 0;i < numTouched;i++) {
+	u = touched[i];
+	if (score[u] > bestScore || (score[u] == bestScore && u < best)) {
+	  best = u;
+	  bestScore = score[u];
+	}
+	score[u] = 0;
+      }
+    }
+
+    match[v] = best;
+    match[best] = v;
+    numCoarse++;
+  }
+  free(pinFirst);
+  free(pins);
+  free(score);
+  free(touched);
+
+  if (numCoarse > n - n/10) {
+    free(match);
+    return 0;
+  }
+
+  /*
+   * Make the coarser graph, numbering its vertices in the order of their
+   * first vertex in G.
+   */
+  C = new_PtGraph(numCoarse);
+  G->pg_map = (unsigned*) malloc((n+1)*sizeof(unsigned));
+  for (v = 0;v < n;v++)
+    G->pg_map[v] = PT_FREE;
+  for (v = 0, numCoarse = 0;v < n;v++) {
+    if (G->pg_map[v] != PT_FREE) continue;
+
+    G->pg_map[v] = G->pg_map[match[v]] = numCoarse;
+    C->pg_weight[numCoarse] = G->pg_weight[v] + (match[v] != v ? G->pg_weight[match[v]] : 0);
+    C->pg_fixed[numCoarse] = G->pg_fixed[v];
+    numCoarse++;
+  }
+
+  C->pg_nets = (unsigned*) malloc((G->pg_first[n]+1)*sizeof(unsigned));
+  stamp = (unsigned*) malloc((numNets+1)*sizeof(unsigned));
+  for (i = 0;i < numNets;i++)
+    stamp[i] = PT_FREE;
+  for (v = 0;v < n;v++) {
+    unsigned c = G->pg_map[v];
+
+    if (match[v] < v) continue;			/* Added with its pair */
+
+    C->pg_first[c] = numPins;
+    for (u = v;;u = match[v]) {
+      for (i = G->pg_first[u];i < G->pg_first[u+1];i++) {
+	unsigned e = G->pg_nets[i];
+
+	if (stamp[e] != c) {
+	  stamp[e] = c;
+	  C->pg_nets[numPins++] = e;
+	}
+      }
+      if (u == match[v]) break;
+    }
+  }
+  C->pg_first[numCoarse] = numPins;
+
+  free(stamp);
+  free(match);
+
+  return C;
+}
+
+/*****************************************************************************
+ *
+ * Split the vertices of a graph in order into partitions of equal size
+ *
+ * Parameters:
+ *     pt		Partitioner
+ *     G		Graph
+ *     share		Threads in an equal share
+ *
+ *****************************************************************************/
+static void Partitioner_split(Partitioner *pt,PtGraph *G,unsigned share)
+{
+  unsigned cur = 0, v;
+
+  for (v = 0;v < G->pg_numVerts;v++)
+    if (G->pg_fixed[v] != PT_FREE) {
+      G->pg_part[v] = G->pg_fixed[v];
+      pt->pt_size[G->pg_part[v]] += G->pg_weight[v];
+    }
+
+  for (v = 0;v < G->pg_numVerts;v++) {
+    if (G->pg_fixed[v] != PT_FREE) continue;
+
+    while (cur < pt->pt_numParts-1 && pt->pt_size[cur] + G->pg_weight[v]/2 >= share)
+      cur++;
+    G->pg_part[v] = cur;
+    pt->pt_size[cur] += G->pg_weight[v];
+  }
+}
+
+/*****************************************************************************
+ *
+ * Count the vertices using each net in each partition
+ *
+ * Parameters:
+ *     pt		Partitioner
+ *     G		Graph
+ *
+ * Returns:		Table of pt_numNets rows of pt_numParts counts.
+ *
+ *****************************************************************************/
+static unsigned *Partitioner_countPins(Partitioner *pt,PtGraph *G)
+{
+  unsigned K = pt->pt_numParts;
+  unsigned *pins = (unsigned*) calloc((size_t)pt->pt_numNets*K+1,sizeof(unsigned));
+  unsigned v, i;
+
+  for (v = 0;v < G->pg_numVerts;v++)
+    for (i = G->pg_first[v];i < G->pg_first[v+1];i++)
+      pins[(size_t)G->pg_nets[i]*K + G->pg_part[v]]++;
+
+  return pins;
+}
+
+/*****************************************************************************
+ *
+ * Move vertices between partitions to reduce the cut
+ *
+ * Parameters:
+ *     pt		Partitioner
+ *     G		Graph
+ *     maxSize		Most threads allowed in a partition
+ *
+ * Each pass looks at every vertex that was not placed with -p and moves it
+ * to the partition with the largest gain, if the gain is positive.  The gain
+ * of a move is the number of nets that the old partition no longer uses,
+ * less the number of nets that the new partition starts using.  Passes are
+ * made until one moves no vertex, or for at most THYMEPART_PASSES passes.
+ *
+ *****************************************************************************/
+static void Partitioner_refine(Partitioner *pt,PtGraph *G,unsigned maxSize)
+{
+  unsigned K = pt->pt_numParts;
+  unsigned *pins = Partitioner_countPins(pt,G);
+  int *gain = (int*) malloc(K*sizeof(int));
+  int pass;
+
+  for (pass = 0;pass < THYMEPART_PASSES;pass++) {
+    unsigned moved = 0, v, i, b;
+
+    for (v = 0;v < G->pg_numVerts;v++) {
+      unsigned a = G->pg_part[v], w = G->pg_weight[v], best = a;
+      int base = 0, bestGain = 0;
+
+      if (G->pg_fixed[v] != PT_FREE) continue;
+
+      for (b = 0;b < K;b++)
+	gain[b] = 0;
+      for (i = G->pg_first[v];i < G->pg_first[v+1];i++) {
+	unsigned *row = pins + (size_t)G->pg_nets[i]*K;
+
+	if (row[a] == 1)
+	  base++;
+	for (b = 0;b < K;b++)
+	  if (row[b] == 0)
+	    gain[b]--;
+      }
+      for (b = 0;b < K;b++) {
+	if (b == a || pt->pt_size[b] + w > maxSize)
+	  continue;
+	if (base + gain[b] > bestGain) {
+	  bestGain = base + gain[b];
+	  best = b;
+	}
+      }
+
+      if (best == a) continue;
+
+      for (i = G->pg_first[v];i < G->pg_first[v+1];i++) {
+	unsigned *row = pins + (size_t)G->pg_nets[i]*K;
+
+	row[a]--;
+	row[best]++;
+      }
+      pt->pt_size[a] -= w;
+      pt->pt_size[best] += w;
+      G->pg_part[v] = best;
+      moved++;
+    }
+
+    pt->pt_numMoves += moved;
+    if (!moved) break;
+  }
+
+  free(gain);
+  free(pins);
+}
+
+/*****************************************************************************
+ *
+ * Divide threads into partitions
+ *
+ * Parameters:
+ *     c		Circuit of the threads
+ *     threads		List of VGThread* to divide (VGThread_canParallel() is
+ *			true for each)
+ *     numParts		Number of partitions
+ *     placements	List of placements given with -p ("path=partition")
+ *
+ * Returns:		New partitioner.  The partition of each thread is set
+ *			in t_partition.
+ *
+ * A net connected through a port counts as the same net in every instance
+ * that uses it.  A partition given with -p that is not less than numParts
+ * is taken modulo numParts.
+ *
+ *****************************************************************************/
+Partitioner *new_Partitioner(Circuit *c,List *threads,unsigned numParts,List *placements)
+{
+  Partitioner *pt = (Partitioner*) calloc(1,sizeof(Partitioner));
+  PtNode *nodes = (PtNode*) calloc(List_numElems(threads)+1,sizeof(PtNode));
+  PtGraph *graphs[THYMEPART_LEVELS+1];
+  unsigned share, maxSize, *pins;
+  unsigned top = 0, i, j, v;
+  ListElem *le;
+
+  pt->pt_numParts = numParts;
+  pt->pt_size = (unsigned*) calloc(numParts,sizeof(unsigned));
+
+  for (le = List_first(threads);le;le = List_next(threads,le)) {
+    PtNode *node = &nodes[pt->pt_numNodes];
+
+    node->pn_thread = (VGThread*) ListElem_obj(le);
+    node->pn_path = node->pn_thread->t_modCtx->mc_path;
+    node->pn_index = pt->pt_numNodes++;
+  }
+  qsort(nodes,pt->pt_numNodes,sizeof(PtNode),PtNode_compare);
+
+  share = (pt->pt_numNodes + numParts-1)/numParts;
+  maxSize = share + share*THYMEPART_IMBALANCE/100;
+
+  /*
+   * Group the threads into coarser graphs and split the coarsest one.
+   */
+  graphs[0] = Partitioner_buildGraph(pt,c,nodes,placements);
+  while (top < THYMEPART_LEVELS && graphs[top]->pg_numVerts > 4*numParts) {
+    PtGraph *C = PtGraph_coarsen(graphs[top],pt->pt_numNets,share/4 + 1);
+
+    if (!C) break;
+    graphs[++top] = C;
+  }
+  pt->pt_numLevels = top;
+
+  Partitioner_split(pt,graphs[top],share);
+
+  /*
+   * Refine the partitions at each level on the way back to the threads.
+   */
+  for (i = top+1;i-- > 0;) {
+    PtGraph *G = graphs[i];
+
+    if (i < top)
+      for (v = 0;v < G->pg_numVerts;v++)
+	G->pg_part[v] = graphs[i+1]->pg_part[G->pg_map[v]];
+    Partitioner_refine(pt,G,maxSize);
+  }
+
+  pins = Partitioner_countPins(pt,graphs[0]);
+  for (i = 0;i < pt->pt_numNets;i++) {
+    unsigned used = 0;
+
+    for (j = 0;j < numParts;j++)
+      if (pins[(size_t)i*numParts + j])
+	used++;
+    if (used > 1)
+      pt->pt_numCut++;
+  }
+  free(pins);
+
+  for (v = 0;v < pt->pt_numNodes;v++)
+    nodes[v].pn_thread->t_partition = graphs[0]->pg_part[v];
+
+  for (i = 0;i <= top;i++)
+    delete_PtGraph(graphs[i]);
+  free(nodes);
+
+  return pt;
+}
+
+/*****************************************************************************
+ *
+ * Write the partition section of a JSON profile report
+ *
+ * Parameters:
+ *     pt		Partitioner
+ *     f		File to write to
+ *
+ *****************************************************************************/
+void Partitioner_writeProfile(Partitioner *pt,FILE *f)
+{
+  unsigned i;
+
+  fprintf(f,"  \"partitions\": {\"threads\": %u, \"placed\": %u, \"nets\": %u, \"cut\": %u, \"levels\": %u, \"moves\": %u, \"sizes\": [",
+	  pt->pt_numNodes,pt->pt_numFixed,pt->pt_numNets,pt->pt_numCut,pt->pt_numLevels,pt->pt_numMoves);
+  for (i = 0;i < pt->pt_numParts;i++)
+    fprintf(f,"%s%u",i ? ", " : "",pt->pt_size[i]);
+  fprintf(f,"]},\n");
+}
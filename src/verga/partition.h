@@ -0,0 +1,88 @@
+/****************************************************************************
+    Copyright (C) 1987-2015 by Jeffery P. Hansen
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+****************************************************************************/
+#ifndef __partition_h
+#define __partition_h
+
+/*****************************************************************************
+ *
+ * PtNode - A thread placed by a Partitioner
+ *
+ *****************************************************************************/
+typedef struct {
+  VGThread	*pn_thread;	/* Thread */
+  const char	*pn_path;	/* Path of the module instance of the thread */
+  unsigned	pn_index;	/* Position of the thread in the circuit */
+} PtNode;
+
+/*****************************************************************************
+ *
+ * PtGraph - Threads and the nets they use, as seen at one level of
+ * coarsening.  Each vertex is a group of threads of the next finer graph.
+ *
+ *****************************************************************************/
+struct PtGraph_str {
+  unsigned	pg_numVerts;	/* Number of vertices */
+  unsigned	*pg_weight;	/* Threads in each vertex */
+  unsigned	*pg_fixed;	/* Partition of each vertex placed with -p (PT_FREE if not) */
+  unsigned	*pg_part;	/* Partition of each vertex */
+  unsigned	*pg_first;	/* Start of the nets of each vertex in pg_nets */
+  unsigned	*pg_nets;	/* Nets used by each vertex */
+  unsigned	*pg_map;	/* Vertex of each vertex in the next coarser graph */
+};
+
+/*
+ * Partition of a vertex that is not placed with -p
+ */
+#define PT_FREE		(~0u)
+
+/*****************************************************************************
+ *
+ * Partitioner - Division of the threads run by the parallel executor into
+ * one partition for each worker.
+ *
+ * The threads are taken in order of the paths of their module instances,
+ * so that threads of the same subtree of the instance hierarchy are next to
+ * each other.  They are then grouped in coarser and coarser graphs by
+ * joining each vertex with the neighbour it shares the most nets with.  The
+ * coarsest graph is split in order into partitions of equal size.  Going
+ * back to the threads one level at a time, vertices are moved to the
+ * partition that most reduces the number of partitions each net is used
+ * in, as long as no partition grows more than THYMEPART_IMBALANCE percent
+ * over an equal share.  Threads of instances named with -p are placed first
+ * and never grouped or moved.
+ *
+ *****************************************************************************/
+struct Partitioner_str {
+  unsigned	pt_numParts;	/* Number of partitions */
+  unsigned	pt_numNodes;	/* Number of threads */
+  unsigned	pt_numFixed;	/* Threads placed by -p */
+  unsigned	pt_numNets;	/* Nets used by the threads */
+  unsigned	pt_numCut;	/* Nets used in more than one partition */
+  unsigned	pt_numLevels;	/* Number of coarser graphs made */
+  unsigned	pt_numMoves;	/* Vertices moved to reduce the cut */
+  unsigned	*pt_size;	/* Threads in each partition */
+};
+
+/*****************************************************************************
+ * Partitioner member functions
+ *****************************************************************************/
+Partitioner *new_Partitioner(Circuit *c,List *threads,unsigned numParts,List *placements);
+int Partitioner_checkPlacement(const char *placement);
+void Partitioner_writeProfile(Partitioner *pt,FILE *f);
+
+#endif
@@ -610,7 +610,7 @@ static Trigger *Circuit_dpath_getPortTrigger(Circuit *c, ModuleInst *mi, Scope *
     List_addToTail(&negedges, n);
   }
 
-  trigger = Circuit_getTrigger(c, &posedges, &negedges);
+  trigger = Circuit_getTrigger(c, &posedges, &negedges, 0);
 
   List_uninit(&posedges);
   List_uninit(&negedges);
@@ -207,7 +207,7 @@ static void Specify_generateTaskCall(Specify *s,ModuleInst *mi,CodeBlock *codeBl
   nargs = task->t_nargs + 1;
   sargs = (void**) malloc(sizeof(void*)*nargs);
 
-  sargs[0] = new_Value(SSWORDSIZE);
+  sargs[0] = new_Value(SSINTSIZE);
   Value_convertI((Value *) sargs[0],which);
 
   for (i = 0, j = 1;i < task->t_nargs;i++, j++) {
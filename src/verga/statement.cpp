@@ -1273,16 +1273,16 @@ void SDRepeat_generate(SDRepeat *sdr, Scope *scope, CodeBlock *cb)
   Value *count,*zero,*one,*cond;
   unsigned top_bc,test_bc,after_bc;
 
-  cond = new_Value(SSWORDSIZE);
-  zero = new_Value(SSWORDSIZE);
-  one = new_Value(SSWORDSIZE);
+  cond = new_Value(SSINTSIZE);
+  zero = new_Value(SSINTSIZE);
+  one = new_Value(SSINTSIZE);
   Value_zero(zero);
   Value_lone(one);
 
   /*
    * If this is a direct access value, make a copy.
    */
-  count = Expr_generate(sdr->r_count, SSWORDSIZE, scope, cb);
+  count = Expr_generate(sdr->r_count, SSINTSIZE, scope, cb);
   if ((Value_getAllFlags(count) & SF_NETVAL)) {
     Value *r_copy = new_Value(Value_nbits(count));
     BCCopy_init(cb->nextEmpty(), r_copy,count);
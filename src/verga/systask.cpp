@@ -183,7 +183,7 @@ TaskContext *new_TaskContext(int nargs,Expr **args,ModuleInst *modCtx)
     tc->tc_lastValues = (Value**) malloc(sizeof(Value*)*tc->tc_numNets);
   }
   for (i = 0, he = Hash_first(&H);he;i++, he = Hash_next(&H, he)) {
-    Net *n = (Net*)HashElem_obj(he);
+    Net *n = ((NetSlice*)HashElem_obj(he))->ns_net;
     tc->tc_nets[i] = n;
     tc->tc_lastValues[i] = new_Value(Net_nbits(n));
   }
@@ -345,14 +345,39 @@ static int SysTask_sprintfSSVec(VGThread *t,char *p,int numArgs, void **args)
   return nUsed;
 }
 
+/*****************************************************************************
+ *
+ * Get an upper bound on the length of the text formatted from an argument
+ * list.  A value never takes more than one character per bit, plus a size
+ * prefix, so the bound follows the width of the arguments.
+ *
+ * Parameters:
+ *     numArgs		Number of arguments
+ *     args		Array of argument values
+ *
+ *****************************************************************************/
+static int SysTask_formatLength(int numArgs, void **args)
+{
+  int len = STRMAX;
+  int i;
+
+  for (i = 0;i < numArgs;i++)
+    len += Value_nbits((Value*)args[i]) + 32;
+
+  return len;
+}
+
 /*****************************************************************************
  *****************************************************************************/
 static void SysTask_printfSSVec(VGThread *t,int numArgs, void **args)
 {
-  char buf[2*STRMAX];
+  char sbuf[2*STRMAX], *buf = sbuf;
   int nUsed;
   int lastWasDiscrete = 0;
 
+  if (SysTask_formatLength(numArgs,args) > (int)sizeof(sbuf))
+    buf = (char*) malloc(SysTask_formatLength(numArgs,args));
+
   while (numArgs > 0) {
     if ((Value_getTypeFlags((Value*)args[0]) & SF_STRING)) {
       nUsed = SysTask_sprintfSSVec(t,buf,numArgs,args);
@@ -369,6 +394,9 @@ static void SysTask_printfSSVec(VGThread *t,int numArgs, void **args)
       lastWasDiscrete = 1;
     }
   }
+
+  if (buf != sbuf)
+    free(buf);
 }
 
 /*****************************************************************************
@@ -643,7 +671,7 @@ SysTask_tkg_unprobe(VGThread *t,Value *r,int numArgs,void **args,TaskContext *ta
 static void SysTask_fwrite(VGThread *t,Value *r,int numArgs,void **args,TaskContext *tc)
 {
   unsigned handle;
-  char buf[2*STRMAX], *p;
+  char sbuf[2*STRMAX], *buf = sbuf, *p;
   int nUsed;
   int lastWasDiscrete = 0;
   int i;
@@ -654,6 +682,9 @@ static void SysTask_fwrite(VGThread *t,Value *r,int numArgs,void **args,TaskCont
   numArgs--;
   args++;
 
+  if (SysTask_formatLength(numArgs,args) > (int)sizeof(sbuf))
+    buf = (char*) malloc(SysTask_formatLength(numArgs,args));
+
   p = buf;
   while (numArgs > 0) {
     if ((Value_getTypeFlags((Value*)args[0]) & SF_STRING)) {
@@ -684,6 +715,9 @@ static void SysTask_fwrite(VGThread *t,Value *r,int numArgs,void **args,TaskCont
 	errorRun(ERR_CLSDWRITE);
     }
   }
+
+  if (buf != sbuf)
+    free(buf);
 }
 
 /*****************************************************************************
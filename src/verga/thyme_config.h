@@ -22,10 +22,35 @@
 				"    Copyright (C) 2015 by Andrey V. Skvortsov"
 #define STRMAX			1024		/* Length of longest string */
 
-#define THYMEWHEEL_SIZE		0x1000		/* Size of timewheel (must be power of two) */
-#define THYMEWHEEL_MASK		0x0fff		/* Mask for thymewheel (= size-1) */
-
-#define POLL_RATE		50		/* Time between input checks (milliseconds) */
+#define THYMEWHEEL_SIZE		0x1000		/* Default size of level 0 timewheel (power of two) */
+#define THYMEWHEEL_MINSIZE	0x40		/* Smallest level 0 timewheel size */
+#define THYMEWHEEL_MAXSIZE	0x100000	/* Largest level 0 timewheel size */
+#define THYMEWHEEL_LEVELSLOTS	64		/* Slots in each upper timewheel level */
+#define THYMEWHEEL_LEVELBITS	6		/* log2 of THYMEWHEEL_LEVELSLOTS */
+#define THYMEWHEEL_LEVELS	10		/* Upper levels needed to cover 64-bit time */
+
+#define THYMEEVENT_SLABSIZE	0x4000		/* Bytes in each slab of events */
+#define THYMEEVENT_CACHELINE	64		/* Alignment of event slabs */
+#define THYMEEVENT_GRAIN	16		/* Events are a multiple of this size */
+
+#define THYMEVALUE_INLINEBITS	64		/* Largest value stored inside the Value object */
+#define THYMEVALUE_SIMDBITS	256		/* Smallest operands using vector kernels */
+#define MULTINT_KARATSUBA	32		/* Operand words at which multiplies use Karatsuba */
+#define MULTINT_DECSPLIT	8		/* Decimal chunks at which radix conversion splits */
+
+#define THYMEPAR_MAXJOBS	64		/* Most threads for parallel evaluation (-j) */
+#define THYMEPAR_MINBATCH	16		/* Fewest thread events run in parallel */
+#define THYMEPAR_MAXBATCH	4096		/* Most thread events in one parallel batch */
+#define THYMEPAR_SPIN		2000		/* Polls of a waiting thread before it yields or sleeps */
+#define THYMEPART_PASSES	8		/* Most passes moving threads between partitions */
+#define THYMEPART_IMBALANCE	10		/* Percent a partition may grow over an equal share */
+#define THYMEPART_LEVELS	16		/* Most levels of coarsening */
+#define THYMEPART_MAXFANOUT	64		/* Nets used by more vertices are ignored when grouping */
+
+#define QUEUE_TOPNETS		10		/* Default number of nets in queue profile */
+
+#define POLL_RATE		50		/* Time between real time event checks (milliseconds) */
+#define CMDQUEUE_SIZE		64		/* Command lines buffered by input thread */
 
 /*
  * Maximum number of arguments that can have a type specification
@@ -106,12 +131,31 @@ typedef struct UserTask_str UserTask;
  *****************************************************************************/
 typedef unsigned nettype_t;
 class Net;
+typedef struct NetSlice_str NetSlice;
 
 /*****************************************************************************
  * advance declarations from channel.h
  *****************************************************************************/
 class Channel;
 
+/*****************************************************************************
+ * advance declarations from levelize.h
+ *****************************************************************************/
+typedef struct Levelizer_str Levelizer;
+typedef struct LzGate_str LzGate;
+
+/*****************************************************************************
+ * advance declarations from parallel.h
+ *****************************************************************************/
+class Parallel;
+typedef struct ParWorker_str ParWorker;
+
+/*****************************************************************************
+ * advance declarations from partition.h
+ *****************************************************************************/
+typedef struct Partitioner_str Partitioner;
+typedef struct PtGraph_str PtGraph;
+
 /*****************************************************************************
  * advance declarations from directive.h
  *****************************************************************************/
@@ -55,22 +55,28 @@ static int addrCmp(const void *vA,const void *vB)
  * Parameters:
  *     posedges		Sorted list of Net* which invoke this trigger on a posedge
  *     negedges		Sorted list of Net* which invoke this trigger on a negedge
+ *     slices		Sorted list of NetSlice* which invoke this trigger on a change
  *     next		Next trigger in hash bucket
  *
  * Returns:		Newly created Trigger object.
  *
  * Single bit signals that do not have a qualifier will be placed in both
  * the posedges and negedges lists.  Multi-bit signals will be placed in
- * only the posedges list and be triggered on any change.
+ * only the posedges list and be triggered on any change.  Multi-bit signals
+ * of which only some bits are read are placed in the slices list and are
+ * triggered on a change in any of those bits.
  *
  *****************************************************************************/
-Trigger *new_Trigger(List *posedges,List *negedges,Trigger *next)
+Trigger *new_Trigger(List *posedges,List *negedges,List *slices,Trigger *next)
 {
   Trigger *t = (Trigger*) malloc(sizeof(Trigger));
 
   t->t_posedges = posedges ? copy_List(posedges) : new_List();
   t->t_negedges = negedges ? copy_List(negedges) : new_List();
-  t->t_events = 0;
+  t->t_slices = slices ? copy_List(slices) : new_List();
+  t->t_events = t->t_eventsTail = 0;
+  memset(t->t_numEvents,0,sizeof(t->t_numEvents));
+  t->t_level = 0;
   t->t_next = 0;
 
   return t;
@@ -78,20 +84,21 @@ Trigger *new_Trigger(List *posedges,List *negedges,Trigger *next)
 
 /*****************************************************************************
  *
- * Get the hash code for a pair of lists.
+ * Get the hash code for a set of lists.
  *
  * Parameters:
  *     posedges		Sorted list of posedge Net*
  *     negedges		Sorted list of negedge Net*
+ *     slices		Sorted list of NetSlice* (or null)
  *
  * Returns:		Hash code representing lists.
  *
- * The value returned is a hash value representing the pair of lists.  For any
- * identical pairs of lists, the same hash code will always be returned.  For
- * unmatching pairs of lists, the value returned should "usually" be different.
+ * The value returned is a hash value representing the set of lists.  For any
+ * identical sets of lists, the same hash code will always be returned.  For
+ * unmatching sets of lists, the value returned should "usually" be different.
  *
  *****************************************************************************/
-uintptr_t Trigger_getHashCode(List *posedges,List *negedges)
+uintptr_t Trigger_getHashCode(List *posedges,List *negedges,List *slices)
 {
   ListElem *le;
   uintptr_t HC = 0;
@@ -104,46 +111,57 @@ uintptr_t Trigger_getHashCode(List *posedges,List *negedges)
     uintptr_t X = (uintptr_t) ListElem_obj(le);
     HC = ((HC+X) << 8) + X*X + (HC>>8);
   }
+  if (slices) {
+    for (le = List_first(slices);le;le = List_next(slices,le)) {
+      uintptr_t X = (uintptr_t) ListElem_obj(le);
+      HC = ((HC+X) << 8) + X*X + (HC>>8);
+    }
+  }
 
   return HC;
 }
 
 /*****************************************************************************
  *
- * Sort both lists and get the hash code using Trigger_getHashCode
+ * Sort all lists and get the hash code using Trigger_getHashCode
  *
  * Parameters:
  *     posedges		Unsorted list of posedge Net*
  *     negedges		Unsorted list of negedge Net*
+ *     slices		Unsorted list of NetSlice* (or null)
  *
  * Returns:		Hash code representing lists.
  *
  *****************************************************************************/
-uintptr_t Trigger_sortAndGetHashCode(List *posedges,List *negedges)
+uintptr_t Trigger_sortAndGetHashCode(List *posedges,List *negedges,List *slices)
 {
   List_sort(posedges,addrCmp);
   List_sort(negedges,addrCmp);
-  return Trigger_getHashCode(posedges,negedges);
+  if (slices)
+    List_sort(slices,addrCmp);
+  return Trigger_getHashCode(posedges,negedges,slices);
 }
 
 
 /*****************************************************************************
  *
- * Test a trigger to see if it exactly matches the posesges and negedges list.
- * it is assumed that the lists are sorted.
+ * Test a trigger to see if it exactly matches the posesges, negedges and
+ * slices lists.  it is assumed that the lists are sorted.
  *
  * Parameters:
  *     t		Trigger to compare
  *     posedges		Sorted list of posedge sensitive nets
  *     negedges		Sorted list of negedge sensitive nets
+ *     slices		Sorted list of sensitive net slices (or null)
  *
  *****************************************************************************/
-int Trigger_match(Trigger *t,List *posedges,List *negedges)
+int Trigger_match(Trigger *t,List *posedges,List *negedges,List *slices)
 {
   ListElem *le1, *le2;
 
   if (List_numElems(t->t_posedges) != List_numElems(posedges)) return 0;
   if (List_numElems(t->t_negedges) != List_numElems(negedges)) return 0;
+  if (List_numElems(t->t_slices) != (slices ? List_numElems(slices) : 0)) return 0;
 
   le1 = List_first(t->t_posedges);
   le2 = List_first(posedges);
@@ -163,6 +181,17 @@ int Trigger_match(Trigger *t,List *posedges,List *negedges)
     le2 = List_next(negedges,le2);
   }
 
+  if (slices) {
+    le1 = List_first(t->t_slices);
+    le2 = List_first(slices);
+    while (le1 && le2) {
+      if (ListElem_obj(le1) != ListElem_obj(le2))
+	return 0;
+      le1 = List_next(t->t_slices,le1);
+      le2 = List_next(slices,le2);
+    }
+  }
+
   return 1;
 }
 
@@ -175,25 +204,26 @@ int Trigger_match(Trigger *t,List *posedges,List *negedges)
  *     tlist		Pointer to head of list of triggers with matching hashcodes
  *     posedges		Sorted list of posedge sensitive Net*
  *     negedges		Sorted list of negedge sensitive Net*
+ *     slices		Sorted list of sensitive NetSlice* (or null)
  *
  * Looks through the list *tlist of triggers for a trigger with the same
- * posedges/negedges as those passed.  If the trigger is found it is returned
+ * posedges/negedges/slices as those passed.  If the trigger is found it is returned
  * and if it is not found a new trigger is created and it is inserted into
  * *tlist.  Assuming Trigger_getHashCode() returns good values, the *tlist
  * should almost always have either 0 or 1 elements, and when it has 1 element
  * the lookup should almost always succeed.
  *
  *****************************************************************************/
-Trigger *Trigger_getTrigger(Trigger **tlist,List *posedges,List *negedges)
+Trigger *Trigger_getTrigger(Trigger **tlist,List *posedges,List *negedges,List *slices)
 {
   Trigger *t;
   ListElem *le;
 
   for (t = *tlist;t;t = t->t_next)
-    if (Trigger_match(t,posedges,negedges))
+    if (Trigger_match(t,posedges,negedges,slices))
       return t;
 
-  *tlist = t = new_Trigger(posedges,negedges,*tlist);
+  *tlist = t = new_Trigger(posedges,negedges,slices,*tlist);
 
   for (le = List_first(posedges);le;le = List_next(posedges,le)) {
     Net_posedgeListen((Net*) ListElem_obj(le),t);
@@ -203,6 +233,10 @@ Trigger *Trigger_getTrigger(Trigger **tlist,List *posedges,List *negedges)
     Net_negedgeListen((Net*) ListElem_obj(le),t);
   }
 
+  for (le = List_first(t->t_slices);le;le = List_next(t->t_slices,le)) {
+    NetSlice_listen((NetSlice*) ListElem_obj(le),t);
+  }
+
   return t;
 }
 
@@ -234,6 +268,11 @@ Trigger_print(Trigger *t, FILE *f)
 
 		std::fprintf(f, " negedge %s", n->name());
 	}
+	for (le = List_first(t->t_slices);le;le = List_next(t->t_slices,le)) {
+		NetSlice *ns = (NetSlice*)ListElem_obj(le);
+
+		std::fprintf(f, " %s[%d:%d]", ns->ns_net->name(), ns->ns_msb, ns->ns_lsb);
+	}
 	std::fprintf(f, ")");
 }
 
@@ -245,19 +284,22 @@ Trigger_print(Trigger *t, FILE *f)
  *     t		Trigger to fire.
  *
  * When this function is called, any events that are stored in the trigger
- * are moved to the main simulator time queue at the current time.
+ * are moved to the main simulator time queue at the current time.  The
+ * waiting events are already linked in the order in which they are to be
+ * run, so they are spliced onto the current slot as a whole.
  *
  *****************************************************************************/
 void Trigger_fire(Trigger *t)
 {
-  EvQueue *Q = Circuit_getQueue(&vgsim.circuit());
+  if (t->t_level)
+    Levelizer_wake(vgsim.circuit().c_levelizer,t->t_level);
 
-  while (t->t_events) {
-    Event *e = t->t_events;
-    t->t_events = e->ev_base.eb_next;
+  if (!t->t_events) return;
 
-    EvQueue_enqueueAfter(Q,e,0);
-  }
+  EvQueue_enqueueChain(Circuit_getQueue(&vgsim.circuit()),t->t_events,t->t_eventsTail,t->t_numEvents);
+
+  t->t_events = t->t_eventsTail = 0;
+  memset(t->t_numEvents,0,sizeof(t->t_numEvents));
 }
 
 /*****************************************************************************
@@ -268,10 +310,26 @@ void Trigger_fire(Trigger *t)
  *     t		Trigger in which to place event
  *     e		Event to be invoked when trigger fires.
  *
+ * Events are run in the reverse of the order in which they were queued, as
+ * they always have been.  The list is doubly linked so that it can become
+ * part of a time wheel slot without being walked.  On a worker of the
+ * parallel executor, the event is queued when the batch is merged.
+ *
  *****************************************************************************/
 void Trigger_enqueue(Trigger *t, Event *e)
 {
+  if (Parallel_inWorker()) {
+    ParWorker_defer(par_worker,t,e);
+    return;
+  }
+
+  e->ev_base.eb_prev = 0;
   e->ev_base.eb_next = t->t_events;
+  if (t->t_events)
+    t->t_events->ev_base.eb_prev = e;
+  else
+    t->t_eventsTail = e;
   t->t_events = e;
+  t->t_numEvents[Event_getType(e)]++;
 }
 
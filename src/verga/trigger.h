@@ -26,14 +26,18 @@
 struct Trigger_str {
   List/*Net*/		*t_posedges;	/* posedge triggers */
   List/*Net*/		*t_negedges;	/* negedge triggers */
+  List/*NetSlice*/	*t_slices;	/* triggers on a change in a slice of a net */
   Event			*t_events;	/* Events waiting for this trigger */
+  Event			*t_eventsTail;	/* Last event waiting for this trigger */
+  unsigned		t_numEvents[EV_NUMTYPES];/* Waiting events of each type */
+  unsigned		*t_level;	/* Levelized gates reading the trigger (ended by LZ_END) */
   Trigger		*t_next;	/* Next in hash bucket */
 };
 
-Trigger *new_Trigger(List *posedges,List *negedges,Trigger *next);
-uintptr_t Trigger_getHashCode(List *posedges,List *negedges);
-uintptr_t Trigger_sortAndGetHashCode(List *posedges,List *negedges);
-Trigger *Trigger_getTrigger(Trigger **tlist,List *posedges,List *negedges);
+Trigger *new_Trigger(List *posedges,List *negedges,List *slices,Trigger *next);
+uintptr_t Trigger_getHashCode(List *posedges,List *negedges,List *slices);
+uintptr_t Trigger_sortAndGetHashCode(List *posedges,List *negedges,List *slices);
+Trigger *Trigger_getTrigger(Trigger **tlist,List *posedges,List *negedges,List *slices);
 void Trigger_print(Trigger*,FILE *f);
 void Trigger_fire(Trigger*);
 void Trigger_enqueue(Trigger *t, Event *e);
@@ -33,7 +33,8 @@ static int sym_table_len = 8;
 
 static int value_print_showbits = 1;
 
-static struct value_fl *value_freePool = 0;
+static ValuePool value_mainPool = {0, 0};
+static thread_local ValuePool *value_pool = &value_mainPool;
 
 Strength&
 Strength::operator =(unsigned nettype)
@@ -69,10 +70,11 @@ Strength::operator =(unsigned nettype)
 Value *new_Value(int nbits)
 {
   struct value_fl *S;
-  static int fl_count = 0;
-  static int ma_count = 0;
+  static thread_local int fl_count = 0;
+  static thread_local int ma_count = 0;
 
-  if (!value_freePool) {
+  value_pool->vp_numOut++;
+  if (!value_pool->vp_free) {
     S = (struct value_fl*) malloc(sizeof(struct value_fl));
     if (nbits > 0)
       Value_init((Value*)S,nbits);
@@ -83,8 +85,8 @@ Value *new_Value(int nbits)
 #endif
     ma_count++;
   } else {
-    S = value_freePool;
-    value_freePool = value_freePool->next;
+    S = value_pool->vp_free;
+    value_pool->vp_free = S->next;
     fl_count++;
 #if DEBUG_VALUE_MEMMGR
     if (S->state.status != -1) {
@@ -113,8 +115,9 @@ Value *new_Value(int nbits)
 void delete_Value(Value *S)
 {
   struct value_fl *flS = (struct value_fl *)S;
-  flS->next = value_freePool;
-  value_freePool = flS;
+  flS->next = value_pool->vp_free;
+  value_pool->vp_free = flS;
+  value_pool->vp_numOut--;
 
 #if DEBUG_VALUE_MEMMGR
   if (S->status != 1 && S->status != 2) {
@@ -125,6 +128,45 @@ void delete_Value(Value *S)
 #endif
 }
 
+/*****************************************************************************
+ *
+ * Select the free list used by the calling thread
+ *
+ * Parameters:
+ *     P		Pool to use (null for the pool of the main thread)
+ *
+ *****************************************************************************/
+void Value_usePool(ValuePool *P)
+{
+  value_pool = P ? P : &value_mainPool;
+}
+
+/*****************************************************************************
+ *
+ * Give back to a pool the values taken from it
+ *
+ * Parameters:
+ *     P		Pool of another thread
+ *
+ * Values taken from P by its thread are mostly freed by the main thread
+ * into its own pool.  As many of them as P is short are moved back so that
+ * neither pool grows without bound.  Must be called from the main thread
+ * while the thread owning P is idle.
+ *
+ *****************************************************************************/
+void Value_settlePool(ValuePool *P)
+{
+  while (P->vp_numOut > 0 && value_mainPool.vp_free) {
+    struct value_fl *S = value_mainPool.vp_free;
+
+    value_mainPool.vp_free = S->next;
+    S->next = P->vp_free;
+    P->vp_free = S;
+    P->vp_numOut--;
+    value_mainPool.vp_numOut++;
+  }
+}
+
 /*****************************************************************************
  *
  * Make a value stored in the one[] array consistant in the other arrays.
@@ -142,6 +184,7 @@ void Value_normalize(Value *r)
     r->zero[i] = ~r->one[i];
     r->flt[i]  = 0;
   }
+  Value_setKnown(r);
 }
 
 /*
@@ -166,6 +209,41 @@ static StateSymbol charToSym(char c)
   return p;
 }
 
+/*
+ * Number of words in each plane of the inline storage of a Value
+ */
+#define VALUE_INLINEWORDS	SSNUMWORDS(THYMEVALUE_INLINEBITS)
+
+/*****************************************************************************
+ *
+ * Point the planes of a value at storage for wc words
+ *
+ * Parameters:
+ *     S		Value to set up
+ *     wc		Number of words in each plane
+ *
+ * Values that fit use the inline storage, others get one block holding all
+ * three planes.
+ *
+ *****************************************************************************/
+static void Value_allocPlanes(Value *S,int wc)
+{
+  ssword_t *block;
+  int stride;
+
+  if (wc <= VALUE_INLINEWORDS) {
+    block = S->bits;
+    stride = VALUE_INLINEWORDS;
+  } else {
+    block = (ssword_t*)malloc(3*wc*sizeof(ssword_t));
+    stride = wc;
+  }
+
+  S->one = block;
+  S->zero = block + stride;
+  S->flt = block + 2*stride;
+}
+
 void Value_init(Value *S,int nbits)
 {
   int wc = SSNUMWORDS(nbits);
@@ -175,27 +253,25 @@ void Value_init(Value *S,int nbits)
 #endif
   S->nbits = nbits;
   S->nalloc = wc;
-  S->one = (unsigned*)malloc(wc*sizeof(unsigned));
-  S->zero = (unsigned*)malloc(wc*sizeof(unsigned));
-  S->flt = (unsigned*)malloc(wc*sizeof(unsigned));
+  Value_allocPlanes(S,wc);
   S->flags = SF_NONE;
   S->permFlags = SF_NONE;
 }
 
 void Value_uninit(Value *S)
 {
-  free(S->one);
-  free(S->zero);
-  free(S->flt);
+  if (S->one != S->bits)
+    free(S->one);
 }
 
 void Value_reinit(Value *S,int nbits)
 {
   int nwc = SSNUMWORDS(nbits);
 
-  if (nwc <= S->nalloc) {
+  if (nwc <= S->nalloc || (nwc <= VALUE_INLINEWORDS && S->one == S->bits)) {
     S->nbits = nbits;
     S->nalloc = nwc;
+    Value_clearKnown(S);
   } else {
     Value_uninit(S);
     Value_init(S,nbits);
@@ -210,9 +286,9 @@ void Value_reinit(Value *S,int nbits)
 int Value_isPartZero(Value *A,int lowz)
 {
   int wc = SSNUMWORDS(lowz);
-  unsigned mask = (lowz&SSBITMASK) ? LMASK((lowz & SSBITMASK)) : SSWORDMASK;
+  ssword_t mask = (lowz&SSBITMASK) ? LMASK((lowz & SSBITMASK)) : SSWORDMASK;
   int wc2 = SSNUMWORDS(A->nbits);
-  unsigned mask2 = (A->nbits&SSBITMASK) ? LMASK((A->nbits & SSBITMASK)) : SSWORDMASK;
+  ssword_t mask2 = (A->nbits&SSBITMASK) ? LMASK((A->nbits & SSBITMASK)) : SSWORDMASK;
   int i;
 
   if (wc2 == wc)
@@ -243,9 +319,19 @@ int Value_isEqual(Value *A,Value *B)
 {
   unsigned nbits = imin(A->nbits, B->nbits);
   int wc = SSNUMWORDS(nbits);
-  unsigned mask = (nbits&SSBITMASK) ? LMASK((nbits & SSBITMASK)) : SSWORDMASK;
+  ssword_t mask = (nbits&SSBITMASK) ? LMASK((nbits & SSBITMASK)) : SSWORDMASK;
   int i;
 
+  /*
+   * Values of the same size with only 0 and 1 bits are equal if their one
+   * planes are.
+   */
+  if (A->nbits == B->nbits && Value_isKnown(A) && Value_isKnown(B)) {
+    for (i = 0;i < wc-1;i++)
+      if (A->one[i] != B->one[i]) return 0;
+    return ((A->one[wc-1] ^ B->one[wc-1]) & mask) == 0;
+  }
+
   /*
    * Check for equality up to smaller of a and b bit size.
    */
@@ -274,6 +360,14 @@ int Value_isEqual(Value *A,Value *B)
 
 transtype_t Value_transitionType(Value *A,Value *B)
 {
+  if (Value_nbits(A) == 1 && Value_nbits(B) == 1 && Value_isKnown(A) && Value_isKnown(B)) {
+    ssword_t from = A->one[0] & 1;
+    ssword_t to = B->one[0] & 1;
+
+    if (from == to) return TT_NONE;
+    return to ? TT_POSEDGE : TT_NEGEDGE;
+  }
+
   if (Value_nbits(A) == 1) {
     StateSymbol fromSym = Value_getBitSym(A,0);
     StateSymbol toSym   = Value_getBitSym(B,0);
@@ -290,52 +384,56 @@ transtype_t Value_transitionType(Value *A,Value *B)
   }
 }
 
-void Value_unknown(Value *S)
+/*****************************************************************************
+ *
+ * Set every word of the planes of S
+ *
+ * Parameters:
+ *     S		Value to set
+ *     one,zero,flt	Word to store in each plane
+ *
+ * The first word is stored before the loop so that the common one word
+ * value does not go through the memset the compiler makes of the loop.
+ *
+ *****************************************************************************/
+static inline void Value_fill(Value *S,ssword_t one,ssword_t zero,ssword_t flt)
 {
   int wc = SSNUMWORDS(S->nbits);
   int i;
 
-  for (i = 0;i < wc;i++) {
-    S->zero[i] = ~0;
-    S->one[i] = ~0;
-    S->flt[i] = ~0;
+  S->one[0] = one;
+  S->zero[0] = zero;
+  S->flt[0] = flt;
+  for (i = 1;i < wc;i++) {
+    S->one[i] = one;
+    S->zero[i] = zero;
+    S->flt[i] = flt;
   }
+
+  if (flt)
+    Value_clearKnown(S);
+  else
+    Value_setKnown(S);
 }
 
-void Value_float(Value *S)
+void Value_unknown(Value *S)
 {
-  int wc = SSNUMWORDS(S->nbits);
-  int i;
+  Value_fill(S,SSWORDMASK,SSWORDMASK,SSWORDMASK);
+}
 
-  for (i = 0;i < wc;i++) {
-    S->zero[i] = 0;
-    S->one[i] = 0;
-    S->flt[i] = ~0;
-  }
+void Value_float(Value *S)
+{
+  Value_fill(S,0,0,SSWORDMASK);
 }
 
 void Value_zero(Value *S)
 {
-  int wc = SSNUMWORDS(S->nbits);
-  int i;
-
-  for (i = 0;i < wc;i++) {
-    S->zero[i] = ~0;
-    S->one[i] = 0;
-    S->flt[i] = 0;
-  }
+  Value_fill(S,0,SSWORDMASK,0);
 }
 
 void Value_one(Value *S)
 {
-  int wc = SSNUMWORDS(S->nbits);
-  int i;
-
-  for (i = 0;i < wc;i++) {
-    S->one[i] = ~0;
-    S->flt[i] = 0;
-    S->zero[i] = 0;
-  }
+  Value_fill(S,SSWORDMASK,0,0);
 }
 
 /*****************************************************************************
@@ -350,30 +448,58 @@ void Value_lone(Value *S)
   S->zero[0] &= ~1;
 }
 
-int Value_isLogic(Value *S)
+int Value_scanLogic(Value *S)
 {
   register int i;
-  register unsigned mask = SSWORDMASK;
+  register ssword_t mask = SSWORDMASK;
   register int wc = SSNUMWORDS(S->nbits);
 
   for (i = 0;i < wc;i++) {
     if (i == wc-1 && (S->nbits & SSBITMASK))
-      mask = LMASK(S->nbits);
+      mask = LMASK(S->nbits & SSBITMASK);
 
-    if ((S->flt[i] & mask)) return 0;
+    if ((S->flt[i] & mask)) {
+      Value_clearKnown(S);
+      return 0;
+    }
   }
+  Value_setKnown(S);
   return 1;
 }
 
+#if DEBUG_VALUE_KNOWN
+/*****************************************************************************
+ *
+ * Check that a value with SF_KNOWN set has only 0 and 1 bits.
+ *
+ *****************************************************************************/
+int Value_checkKnown(Value *S)
+{
+  int wc = SSNUMWORDS(S->nbits);
+  ssword_t mask = (S->nbits&SSBITMASK) ? LMASK(S->nbits&SSBITMASK) : SSWORDMASK;
+  int i;
+
+  for (i = 0;i < wc;i++) {
+    ssword_t m = (i == wc-1) ? mask : SSWORDMASK;
+
+    if ((S->flt[i] & m)) {
+      vgio_echo("value with SF_KNOWN has x/z bits.\n");
+      abort();
+    }
+  }
+  return 1;
+}
+#endif
+
 int Value_isZero(Value *S)
 {
   register int i;
-  register unsigned mask = SSWORDMASK;
+  register ssword_t mask = SSWORDMASK;
   register int wc = SSNUMWORDS(S->nbits);
 
   for (i = 0;i < wc;i++) {
     if (i == wc-1 && (S->nbits & SSBITMASK))
-      mask = LMASK(S->nbits);
+      mask = LMASK(S->nbits & SSBITMASK);
 
     if (((S->flt[i] & mask) != 0)
 	|| ((S->one[i] & mask) != 0)
@@ -387,12 +513,12 @@ int Value_isZero(Value *S)
 int Value_isFloat(Value *S)
 {
   register int i;
-  register unsigned mask = SSWORDMASK;
+  register ssword_t mask = SSWORDMASK;
   register int wc = SSNUMWORDS(S->nbits);
 
   for (i = 0;i < wc;i++) {
     if (i == wc-1 && (S->nbits & SSBITMASK))
-      mask = LMASK(S->nbits);
+      mask = LMASK(S->nbits & SSBITMASK);
 
     if (((S->flt[i] & mask) != mask)
 	|| ((S->one[i] & mask) != 0)
@@ -405,12 +531,12 @@ int Value_isFloat(Value *S)
 int Value_isUnknown(Value *S)
 {
   register int i;
-  register unsigned mask = SSWORDMASK;
+  register ssword_t mask = SSWORDMASK;
   register int wc = SSNUMWORDS(S->nbits);
 
   for (i = 0;i < wc;i++) {
     if (i == wc-1 && (S->nbits & SSBITMASK))
-      mask = LMASK(S->nbits);
+      mask = LMASK(S->nbits & SSBITMASK);
 
     if (((S->flt[i] & mask) != mask)
 	|| ((S->one[i] & mask) != mask)
@@ -428,7 +554,7 @@ Boolean Value_hasUnknown(Value *S)
 
 	for (i = 0; i < wordCount; ++i) {
 		if (i == wordCount-1 && (S->nbits & SSBITMASK)) {
-			unsigned mask = LMASK(S->nbits);
+			ssword_t mask = LMASK(S->nbits & SSBITMASK);
 			if (S->flt[i] & S->zero[i] & S->one[i] & mask)
 				return TRUE;
 		} else if (S->flt[i] & S->zero[i] & S->one[i])
@@ -445,7 +571,7 @@ Boolean Value_hasFloat(Value *S)
 
 	for (i = 0; i < wordCount; ++i) {
 		if (i == wordCount-1 && (S->nbits & SSBITMASK)) {
-			unsigned mask = LMASK(S->nbits);
+			ssword_t mask = LMASK(S->nbits & SSBITMASK);
 			if (S->flt[i] & ~(S->zero[i] | S->one[i]) & mask)
 				return TRUE;
 		} else if (S->flt[i] & ~(S->zero[i] | S->one[i]))
@@ -464,19 +590,16 @@ void Value_xclear(Value *S)
     S->flt[i] = 0;
     S->zero[i] = 0;
   }
+  Value_clearKnown(S);
 }
 
-StateSymbol Value_getBitSym(Value *S,int i)
+/*
+ * Symbol of the bit b of word w of S
+ */
+static inline StateSymbol Value_wordSym(Value *S,int w,ssword_t b)
 {
-  int w;
-  unsigned b;
   StateSymbol x = SYM_NUL1;
 
-  if (i >= S->nbits)
-    return SYM_ZERO;
-
-  w = i >> SSWORDSHIFT;
-  b = 1 << (i & SSBITMASK);
   if ((S->zero[w] & b)) x = (StateSymbol)(x | SYM_ZERO);
   if ((S->one[w] & b))  x = (StateSymbol)(x | SYM_ONE);
   if ((S->flt[w] & b))  x = (StateSymbol)(x | SYM_FLOAT);
@@ -484,18 +607,29 @@ StateSymbol Value_getBitSym(Value *S,int i)
   return x;
 }
 
+StateSymbol Value_getBitSym(Value *S,int i)
+{
+  if (i >= S->nbits)
+    return SYM_ZERO;
+
+  return Value_wordSym(S,i >> SSWORDSHIFT,(ssword_t)1 << (i & SSBITMASK));
+}
+
 void Value_putBitSym(Value *S,int bit,StateSymbol p)
 {
   int w;
-  unsigned b;
+  ssword_t b;
 
   if (bit >= S->nbits) return;
 
   w = bit >> SSWORDSHIFT;
-  b = 1 << (bit & SSBITMASK);
+  b = (ssword_t)1 << (bit & SSBITMASK);
   if ((p & SYM_ZERO)) S->zero[w] |= b; else S->zero[w] &= ~b;
   if ((p & SYM_ONE)) S->one[w] |= b; else S->one[w] &= ~b;
   if ((p & SYM_FLOAT)) S->flt[w] |= b; else S->flt[w] &= ~b;
+
+  if (p != SYM_ZERO && p != SYM_ONE)
+    Value_clearKnown(S);
 }
 
 /*****************************************************************************
@@ -538,12 +672,19 @@ void Value_resize(Value *R,int nbits)
     int ob = R->nbits;
     int nwc = SSNUMWORDS(nbits);
 
-    if (nwc > R->nalloc) {
-      R->nalloc = nwc;
-      R->zero = (unsigned*) realloc(R->zero,nwc*sizeof(unsigned));
-      R->one  = (unsigned*) realloc(R->one,nwc*sizeof(unsigned));
-      R->flt  = (unsigned*) realloc(R->flt,nwc*sizeof(unsigned));
+    if (nwc > R->nalloc && (nwc > VALUE_INLINEWORDS || R->one != R->bits)) {
+      ssword_t *one = R->one, *zero = R->zero, *flt = R->flt;
+      size_t n = R->nalloc*sizeof(ssword_t);
+
+      Value_allocPlanes(R,nwc);
+      memcpy(R->one,one,n);
+      memcpy(R->zero,zero,n);
+      memcpy(R->flt,flt,n);
+      if (one != R->bits)
+	free(one);
     }
+    if (nwc > R->nalloc)
+      R->nalloc = nwc;
     R->nbits = nbits;
 
     Value_extendSym(R,ob,SYM_ZERO);
@@ -568,6 +709,8 @@ int Value_toReal(Value *S,real_t *n)
 
   if (Value_isReal(S)) {
     *n = *(real_t*)&S->one[0];
+  } else if (S->nbits < SSWORDSIZE) {
+    *n = (real_t)(S->one[0] & LMASK(S->nbits));
   } else {
     *n = (real_t)S->one[0];
   }
@@ -728,7 +871,7 @@ int Value_convertDec(Value *S,const char *p,int nbits)
      * Value is short enough to fit into 32 bit value
      */
     if (S->nbits == 0)
-      Value_reinit(S,SSWORDSIZE);
+      Value_reinit(S,SSINTSIZE);
     else
       Value_reinit(S,nbits);
 
@@ -738,7 +881,7 @@ int Value_convertDec(Value *S,const char *p,int nbits)
     }
     S->one[0] = n;
     if (nbits == 0)
-      S->nbits = SSWORDSIZE;
+      S->nbits = SSINTSIZE;
   } else {
     const double K = 3.32192809488736234791;	/* 1/log10(2) */
     int reqbits = (int)(l*K+1);			/* Estimated bits required */
@@ -753,11 +896,17 @@ int Value_convertDec(Value *S,const char *p,int nbits)
     multint_cvtstr(S->one,wc,p);
 
     /*
-     * Readjust size if automatic sizing is used.
+     * Readjust size if automatic sizing is used.  The size is rounded up
+     * to a whole number of integers.
      */
     if (nbits == 0) {
+      ssword_t w;
+      int b;
+
       while (S->one[wc-1] == 0 && wc > 1) wc--;
-      S->nbits = wc*SSWORDSIZE;
+      b = (wc-1)*SSWORDSIZE;
+      for (w = S->one[wc-1];w;w >>= 1) b++;
+      S->nbits = imax((b+SSINTSIZE-1)/SSINTSIZE,1)*SSINTSIZE;
     }
   }
 
@@ -821,6 +970,7 @@ int Value_convert(Value *S,const char *A)
     *S->one = *S->zero = *S->flt = 0;
     return -1;
   }
+  Value_scanLogic(S);
 
   return return_value;
 }
@@ -831,12 +981,13 @@ int Value_convertFromInt(Value *S,unsigned I)
   S->one[0] = I;
   S->zero[0] = ~I;
   S->flt[0] = 0;
+  Value_setKnown(S);
   return 0;
 }
 
 /*****************************************************************************
  *
- * Convert an integer to a 32-bit/64-bit Value
+ * Convert an integer to a 32-bit Value
  *
  * Parameters:
  *     S		Target state value in which to store scanned value
@@ -845,10 +996,10 @@ int Value_convertFromInt(Value *S,unsigned I)
  *****************************************************************************/
 int Value_convertI(Value *S,int n)
 {
-  Value_resize(S,SSWORDSIZE);
-  S->flags = SF_INT;
-  S->one[0] = n;
-  S->zero[0] = ~n;
+  Value_resize(S,SSINTSIZE);
+  S->flags = (ValueFlags)(SF_INT|SF_KNOWN);
+  S->one[0] = (unsigned)n;
+  S->zero[0] = ~(unsigned)n;
   S->flt[0] = 0;
 
   return 0;
@@ -908,9 +1059,9 @@ int Value_convertNaN(Value *S)
 int Value_convertTime(Value *S,simtime_t n)
 {
   Value_resize(S,sizeof(simtime_t)*8);
-  S->flags = SF_INT;
+  S->flags = (ValueFlags)(SF_INT|SF_KNOWN);
 
-#if TKGATE_WORDSIZE == 64
+#if SSWORDSIZE == 64
   S->one[0] = n;
   S->zero[0] = ~n;
   S->flt[0] = 0;
@@ -951,7 +1102,7 @@ int Value_convertStr(Value *S,const char *str)
     for (j = 0;j < SSWORDBYTES;j++) {
       const char *cstart = s_end-SSWORDBYTES*i-j;
       if (cstart >= str)
-	S->one[i] |= (*cstart & 0xff) << 8*j;
+	S->one[i] |= (ssword_t)(*cstart & 0xff) << 8*j;
     }
   }
 
@@ -988,6 +1139,7 @@ static int Value_getstr_str(Value *S,char *p,int prefix)
   for (i = wc-1;i >= 0;i--) {
     for (j = SSWORDBYTES-1;j >= 0;j--) {
       unsigned c = (S->one[i] >> (j*8)) & 0xff;
+      if (8*(i*SSWORDBYTES+j) >= S->nbits) continue;
       if (c) {
 	if (prefix && (c == '"' || c == '\\')) *p++ = '\\';
 	*p++ = c;
@@ -1025,12 +1177,13 @@ static int Value_getstr_int(Value *S,char *str)
 	sprintf(str, "Z");
   else if (Value_isLogic(S)) {
     if (Value_nbits(S) <= SSWORDSIZE) {
-      sprintf(str,"%u",S->one[0]&LMASK(Value_nbits(S)));
+      sprintf(str,"%llu",(unsigned long long)(S->one[0]&LMASK(Value_nbits(S))));
     } else {
       int wc = SSNUMWORDS(S->nbits);
 
-      S->one[wc-1] &= LMASK(Value_nbits(S));
-      multint_getstr(S->one,wc,str,1024);
+      if ((S->nbits & SSBITMASK))
+	S->one[wc-1] &= LMASK(S->nbits & SSBITMASK);
+      multint_getstr(S->one,wc,str,S->nbits/3+2);
     }
   } else
   /** @TODO generate Verga error  */
@@ -1044,7 +1197,7 @@ static int Value_getstr_time(Value *S,char *p)
 {
   if (Value_isLogic(S)) {
 #if SSWORDSIZE == 64
-    sprintf(p,"%u",S->one[0]&LMASK(Value_nbits(S)));
+    sprintf(p,"%llu",(unsigned long long)(S->one[0]&LMASK(Value_nbits(S))));
 #else
     if (Value_nbits(S) <= SSWORDSIZE) {
       sprintf(p,"%u",S->one[0]&LMASK(Value_nbits(S)));
@@ -1066,7 +1219,7 @@ static int Value_getstr_dec(Value *S,char *p,int prefix)
 
   if (Value_isLogic(S)) {
     if (Value_nbits(S) <= SSWORDSIZE)
-      sprintf(p,"%u",S->one[0]&LMASK(Value_nbits(S)));
+      sprintf(p,"%llu",(unsigned long long)(S->one[0]&LMASK(Value_nbits(S))));
     else
       Value_getstr_int(S,p);
   } else
@@ -1484,6 +1637,8 @@ void Value_copy(Value *r,Value *a)
   int i;
 
   r->flags = a->flags;
+  if (a->nbits < r->nbits)
+    Value_clearKnown(r);
 
   for (i = 0;i < wc;i++) {
     r->one[i] = a->one[i];
@@ -1492,33 +1647,141 @@ void Value_copy(Value *r,Value *a)
   }
 }
 
-transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
+/*
+ * Clear n words of a mask of changed bits.  As in Value_fill(), the first
+ * word is stored before the loop to keep short masks out of memset.
+ */
+static inline void Value_clearChanged(ssword_t *changed,int n)
+{
+  int i;
+
+  if (n <= 0) return;
+  changed[0] = 0;
+  for (i = 1;i < n;i++)
+    changed[i] = 0;
+}
+
+transtype_t Value_update(Value *R,Value *A,ssword_t *changed)
+{
+  int wc = SSNUMWORDS(R->nbits);
+  ssword_t mask = (R->nbits&SSBITMASK) ? LMASK(R->nbits&SSBITMASK) : SSWORDMASK;
+  transtype_t tt = TT_NONE;
+  int known;
+  int i, j;
+
+  /*
+   * Values of different sizes compare as Value_isEqual() extends them.
+   */
+  if (R->nbits != A->nbits) {
+    tt = Value_transitionType(R,A);
+    if (tt != TT_NONE)
+      Value_copy(R,A);
+    if (changed && tt != TT_NONE)
+      for (i = 0;i < wc;i++)
+	changed[i] = SSWORDMASK;
+    return tt;
+  }
+
+  if (R->nbits == 1) {
+    if (!(((R->one[0] ^ A->one[0]) | (R->zero[0] ^ A->zero[0]) | (R->flt[0] ^ A->flt[0])) & 1))
+      return TT_NONE;
+
+    tt = Value_transitionType(R,A);
+    R->flags = A->flags;
+    R->one[0] = A->one[0];
+    R->zero[0] = A->zero[0];
+    R->flt[0] = A->flt[0];
+    if (changed) changed[0] = 1;
+    return tt;
+  }
+
+  /*
+   * Find the first word that differs.  Known values are compared on their
+   * one planes only.
+   */
+  known = Value_isKnown(R) && Value_isKnown(A);
+  if (known) {
+    for (i = 0;i < wc-1 && R->one[i] == A->one[i];i++);
+    if (i == wc-1 && !((R->one[i] ^ A->one[i]) & mask))
+      return TT_NONE;
+  } else {
+    for (i = 0;i < wc-1 && R->one[i] == A->one[i] && R->zero[i] == A->zero[i] && R->flt[i] == A->flt[i];i++);
+    if (i == wc-1 && !(((R->one[i] ^ A->one[i]) | (R->zero[i] ^ A->zero[i]) | (R->flt[i] ^ A->flt[i])) & mask))
+      return TT_NONE;
+  }
+
+  /*
+   * Store the remaining words, recording the bits that change.
+   */
+  if (changed) {
+    Value_clearChanged(changed,i);
+    for (j = i;j < wc;j++) {
+      if (known)
+	changed[j] = R->one[j] ^ A->one[j];
+      else
+	changed[j] = (R->one[j] ^ A->one[j]) | (R->zero[j] ^ A->zero[j]) | (R->flt[j] ^ A->flt[j]);
+    }
+    changed[wc-1] &= mask;
+  }
+  for (;i < wc;i++) {
+    R->one[i] = A->one[i];
+    R->zero[i] = A->zero[i];
+    R->flt[i] = A->flt[i];
+  }
+  R->flags = A->flags;
+
+  return TT_EDGE;
+}
+
+transtype_t Value_updateRange(Value *R,int rl,Value *A,int ah,int al,ssword_t *changed)
 {
   transtype_t tt = TT_NONE;
   int rh = rl+(ah-al);						/* High bit of target in R */
+  int known;
+
+  /*
+   * R is left with only 0 and 1 bits if the copied bits are and so are any
+   * bits of R that are not replaced.
+   */
+  known = Value_isKnown(A) && ah < A->nbits
+    && (Value_isKnown(R) || (rl == 0 && rh >= R->nbits-1));
 
   if (ah == al) {
     /*
      * Special case for one-bit copy.
      */
-    StateSymbol fromSym = Value_getBitSym(R,rl);
-    StateSymbol toSym   = Value_getBitSym(A,ah);
+    StateSymbol fromSym = SYM_ZERO, toSym = SYM_ZERO;
+    int rw = rl >> SSWORDSHIFT;
+    ssword_t rb = (ssword_t)1 << (rl & SSBITMASK);
 
     R->flags = (ValueFlags)(R->flags | A->flags);
 
-    if (fromSym == toSym)
-      tt = TT_NONE;
-    else if (toSym == SYM_ZERO)
-      tt = TT_NEGEDGE;
-    else if (fromSym == SYM_ONE && toSym != SYM_FLOAT)
-      tt = TT_NEGEDGE;
-    else
-      tt = TT_POSEDGE;
+    if (rl < R->nbits)
+      fromSym = Value_wordSym(R,rw,rb);
+    if (ah < A->nbits)
+      toSym = Value_wordSym(A,ah >> SSWORDSHIFT,(ssword_t)1 << (ah & SSBITMASK));
 
-    if (Value_nbits(R) != 1 && tt != TT_NONE)
-      tt = TT_EDGE;
+    /*
+     * Nothing is stored unless the bit changes.
+     */
+    if (fromSym != toSym) {
+      if (toSym == SYM_ZERO)
+	tt = TT_NEGEDGE;
+      else if (fromSym == SYM_ONE && toSym != SYM_FLOAT)
+	tt = TT_NEGEDGE;
+      else
+	tt = TT_POSEDGE;
+
+      if (Value_nbits(R) != 1)
+	tt = TT_EDGE;
+      if (changed && rl < R->nbits) {
+	Value_clearChanged(changed,rw);
+	changed[rw] = rb;
+	Value_clearChanged(changed+rw+1,SSNUMWORDS(R->nbits)-rw-1);
+      }
 
-    Value_putBitSym(R,rl,toSym);
+      Value_putBitSym(R,rl,toSym);
+    }
   } else {
     int rl_w = rl >> SSWORDSHIFT;
     int rl_b = rl & SSBITMASK;
@@ -1535,7 +1798,7 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
        *****************************************************************************/
       src_w = al_w;
       for (dst_w = rl_w; dst_w <= rh_w; dst_w++, src_w++) {
-	unsigned rone, rzero, rflt, mask;
+	ssword_t rone, rzero, rflt, mask, d;
 
 	/*
 	 * "mask" is a mask of bits in R that should change in this word.
@@ -1551,7 +1814,12 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
 	/*
 	 * If any bits of R changed, update the value and record this as an edge.
 	 */
-	if ((rone ^ R->one[dst_w]) || (rzero ^ R->zero[dst_w]) || (rflt ^ R->flt[dst_w]) ) {
+	d = (rone ^ R->one[dst_w]) | (rzero ^ R->zero[dst_w]) | (rflt ^ R->flt[dst_w]);
+	if (changed && (d || tt != TT_NONE)) {
+	  if (tt == TT_NONE) Value_clearChanged(changed,dst_w);
+	  changed[dst_w] = d;
+	}
+	if (d) {
 	  tt = TT_EDGE;
 	  R->one[dst_w]  = rone;
 	  R->zero[dst_w] = rzero;
@@ -1567,7 +1835,7 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
 
       src_w = al_w;
       for (dst_w = rl_w; dst_w <= rh_w; dst_w++, src_w++) {
-	unsigned aone, azero, aflt, rone, rzero, rflt, mask;
+	ssword_t aone, azero, aflt, rone, rzero, rflt, mask, d;
     if (src_w < A->nalloc) {
 	  aone  = A->one[src_w] << b_up;
 	  azero = A->zero[src_w] << b_up;
@@ -1598,7 +1866,12 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
 	/*
 	 * If any bits an R changed, update the value and record this as an edge.
 	 */
-	if ((rone ^ R->one[dst_w]) || (rzero ^ R->zero[dst_w]) || (rflt ^ R->flt[dst_w]) ) {
+	d = (rone ^ R->one[dst_w]) | (rzero ^ R->zero[dst_w]) | (rflt ^ R->flt[dst_w]);
+	if (changed && (d || tt != TT_NONE)) {
+	  if (tt == TT_NONE) Value_clearChanged(changed,dst_w);
+	  changed[dst_w] = d;
+	}
+	if (d) {
 	  tt = TT_EDGE;
 	  R->one[dst_w]  = rone;
 	  R->zero[dst_w] = rzero;
@@ -1615,7 +1888,7 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
 
       src_w = al_w;
       for (dst_w = rl_w; dst_w <= rh_w; dst_w++, src_w++) {
-	unsigned aone, azero, aflt, rone, rzero, rflt, mask;
+	ssword_t aone, azero, aflt, rone, rzero, rflt, mask, d;
 
 	aone  = A->one[src_w] >> b_dn;
 	azero = A->zero[src_w] >> b_dn;
@@ -1640,7 +1913,12 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
 	/*
 	 * If any bits an R changed, update the value and record this as an edge.
 	 */
-	if ((rone ^ R->one[dst_w]) || (rzero ^ R->zero[dst_w]) || (rflt ^ R->flt[dst_w]) ) {
+	d = (rone ^ R->one[dst_w]) | (rzero ^ R->zero[dst_w]) | (rflt ^ R->flt[dst_w]);
+	if (changed && (d || tt != TT_NONE)) {
+	  if (tt == TT_NONE) Value_clearChanged(changed,dst_w);
+	  changed[dst_w] = d;
+	}
+	if (d) {
 	  tt = TT_EDGE;
 	  R->one[dst_w]  = rone;
 	  R->zero[dst_w] = rzero;
@@ -1649,6 +1927,18 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
       }
     }
   }
+
+  /*
+   * Words of R above the copied range did not change.
+   */
+  if (changed && tt != TT_NONE && ah != al)
+    Value_clearChanged(changed+(rh>>SSWORDSHIFT)+1,SSNUMWORDS(R->nbits)-(rh>>SSWORDSHIFT)-1);
+
+  if (known)
+    Value_setKnown(R);
+  else
+    Value_clearKnown(R);
+
   return tt;
 }
 
@@ -1673,20 +1963,21 @@ transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al)
  * H|x 1 x H x H      H|1 1 1 1 1 1      H|1 0 1 0 1 0      H|1 0 1 1 1 1  011
  *
  *****************************************************************************/
+void Value_wireResolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong)
+{
+  R->one[w]  = isOne;
+  R->zero[w] = isZero;
+  R->flt[w]  = ~(isOne ^ isZero) | hasFloat;
+}
+
 void Value_wire(Value *R,Value *A,Value *B)
 {
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
-  for (i = 0;i < wc;i++) {
-    register unsigned RisOne = A->one[i]|B->one[i];
-    register unsigned RisZero = A->zero[i]|B->zero[i];
-    register unsigned RhasFloat = (A->flt[i]&B->flt[i]);
-
-    R->one[i]  = RisOne;
-    R->zero[i] = RisZero;
-    R->flt[i]  = ~(RisOne ^ RisZero) | RhasFloat;
-  }
+  for (i = 0;i < wc;i++)
+    Value_wireResolve(R,i,A->one[i]|B->one[i],A->zero[i]|B->zero[i],A->flt[i]&B->flt[i],0);
+  Value_scanLogic(R);
 }
 
 /*****************************************************************************
@@ -1709,21 +2000,24 @@ void Value_wire(Value *R,Value *A,Value *B)
  * H|0 1 x H x H     H|0 1 1 1 1 1      H|1 0 1 0 1 0      H|0 0 1 1 1 1  011
  *
  */
+void Value_wandResolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong)
+{
+  R->one[w]  = isOne & ~isStrong;
+  R->zero[w] = isZero;
+  R->flt[w]  = (~(isOne ^ isZero) | hasFloat) & ~isStrong;
+}
+
 void Value_wand(Value *R,Value *A,Value *B)
 {
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
   for (i = 0;i < wc;i++) {
-    register unsigned RisOne = A->one[i]|B->one[i];
-    register unsigned RisZero = A->zero[i]|B->zero[i];
-    register unsigned RhasFloat = (A->flt[i]&B->flt[i]);
-    register unsigned Rzero = (~A->one[i]&A->zero[i]&~A->flt[i]) | (~B->one[i]&B->zero[i]&~B->flt[i]);
-
-    R->one[i]  = RisOne & ~Rzero;
-    R->zero[i] = RisZero;
-    R->flt[i]  = (~(RisOne ^ RisZero) | RhasFloat) & ~Rzero;
+    register ssword_t Rzero = (~A->one[i]&A->zero[i]&~A->flt[i]) | (~B->one[i]&B->zero[i]&~B->flt[i]);
+
+    Value_wandResolve(R,i,A->one[i]|B->one[i],A->zero[i]|B->zero[i],A->flt[i]&B->flt[i],Rzero);
   }
+  Value_scanLogic(R);
 }
 
 /*****************************************************************************
@@ -1745,21 +2039,24 @@ void Value_wand(Value *R,Value *A,Value *B)
  * L|0 1 x L L x     L|0 1 1 0 0 1      L|1 0 1 1 1 1      L|0 0 1 1 1 1  101
  * H|x 1 x H x H     H|1 1 1 1 1 1      H|1 0 1 0 1 0      H|1 0 1 1 1 1  011
  */
+void Value_worResolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong)
+{
+  R->one[w]  = isOne;
+  R->zero[w] = isZero & ~isStrong;
+  R->flt[w]  = (~(isOne ^ isZero) | hasFloat) & ~isStrong;
+}
+
 void Value_wor(Value *R,Value *A,Value *B)
 {
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
   for (i = 0;i < wc;i++) {
-    register unsigned RisOne = A->one[i]|B->one[i];
-    register unsigned RisZero = A->zero[i]|B->zero[i];
-    register unsigned RhasFloat = (A->flt[i]&B->flt[i]);
-    register unsigned Rone = (A->one[i]&~A->zero[i]&~A->flt[i]) | (B->one[i]&~B->zero[i]&~B->flt[i]);
-
-    R->one[i]  = RisOne;
-    R->zero[i] = RisZero & ~Rone;
-    R->flt[i]  = (~(RisOne ^ RisZero) | RhasFloat) & ~Rone;
+    register ssword_t Rone = (A->one[i]&~A->zero[i]&~A->flt[i]) | (B->one[i]&~B->zero[i]&~B->flt[i]);
+
+    Value_worResolve(R,i,A->one[i]|B->one[i],A->zero[i]|B->zero[i],A->flt[i]&B->flt[i],Rone);
   }
+  Value_scanLogic(R);
 }
 
 
@@ -1782,21 +2079,32 @@ void Value_wor(Value *R,Value *A,Value *B)
  * L|0 x x 0 0 x
  * H|x 1 x x x x
  */
+void Value_tri0Resolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong)
+{
+  ssword_t conflict = isOne & (isZero | hasFloat);
+
+  R->one[w]  = conflict | isOne;
+  R->zero[w] = conflict | ~isOne;
+  R->flt[w]  = conflict;
+}
+
 void Value_tri0(Value *R,Value *A,Value *B)
 {
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
-  for (i = 0;i < wc;i++) {
-    register unsigned RisOne = A->one[i]|B->one[i];
-    register unsigned RisZero = A->zero[i]|B->zero[i];
-    register unsigned RhasFloat = (A->flt[i]&B->flt[i]);
-    register unsigned Rconflict = RisOne & (RisZero | RhasFloat);
-
-    R->one[i]  = Rconflict | RisOne;
-    R->zero[i] = Rconflict | ~RisOne;
-    R->flt[i]  = Rconflict;
-  }
+  for (i = 0;i < wc;i++)
+    Value_tri0Resolve(R,i,A->one[i]|B->one[i],A->zero[i]|B->zero[i],A->flt[i]&B->flt[i],0);
+  Value_scanLogic(R);
+}
+
+void Value_tri1Resolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong)
+{
+  ssword_t conflict = isZero & (isOne | hasFloat);
+
+  R->one[w]  = conflict | ~isZero;
+  R->zero[w] = conflict | isZero;
+  R->flt[w]  = conflict;
 }
 
 void Value_tri1(Value *R,Value *A,Value *B)
@@ -1804,16 +2112,9 @@ void Value_tri1(Value *R,Value *A,Value *B)
   int wc = SSNUMWORDS(R->nbits);
   register int i;
 
-  for (i = 0;i < wc;i++) {
-    register unsigned RisOne = A->one[i]|B->one[i];
-    register unsigned RisZero = A->zero[i]|B->zero[i];
-    register unsigned RhasFloat = (A->flt[i]&B->flt[i]);
-    register unsigned Rconflict = RisZero & (RisOne | RhasFloat);
-
-    R->one[i]  = Rconflict | ~RisZero;
-    R->zero[i] = Rconflict | RisZero;
-    R->flt[i]  = Rconflict;
-  }
+  for (i = 0;i < wc;i++)
+    Value_tri1Resolve(R,i,A->one[i]|B->one[i],A->zero[i]|B->zero[i],A->flt[i]&B->flt[i],0);
+  Value_scanLogic(R);
 }
 
 void Value_trireg(Value *R,Value *A,Value *B)
@@ -1822,17 +2123,18 @@ void Value_trireg(Value *R,Value *A,Value *B)
   register int i;
 
   for (i = 0;i < wc;i++) {
-    register unsigned Aone = A->one[i];
-    register unsigned Azero = A->zero[i];
-    register unsigned Afloat = A->flt[i];
-    register unsigned Bzero = B->zero[i];
-    register unsigned Bone = B->one[i];
-    register unsigned Bfloat = B->flt[i];
+    register ssword_t Aone = A->one[i];
+    register ssword_t Azero = A->zero[i];
+    register ssword_t Afloat = A->flt[i];
+    register ssword_t Bzero = B->zero[i];
+    register ssword_t Bone = B->one[i];
+    register ssword_t Bfloat = B->flt[i];
 
     R->one[i]  = (~Afloat & Aone)  | (Afloat & ~(~Bone & ~Aone));
     R->zero[i] = (~Afloat & Azero) | (Afloat & ~(~Bzero & ~Azero));
     R->flt[i]  = (Afloat & Bfloat) |  (R->one[i]&R->zero[i]);
   }
+  Value_scanLogic(R);
 }
 
 
@@ -1853,7 +2155,8 @@ void Value_trireg(Value *R,Value *A,Value *B)
 void Value_roll(Value *R,Value *I,int n)
 {
   int bits = R->nbits;
-  unsigned mask = (bits<SSWORDSIZE) ? ((1<<bits)-1) : ~0;
+  ssword_t mask = (bits<SSWORDSIZE) ? (((ssword_t)1<<bits)-1) : ~0;
+  int known = Value_isKnown(I) && I->nbits >= bits;
 
   if (n < 0)
     n += bits;
@@ -1862,7 +2165,7 @@ void Value_roll(Value *R,Value *I,int n)
   assert(n >= 0);
 
   if (n > 0) {
-    unsigned emask = (n<SSWORDSIZE) ? ((1<<n)-1) : ~0;
+    ssword_t emask = (n<SSWORDSIZE) ? (((ssword_t)1<<n)-1) : ~0;
 
     R->one[0] = (I->one[0] << n) | ((I->one[0] >> (bits-n)) & emask);
     R->zero[0] = (I->zero[0] << n) | ((I->zero[0] >> (bits-n)) & emask);
@@ -1876,6 +2179,11 @@ void Value_roll(Value *R,Value *I,int n)
   R->one[0] &= mask;
   R->zero[0] &= mask;
   R->flt[0] &= mask;
+
+  if (known)
+    Value_setKnown(R);
+  else
+    Value_clearKnown(R);
 }
 
 
@@ -1896,7 +2204,8 @@ void Value_roll(Value *R,Value *I,int n)
  *****************************************************************************/
 void Value_w_shift(Value *R,Value *I,int n,int in1,int in0,int inZ)
 {
-  unsigned mask = LMASK(R->nbits);
+  ssword_t mask = LMASK(R->nbits);
+  int known = Value_isKnown(I) && I->nbits >= R->nbits && !inZ && in1 != in0;
 
   /* special case */
   if (std::abs(n) >= R->nbits) {
@@ -1905,16 +2214,16 @@ void Value_w_shift(Value *R,Value *I,int n,int in1,int in0,int inZ)
   }
 
   if (n > 0) {
-    unsigned emask = (n<SSWORDSIZE) ? ((1<<n)-1) : ~0;
+    ssword_t emask = (n<SSWORDSIZE) ? (((ssword_t)1<<n)-1) : ~0;
 
     R->one[0] = (I->one[0] << n) | (in1*emask);
     R->zero[0] = (I->zero[0] << n) | (in0*emask);
     R->flt[0] = (I->flt[0] << n) | (inZ*emask);
   } else if (n < 0) {
-    unsigned emask;
+    ssword_t emask;
 
     n = -n;
-    emask = ((n<SSWORDSIZE) ? ((1<<n)-1) : ~0) << (R->nbits-n);
+    emask = ((n<SSWORDSIZE) ? (((ssword_t)1<<n)-1) : ~0) << (R->nbits-n);
 
     I->one[0] &= mask;
     I->zero[0] &= mask;
@@ -1932,6 +2241,25 @@ void Value_w_shift(Value *R,Value *I,int n,int in1,int in0,int inZ)
   R->one[0] &= mask;
   R->zero[0] &= mask;
   R->flt[0] &= mask;
+
+  if (known)
+    Value_setKnown(R);
+  else
+    Value_clearKnown(R);
+}
+
+/*
+ * Word j of plane P of a value of iwc words for a right shift.  Bits above
+ * the top of the value, which are outside tmask in its top word, read as the
+ * shift-in value in.
+ */
+static inline ssword_t Value_shiftWord(const ssword_t *P,int j,int iwc,ssword_t tmask,ssword_t in)
+{
+  if (j >= iwc)
+    return in;
+  if (j == iwc-1)
+    return (P[j] & tmask) | (in & ~tmask);
+  return P[j];
 }
 
 /*****************************************************************************
@@ -1946,6 +2274,7 @@ void Value_shift(Value *R,Value *I,int n,int in1,int in0,int inZ) {
   int wordshift = na >> SSWORDSHIFT;
 
   int wc = SSNUMWORDS(R->nbits);
+  int known = Value_isKnown(I) && I->nbits >= R->nbits && !inZ && in1 != in0;
   int i;
 
   /*
@@ -1958,12 +2287,12 @@ void Value_shift(Value *R,Value *I,int n,int in1,int in0,int inZ) {
 
      Both start at in1/in0/inZ until 'in range' to read from I[i-wordshift], etc..
   */
-  unsigned src1 = in1 ? ~0 : 0;
-  unsigned src0 = in0 ? ~0 : 0;
-  unsigned srcZ = inZ ? ~0 : 0;
-  unsigned prv1 = src1;
-  unsigned prv0 = src0;
-  unsigned prvZ = srcZ;
+  ssword_t src1 = in1 ? ~0 : 0;
+  ssword_t src0 = in0 ? ~0 : 0;
+  ssword_t srcZ = inZ ? ~0 : 0;
+  ssword_t prv1 = src1;
+  ssword_t prv0 = src0;
+  ssword_t prvZ = srcZ;
 
   if (n > 0) {
     /* left shift */
@@ -1981,30 +2310,34 @@ void Value_shift(Value *R,Value *I,int n,int in1,int in0,int inZ) {
 	prvZ = I->flt[i - wordshift - 1];
       }
 
-      R->one[i] = (src1 << shift) | (prv1 >> ishift);
-      R->zero[i] = (src0 << shift) | (prv0 >> ishift);
-      R->flt[i] = (srcZ << shift) | (prvZ >> ishift);
+      R->one[i] = (src1 << shift) | (shift ? prv1 >> ishift : 0);
+      R->zero[i] = (src0 << shift) | (shift ? prv0 >> ishift : 0);
+      R->flt[i] = (srcZ << shift) | (shift ? prvZ >> ishift : 0);
     }
 
   } else if (n < 0) {
     /* right shift */
+    int iwc = SSNUMWORDS(I->nbits);
+    ssword_t tmask = (I->nbits & SSBITMASK) ? LMASK(I->nbits & SSBITMASK) : SSWORDMASK;
+    ssword_t in1w = src1, in0w = src0, inZw = srcZ;
+
     for (i = wc-1; i >= 0; i--) {
-      if (i + wordshift < wc) {
-	src1 = I->one[i + wordshift];
-	src0 = I->zero[i + wordshift];
-	srcZ = I->flt[i + wordshift];
-      }
+      int j = i + wordshift;
+
+      src1 = Value_shiftWord(I->one,j,iwc,tmask,in1w);
+      src0 = Value_shiftWord(I->zero,j,iwc,tmask,in0w);
+      srcZ = Value_shiftWord(I->flt,j,iwc,tmask,inZw);
       if (!shift)
 	prv1 = prv0 = prvZ = 0;
-      else if (i + wordshift + 1 < wc) {
-	prv1 = I->one[i + wordshift + 1];
-	prv0 = I->zero[i + wordshift + 1];
-	prvZ = I->flt[i + wordshift + 1];
+      else {
+	prv1 = Value_shiftWord(I->one,j+1,iwc,tmask,in1w);
+	prv0 = Value_shiftWord(I->zero,j+1,iwc,tmask,in0w);
+	prvZ = Value_shiftWord(I->flt,j+1,iwc,tmask,inZw);
       }
 
-      R->one[i] = (prv1 << ishift) | (src1 >> shift);
-      R->zero[i] = (prv0 << ishift) | (src0 >> shift);
-      R->flt[i] = (prvZ << ishift) | (srcZ >> shift);
+      R->one[i] = (shift ? prv1 << ishift : 0) | (src1 >> shift);
+      R->zero[i] = (shift ? prv0 << ishift : 0) | (src0 >> shift);
+      R->flt[i] = (shift ? prvZ << ishift : 0) | (srcZ >> shift);
     }
 
   } else {
@@ -2014,4 +2347,9 @@ void Value_shift(Value *R,Value *I,int n,int in1,int in0,int inZ) {
       R->flt[i] = I->flt[i];
     }
   }
+
+  if (known)
+    Value_setKnown(R);
+  else
+    Value_clearKnown(R);
 }
@@ -18,6 +18,8 @@
 #ifndef __value_h
 #define __value_h
 
+#include <stdint.h>
+
 /*****************************************************************************
  *
  * Define the real type we are going to use.
@@ -55,14 +57,28 @@ enum ValueFlags
 	SF_STRING = 0x20,	/* Declared as string */
 	SF_REAL = 0x40,	/* Declared as real */
 	SF_STICKY_MASK = 0xffff,	/* These flags are sticky and are propegated */
-	SF_NETVAL = 0x10000	/* Value is directly associated with a net */
+	SF_NETVAL = 0x10000,	/* Value is directly associated with a net */
+	SF_PARAM = 0x20000,	/* Value is associated with a parameter */
+	SF_KNOWN = 0x40000	/* All bits are 0 or 1 (see Value_isKnown) */
 };
 
 /*
- * Basic word size/byte size declarations.
+ * Basic word size/byte size declarations.  Values are stored in 64-bit
+ * words (ssword_t) with products and quotients formed in a double word
+ * (ssdword_t).  Building with -DSSWORDSIZE=32 selects 32-bit words.
  */
-#define SSWORDSIZE		TKGATE_WORDSIZE		/* # bits in an unsigned */
-#define SSWORDMASK		((unsigned)~0)		/* Word with all bits set */
+#ifndef SSWORDSIZE
+#define SSWORDSIZE		64			/* # bits in an ssword_t */
+#endif
+#if (SSWORDSIZE == 32)
+typedef uint32_t ssword_t;
+typedef uint64_t ssdword_t;
+#elif (SSWORDSIZE == 64)
+typedef uint64_t ssword_t;
+typedef unsigned __int128 ssdword_t;
+#endif
+#define SSWORDMASK		((ssword_t)~0)		/* Word with all bits set */
+#define SSINTSIZE		32			/* # bits in a Verilog integer */
 #define SSREALSIZE		(8*sizeof(real_t))	/* Size of real in bits */
 #define SSREALBYTES		(sizeof(real_t))	/* Size of real in bytes */
 #if (SSWORDSIZE == 32)
@@ -108,6 +124,25 @@ enum ValueFlags
  *****************************************************************************/
 typedef void wirefunc_f(Value *R, Value *A, Value *B);
 
+/*****************************************************************************
+ *
+ * Wire resolution function
+ *
+ * Parameters:
+ *      R		Return value
+ *      w		Word of R to set
+ *      isOne		Bits on which some driver has its one bit set
+ *      isZero		Bits on which some driver has its zero bit set
+ *      hasFloat	Bits on which every driver floats
+ *      isStrong	Bits on which some driver is at 0 (wand) or 1 (wor)
+ *
+ * Sets word w of R from these reductions over all of the drivers of a wire,
+ * so that the value of a wire does not depend on the order in which its
+ * drivers are merged.
+ *
+ *****************************************************************************/
+typedef void wireresolve_f(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong);
+
 
 /*****************************************************************************
  *
@@ -131,7 +166,13 @@ one      0  1  1  0  0  1
 flt      0  0  1  1  1  1
 */
 #define DEBUG_VALUE_MEMMGR 0
+#define DEBUG_VALUE_KNOWN 0
 
+/*
+ * The one, zero and flt planes of a value of up to THYMEVALUE_INLINEBITS bits
+ * are kept in bits[] so the value and its state share a cache line.  Wider
+ * values keep the three planes in one allocated block.
+ */
 class Value
 {
 public:
@@ -142,9 +183,10 @@ public:
   ValueFlags	permFlags;	/* Perminant property flags */
   short		nbits;		/* Number of bits in state */
   short		nalloc;		/* Number of words allocated */
-  unsigned	*zero;		/* Bit indicating zero */
-  unsigned	*one;		/* Bit indicating one */
-  unsigned	*flt;		/* Bit indicating float */
+  ssword_t	*zero;		/* Bit indicating zero */
+  ssword_t	*one;		/* Bit indicating one */
+  ssword_t	*flt;		/* Bit indicating float */
+  ssword_t	bits[3*SSNUMWORDS(THYMEVALUE_INLINEBITS)];	/* Inline one, zero and flt bits */
 };
 
 enum StrengthLevel
@@ -177,8 +219,21 @@ struct value_fl {
   struct value_fl	*next;	/* Next pointer for free list */
 };
 
+/*****************************************************************************
+ *
+ * ValuePool - Free list used by new_Value() and delete_Value().  Each
+ * thread of the parallel executor has one of its own (see parallel.h).
+ *
+ *****************************************************************************/
+typedef struct {
+  struct value_fl	*vp_free;	/* Free list */
+  long long		vp_numOut;	/* Values taken from the pool and not given back */
+} ValuePool;
+
 Value *new_Value(int nbits);
 void delete_Value(Value*);
+void Value_usePool(ValuePool *P);
+void Value_settlePool(ValuePool *P);
 
 void Value_init(Value *S,int nbits);
 void Value_uninit(Value *S);
@@ -203,6 +258,24 @@ void Value_print(Value *S,FILE *f);
  *****************************************************************************/
 void Value_copy(Value *R,Value *A);
 
+/*****************************************************************************
+ *
+ * Update a value and classify the change
+ *
+ * Parameters:
+ *     R		Target of assignment
+ *     A		Source of assignment
+ *     changed		Mask of changed bits, one word for each word of R (or null)
+ *
+ * Returns:		Type of transition that occured.
+ *
+ * Same as Value_transitionType() followed by Value_copy() when there is a
+ * transition, but done in one pass over the words.  Only words that differ
+ * are stored.  The mask is written only if there is a transition.
+ *
+ *****************************************************************************/
+transtype_t Value_update(Value *R,Value *A,ssword_t *changed);
+
 /*****************************************************************************
  *
  * Copy range of bits
@@ -213,14 +286,17 @@ void Value_copy(Value *R,Value *A);
  *     A		Source Value value
  *     ah		High bit in source to copy
  *     al		Low bit in source to copy
+ *     changed		Mask of changed bits, one word for each word of R (or null)
  *
  * Returns:		Type of transition that occured.
  *
  * Copy a range of bits.  Copies bits in the range [ah:al] of A into R
- * starting at bit rl.
+ * starting at bit rl.  Value_updateRange() also sets the bits of R that
+ * changed in changed, which is written only if there is a transition.
  *
  *****************************************************************************/
-transtype_t Value_copyRange(Value *R,int rl,Value *A,int ah,int al);
+transtype_t Value_updateRange(Value *R,int rl,Value *A,int ah,int al,ssword_t *changed);
+#define Value_copyRange(R,rl,A,ah,al)	Value_updateRange(R,rl,A,ah,al,0)
 
 /*****************************************************************************
  *
@@ -243,6 +319,11 @@ void Value_wire(Value *R,Value *A,Value *B);
 void Value_wand(Value *R,Value *A,Value *B);
 void Value_wor(Value *R,Value *A,Value *B);
 void Value_tri0(Value *R,Value *A,Value *B);
+void Value_wireResolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong);
+void Value_wandResolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong);
+void Value_worResolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong);
+void Value_tri0Resolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong);
+void Value_tri1Resolve(Value *R,int w,ssword_t isOne,ssword_t isZero,ssword_t hasFloat,ssword_t isStrong);
 
 /*****************************************************************************
  *
@@ -289,10 +370,38 @@ void Value_tri1(Value *R,Value *A,Value *B);
  ******************************************************************************/
 void Value_trireg(Value *R,Value *A,Value *B);
 
+/*****************************************************************************
+ *
+ * The all-known flag
+ *
+ * SF_KNOWN in the flags of a value means that every bit below nbits is a 0
+ * or a 1, so that the one plane alone gives the value.  The functions that
+ * store values keep it up to date: Value_zero(), Value_normalize() and the
+ * like set it, and those that may store x, z, L or H bits clear it unless
+ * they can tell that they did not.  A clear flag only means that the value
+ * has not been shown to be 2-state; Value_isLogic() then scans the value
+ * and records the answer in the flag.
+ *
+ *****************************************************************************/
+#if DEBUG_VALUE_KNOWN
+int Value_checkKnown(Value *S);
+#define Value_isKnown(S) (((S)->flags & SF_KNOWN) && Value_checkKnown(S))
+#else
+#define Value_isKnown(S) ((S)->flags & SF_KNOWN)
+#endif
+#define Value_setKnown(S) ((S)->flags = (ValueFlags)((S)->flags | SF_KNOWN))
+#define Value_clearKnown(S) ((S)->flags = (ValueFlags)((S)->flags & ~SF_KNOWN))
+
+/******************************************************************************
+ * Scan a value for x, z, L and H bits and set or clear SF_KNOWN.  Returns
+ * non-zero if the value has only 0 and 1 bits.
+ ******************************************************************************/
+int Value_scanLogic(Value *);
+
 /******************************************************************************
  * Return non-zero if value has only 0 and 1 bits
  ******************************************************************************/
-int Value_isLogic(Value *);
+#define Value_isLogic(S) (Value_isKnown(S) || Value_scanLogic(S))
 
 /******************************************************************************
  * Return non-zero if value is logic zero
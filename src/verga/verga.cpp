@@ -30,6 +30,9 @@ extern Place curPlace;			/* The current place */
 
 VGSim vgsim;
 
+static const char *queue_profile = 0;	/* File for queue profile (-Q switch) */
+static int opt_report = 0;		/* Report optimizer statistics (-O switch) */
+
 /*
  * These undoable object functions are only used in the main tkgate code, but
  * since they are used in the common hash table code we provide stubs here for
@@ -89,6 +92,26 @@ VGSecurity_handleException(VGSecurity *vgs,VGThread *t,const char *name)
   }
 }
 
+/*****************************************************************************
+ *
+ * Write the event queue profile requested with the -Q switch.  This is
+ * called at exit so that the profile is written however the simulation
+ * ends.
+ *
+ *****************************************************************************/
+static void writeQueueProfile()
+{
+  FILE *f = fopen(queue_profile,"w");
+
+  if (!f) {
+    errorCmd(ERR_QPROFILE,queue_profile);
+    return;
+  }
+
+  EvQueue_writeProfile(Circuit_getQueue(&vgsim.circuit()),f,QUEUE_TOPNETS);
+  fclose(f);
+}
+
 VGSim::VGSim() :
 _baseDirectory(NULL),
 _interactive(false),
@@ -103,6 +126,9 @@ _std(VSTD_1995)
 	this->vg_noTimeViolations = 0;
 	this->vg_initTime = 0;
 	this->vg_delayType = DT_TYP;
+	this->vg_levelize = 0;
+	this->vg_numJobs = 1;
+	List_init(&this->vg_placements);
 }
 
 static void usage()
@@ -365,6 +391,9 @@ startSimulation(const char *topName, int warning_mode, List *load_scripts,
 	vgsim.circuit().sortThreads();
 	vgsim.circuit().check();
 
+	if (opt_report && !vgsim.interactive())
+		ByteCode_printOptStats();
+
   if (vgsim.interactive()) {
     exitIfError();
 
@@ -497,6 +526,7 @@ main(int argc, char *argv[])
 	int		 quiet = 0;
 	int		 delete_on_load = 0;
 	unsigned	 delete_hash_code = 0;
+	unsigned	 wheel_size = 0;
 	const char	*initTimeSpec = 0;
 	
 	initErrorMessages();
@@ -510,7 +540,7 @@ main(int argc, char *argv[])
 	* Parse the command-line options.
 	*/
 	while (argc > 0) {
-		while ((c = getopt(argc,argv,"eslqid:S:P:t:B:D:W:I:V:"))
+		while ((c = getopt(argc,argv,"eslqiFLd:S:P:t:B:D:W:I:V:w:Q:O:X:j:p:"))
 		    != EOF) {
 			switch (c) {
 			case 'e' :
@@ -536,9 +566,45 @@ main(int argc, char *argv[])
 			case 'W' :
 				sscanf(optarg,"%d",&warning_mode);
 				break;
+			case 'w' :
+				if (sscanf(optarg,"%u",&wheel_size) == 1)
+					EvQueue_setWheelSize(
+					    Circuit_getQueue(&vgsim.circuit()),
+					    wheel_size);
+				break;
+			case 'Q' :
+				queue_profile = optarg;
+				break;
 			case 'q' :
 				quiet = 1;
 				break;
+			case 'F' :
+				ByteCode_setThreaded(0);
+				break;
+			case 'L' :
+				vgsim.vg_levelize = 1;
+				break;
+			case 'j' :
+				if (sscanf(optarg,"%u",&vgsim.vg_numJobs) != 1
+				    || vgsim.vg_numJobs < 1)
+					usage();
+				else if (vgsim.vg_numJobs > THYMEPAR_MAXJOBS)
+					vgsim.vg_numJobs = THYMEPAR_MAXJOBS;
+				break;
+			case 'p' :
+				if (!Partitioner_checkPlacement(optarg))
+					usage();
+				else
+					List_addToTail(&vgsim.vg_placements,optarg);
+				break;
+			case 'O' :
+				ByteCode_setOptLevel(atoi(optarg));
+				opt_report = 1;
+				break;
+			case 'X' :
+				if (Value_setSimd(optarg) < 0)
+					usage();
+				break;
 			case 's' :
 				scan_mode = 1;
 				Place_setMode((placemode_t)(PM_MODULE|PM_MODLINE));
@@ -673,6 +739,15 @@ main(int argc, char *argv[])
 		return (EXIT_FAILURE);
 	}
 
+	if (quiet)
+		opt_report = 0;
+
+	/*
+	 * In batch mode, write a profile of the event queue at exit if requested.
+	 */
+	if (queue_profile && !vgsim.interactive())
+		atexit(writeQueueProfile);
+
 	startSimulation(vgsim.topModuleName(), warning_mode, &load_scripts,
 	    initTimeSpec);
 
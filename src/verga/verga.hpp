@@ -34,6 +34,7 @@
 #else
 #include <map>
 #endif
+#include <atomic>
 
 #include "config.h"		/* Tkgate global configuration parameters */
 #include "thyme_config.h"	/* thyme-specific configuration parameters */
@@ -43,8 +44,8 @@
 #include "ycmalloc.h"		/* libcommon ycmalloc package */
 #include "io.h"			/* Communication functions */
 #include "error.h"		/* Error and Place handling */
-#include "multint.h"		/* Multi-word integer operations */
 #include "value.h"		/* Verilog value class */
+#include "multint.h"		/* Multi-word integer operations */
 #include "operators.h"		/* Operator functions */
 #include "systask.h"		/* System tasks */
 #include "memory.h"		/* Memory */
@@ -61,6 +62,9 @@
 #include "channel.h"		/* Data channel handling */
 #include "trigger.h"		/* Event triggers */
 #include "bytecode.h"		/* Simulation byte code */
+#include "levelize.h"		/* Levelized evaluation of gates */
+#include "parallel.h"		/* Parallel evaluation of threads */
+#include "partition.h"		/* Partitioning of threads for parallel evaluation */
 #include "verilog.h"		/* Parser functions */
 #include "yybasic.h"		/* Basic parser functions */
 #include "vgrammar.hpp"		/* Symbols definitions for tokens */
@@ -189,6 +193,9 @@ public:
 	simtime_t vg_initTime;	/* Time need for user circuit to initialize. */
 
 	DelayType vg_delayType;	/* Type of delays to use */
+	int vg_levelize;	/* Evaluate zero-delay gates in levelized passes? */
+	unsigned vg_numJobs;	/* Threads for parallel evaluation (-j) */
+	List vg_placements;	/* Instances placed in partitions (-p "path=partition") */
 private:
 	/* Table of modules type*/
 #if __cplusplus >= 201103
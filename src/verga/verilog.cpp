@@ -243,7 +243,7 @@ void VerBeginDecls(int dtype,VRange *range)
   switch ((dtype & NT_P_REGTYPE_MASK)) {
   case NT_P_INTEGER :
     dtype |= NT_P_SIGNED;
-    range = new VRange(RS_MAXMIN,new_Expr_num(SSWORDSIZE-1),new_Expr_num(0));
+    range = new VRange(RS_MAXMIN,new_Expr_num(SSINTSIZE-1),new_Expr_num(0));
     break;
   case NT_P_TIME :
     range = new VRange(RS_MAXMIN,new_Expr_num(63),new_Expr_num(0));
@@ -256,7 +256,7 @@ void VerBeginDecls(int dtype,VRange *range)
   }
 
   if (!range)
-	  range = new VRange(RS_MAXMIN, new_Expr_num(SSWORDSIZE-1),
+	  range = new VRange(RS_MAXMIN, new_Expr_num(SSINTSIZE-1),
 	      new_Expr_num(0));
 
   cur.dtype = dtype;
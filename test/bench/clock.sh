@@ -0,0 +1,41 @@
+#!/bin/sh
+#
+# Clock edge fanout.  A design of many flip-flops that all wait on the same
+# clock edge, so that each edge fires one trigger holding every flip-flop's
+# waiting thread.  The time of a run with no clock edges is subtracted, and
+# the time per edge and per flip-flop is printed.
+#
+VERGA=${VERGA:-"../../src/verga/verga++"}
+FLOPS=${FLOPS:-100000}
+EDGES=${EDGES:-200}
+DESIGN=/tmp/clock$$.v
+
+design() {
+  (
+    echo "module top;"
+    echo "  reg clk;"
+    echo "  integer n;"
+    awk "BEGIN { for (i = 0;i < $FLOPS;i++) printf \"  reg q%d; initial q%d = 0; always @(posedge clk) q%d <= ~q%d;\\n\",i,i,i,i }"
+    cat <<END
+  initial begin
+    clk = 0;
+    for (n = 0;n < $1;n = n + 1)
+      #1 clk = ~clk;
+    #1 \$finish;
+  end
+endmodule
+END
+  ) > $DESIGN
+}
+
+echo "   flops  edges   seconds   us/edge  ns/flop"
+design 0
+start=`date +%s.%N`
+$VERGA -q $DESIGN > /dev/null
+end=`date +%s.%N`
+design `expr $EDGES \* 2`
+start2=`date +%s.%N`
+$VERGA -q $DESIGN > /dev/null
+end2=`date +%s.%N`
+echo "$FLOPS $EDGES $start $end $start2 $end2" | awk '{ t = ($6-$5)-($4-$3); printf "%8d %6d %9.3f %9.1f %8.1f\n",$1,$2,t,t*1e6/$2,t*1e9/($1*$2) }'
+rm -f $DESIGN
@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+# Decimal formatting of wide values.  A loop displays a value of the given
+# width with %d, so the run time follows the cost of the binary to decimal
+# conversion used by $display, $monitor and $strobe.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-20000}
+DESIGN=/tmp/decimal$$.v
+
+echo "   width      iter   seconds"
+for width in 64 256 1024 2048 4096; do
+  cat > $DESIGN <<END
+module top;
+  reg [$width-1:0] a;
+  integer n;
+
+  initial begin
+    a = {128{32'h9e3779b9}};
+    for (n = 0;n < $ITER;n = n + 1) begin
+      \$display("%d", a);
+      a = a + 1;
+    end
+    \$finish;
+  end
+endmodule
+END
+  start=`date +%s.%N`
+  $VERGA -q $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$width $ITER $start $end" | awk '{ printf "%8d %9d %9.3f\n",$1,$2,$4-$3 }'
+done
+rm -f $DESIGN
@@ -0,0 +1,50 @@
+#!/bin/sh
+#
+# Nets with many drivers.  A bus of a given width is driven by a number of
+# continuous assignments that each drive the bus or float it.  A loop turns
+# one driver on and off while the others stay as they are, so that the time
+# for each change shows how resolution of a net grows with the number of
+# drivers.
+#
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-1000000}
+DESIGN=/tmp/drivers$$.v
+
+echo "   width  drivers  type        iter   seconds"
+for width in 8 128; do
+  for drivers in 2 8 32 64; do
+    for type in wire wand trireg; do
+      (
+	echo "module top;"
+	echo "  reg [$drivers-1:0] en;"
+	echo "  reg t;"
+	echo "  reg [$width-1:0] d;"
+	echo "  $type [$width-1:0] bus;"
+	echo "  integer n;"
+	echo "  assign bus = t ? d : {$width{1'bz}};"
+	i=1
+	while [ $i -lt $drivers ]; do
+	  echo "  assign bus = en[$i] ? d ^ $i : {$width{1'bz}};"
+	  i=`expr $i + 1`
+	done
+	cat <<END
+  initial begin
+    d = {$width{1'b1}};
+    en = {$drivers{1'b0}};
+    en[1] = 1'b1;
+    t = 0;
+    for (n = 0;n < $ITER;n = n + 1)
+      #1 t = ~t;
+    \$finish;
+  end
+endmodule
+END
+      ) > $DESIGN
+      start=`date +%s.%N`
+      $VERGA -q $DESIGN > /dev/null
+      end=`date +%s.%N`
+      echo "$width $drivers $type $ITER $start $end" | awk '{ printf "%8d %8d  %-7s %9d %9.3f\n",$1,$2,$3,$4,$6-$5 }'
+    done
+  done
+done
+rm -f $DESIGN
@@ -0,0 +1,51 @@
+#!/bin/sh
+#
+# Notification cost versus fanout.  A net is listened to by a number of
+# processes that each wait on their own trigger.  After the first change
+# the processes sleep past the end of the run, so that every later change
+# of the net scans that many triggers with no events to move.  The time of
+# a run with no changes is subtracted, and the time per notified trigger is
+# printed with the time for the changes.
+#
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-200000}
+DESIGN=/tmp/fanout$$.v
+
+design() {
+  (
+    echo "module top;"
+    echo "  reg a;"
+    echo "  reg [$1-1:0] x;"
+    echo "  integer n;"
+    i=0
+    while [ $i -lt $1 ]; do
+      echo "  reg d$i;"
+      echo "  always @(a or d$i) #$ITER x[$i] = a;"
+      i=`expr $i + 1`
+    done
+    cat <<END
+  initial begin
+    a = 0;
+    for (n = 0;n < $2;n = n + 1)
+      #1 a = ~a;
+    \$finish;
+  end
+endmodule
+END
+  ) > $DESIGN
+}
+
+echo "  fanout      iter   seconds  ns/trigger"
+for fanout in 1 16 256 4096; do
+  iter=`expr $ITER \* 64 / \( $fanout + 63 \)`
+  design $fanout 0
+  start=`date +%s.%N`
+  $VERGA -q $DESIGN > /dev/null
+  end=`date +%s.%N`
+  design $fanout $iter
+  start2=`date +%s.%N`
+  $VERGA -q $DESIGN > /dev/null
+  end2=`date +%s.%N`
+  echo "$fanout $iter $start $end $start2 $end2" | awk '{ t = ($6-$5)-($4-$3); printf "%8d %9d %9.3f  %10.1f\n",$1,$2,t,t*1e9/($1*$2) }'
+done
+rm -f $DESIGN
@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# Gate-level netlist speed.  A random netlist of GATES primitive gates on
+# scalar nets is driven by 32 inputs that change every 20 time units.  Each
+# gate is a separate thread, so most of the run time is spent evaluating
+# gates and scheduling their outputs.  The design is run with the default
+# dispatch and with function-pointer dispatch (-F).
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+GATES=${GATES:-10000}
+CYCLES=${CYCLES:-100}
+DESIGN=/tmp/gates$$.v
+
+awk -v gates=$GATES -v cycles=$CYCLES 'BEGIN {
+  srand(1);
+  split("and or xor nand nor xnor", type, " ");
+  print "module top;";
+  print "  reg [31:0] x;";
+  print "  integer n;";
+  printf "  wire";
+  for (i = 0;i < gates;i++) printf "%s w%d", (i ? "," : ""), i;
+  print ";";
+  for (i = 0;i < gates;i++) {
+    nin = 2 + int(rand()*2);
+    printf "  %s #1 g%d (w%d", type[1+int(rand()*6)], i, i;
+    for (j = 0;j < nin;j++) {
+      # Inputs come from the primary inputs or from the previous 64 gates.
+      if (i < 64 || rand() < 0.2)
+        printf ", x[%d]", int(rand()*32);
+      else
+        printf ", w%d", i - 1 - int(rand()*64);
+    }
+    print ");";
+  }
+  print "  initial begin";
+  print "    x = 0;";
+  printf "    for (n = 0;n < %d;n = n + 1) #20 x = $random;\n", cycles;
+  print "    $finish;";
+  print "  end";
+  print "endmodule";
+}' > $DESIGN
+
+echo "   gates  cycles     dispatch   seconds"
+for mode in threaded funcptr; do
+  flag=""
+  [ $mode = funcptr ] && flag="-F"
+  start=`date +%s.%N`
+  $VERGA -q $flag $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$GATES $CYCLES $mode $start $end" | awk '{ printf "%8d %7d %12s %9.3f\n",$1,$2,$3,$5-$4 }'
+done
+rm -f $DESIGN
@@ -0,0 +1,49 @@
+#!/bin/sh
+#
+# Gate level ripple-carry adder whose inputs change faster than the carry
+# chain settles.  Most scheduled gate outputs are superseded before they
+# mature, so this measures inertial delay cancellation of driver events.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+WIDTH=${WIDTH:-64}
+CYCLES=${CYCLES:-20000}
+DESIGN=/tmp/glitch$$.v
+
+awk -v width=$WIDTH -v cycles=$CYCLES 'BEGIN {
+  print "module top;"
+  print "  reg [" width-1 ":0] a, b;"
+  print "  wire [" width ":0] c;"
+  print "  wire [" width-1 ":0] s, p, g, t;"
+  print "  integer n;"
+  print "  assign c[0] = 1'"'"'b0;"
+  r = "$random"
+  for (i = 32;i < width;i += 32)
+    r = r ", $random"
+  for (i = 0;i < width;i++) {
+    print "  xor #3 (p[" i "], a[" i "], b[" i "]);"
+    print "  xor #3 (s[" i "], p[" i "], c[" i "]);"
+    print "  and #2 (g[" i "], a[" i "], b[" i "]);"
+    print "  and #2 (t[" i "], p[" i "], c[" i "]);"
+    print "  or #2 (c[" i+1 "], g[" i "], t[" i "]);"
+  }
+  print "  initial begin"
+  print "    n = 0;"
+  print "    a = 0;"
+  print "    b = 0;"
+  print "    while (n < " cycles ") begin"
+  print "      #2 a = {" r "};"
+  print "      b = {" r "};"
+  print "      n = n + 1;"
+  print "    end"
+  print "    #" 8*width " $display(\"%h\", s);"
+  print "    $finish;"
+  print "  end"
+  print "endmodule"
+}' > $DESIGN
+
+start=`date +%s.%N`
+$VERGA -q $DESIGN > /dev/null
+end=`date +%s.%N`
+echo "$WIDTH $CYCLES $start $end" | awk '{ printf "width %d, %d cycles: %.3f seconds\n",$1,$2,$4-$3 }'
+rm -f $DESIGN
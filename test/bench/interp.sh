@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# Bytecode interpreter speed.  A clock wakes a number of always blocks that
+# each execute a fixed number of register statements per clock edge, so
+# nearly all of the run time is spent executing bytecode.  Each design is run
+# with the default dispatch and with function-pointer dispatch (-F), and the
+# rate is given in executed statements per second.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+CYCLES=${CYCLES:-5000}
+DESIGN=/tmp/interp$$.v
+
+echo "  blocks  loop     dispatch   seconds  Mstmt/s"
+for b in 16 256; do
+  for l in 1 16; do
+    {
+      echo "module top;"
+      echo "  reg clk;"
+      echo "  integer n;"
+      echo "  initial begin clk = 0; n = 0; end"
+      echo "  always #1 begin clk = ~clk; n = n + 1; if (n == 2*$CYCLES) \$finish; end"
+      i=0
+      while [ $i -lt $b ]; do
+	cat <<END
+  reg [31:0] x$i, y$i, z$i;
+  integer i$i;
+  initial begin x$i = $i; y$i = 1; z$i = 0; end
+  always @(posedge clk)
+    for (i$i = 0;i$i < $l;i$i = i$i + 1) begin
+      x$i = x$i + y$i;
+      y$i = y$i ^ (x$i >> 3);
+      z$i = (x$i & y$i) | (z$i << 1);
+    end
+END
+	i=`expr $i + 1`
+      done
+      echo "endmodule"
+    } > $DESIGN
+
+    # Each iteration runs three assignments plus the loop test and increment.
+    stmts=`expr $CYCLES \* $b \* $l \* 5`
+    for mode in threaded funcptr; do
+      flag=""
+      [ $mode = funcptr ] && flag="-F"
+      start=`date +%s.%N`
+      $VERGA -q $flag $DESIGN > /dev/null
+      end=`date +%s.%N`
+      echo "$b $l $mode $start $end $stmts" | awk '{ printf "%8d %5d %12s %9.3f %8.2f\n",$1,$2,$3,$5-$4,$6/($5-$4)/1e6 }'
+    done
+  done
+done
+rm -f $DESIGN
@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# 2-state operands.  A loop applies arithmetic, compare, bitwise and
+# reduction operators to registers of a given width that hold only 0 and 1
+# bits, and again with one x bit in an operand, so that the first run takes
+# the fast paths for known values and the second does not.  The fraction of
+# operator calls decided by the known flag is taken from the -Q profile.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-2000000}
+DESIGN=/tmp/known$$.v
+PROFILE=/tmp/known$$.json
+
+echo "   width  operand      iter   seconds  fast"
+for width in 128 192 1024; do
+  for init in 2state xbit; do
+    if [ $init = 2state ]; then
+      c="{32{32'h00000003}}"
+    else
+      c="{{31{32'h00000003}},32'h0000000x}"
+    fi
+    cat > $DESIGN <<END
+module top;
+  reg [$width-1:0] a, b, c, x, y;
+  reg p, q;
+  integer n, k;
+
+  initial begin
+    a = {32{32'h9e3779b9}};
+    b = {32{32'h7f4a7c15}};
+    c = $c;
+    k = 0;
+    for (n = 0;n < $ITER;n = n + 1) begin
+      x = a + c;
+      y = (x ^ b) & c;
+      p = ^y;
+      q = (x == y);
+      if (x > b) k = k + 1;
+    end
+    \$finish;
+  end
+endmodule
+END
+    start=`date +%s.%N`
+    $VERGA -q -Q $PROFILE $DESIGN > /dev/null
+    end=`date +%s.%N`
+    fast=`sed -n 's/.*"operators".*"fraction": \([0-9.]*\).*/\1/p' $PROFILE`
+    echo "$width $init $ITER $start $end $fast" | awk '{ printf "%8d  %-6s %9d %9.3f  %s\n",$1,$2,$3,$5-$4,$6 }'
+  done
+done
+rm -f $DESIGN $PROFILE
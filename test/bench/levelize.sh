@@ -0,0 +1,60 @@
+#!/bin/sh
+#
+# Levelized evaluation.  A synchronous design of many registers, each fed
+# back through a chain of continuous assignments and gates, run for a number
+# of clock cycles with and without -L.  The time of a run with no clock
+# cycles is subtracted, and the time per cycle of each mode and the speedup
+# are printed.
+#
+VERGA=${VERGA:-"../../src/verga/verga++"}
+REGS=${REGS:-1000}
+DEPTH=${DEPTH:-8}
+CYCLES=${CYCLES:-500}
+DESIGN=/tmp/levelize$$.v
+
+design() {
+  (
+    echo "module top;"
+    echo "  reg clk;"
+    echo "  integer n;"
+    awk "BEGIN {
+      for (i = 0;i < $REGS;i++) {
+        printf \"  reg [15:0] r%d; initial r%d = %d;\\n\",i,i,i
+        printf \"  wire [15:0] c%d_0; assign c%d_0 = r%d ^ r%d;\\n\",i,i,i,(i+1)%$REGS
+        for (j = 1;j < $DEPTH;j++) {
+          if (j % 2)
+            printf \"  wire [15:0] c%d_%d; assign c%d_%d = c%d_%d + 16'd%d;\\n\",i,j,i,j,i,j-1,j
+          else
+            printf \"  wire [15:0] c%d_%d; xor (c%d_%d[0], c%d_%d[0], c%d_%d[15]); assign c%d_%d[15:1] = c%d_%d[14:0];\\n\",i,j,i,j,i,j-1,i,j-1,i,j,i,j-1
+        }
+        printf \"  always @(posedge clk) r%d <= c%d_%d;\\n\",i,i,$DEPTH-1
+      }
+    }"
+    cat <<END
+  initial begin
+    clk = 0;
+    for (n = 0;n < $1;n = n + 1)
+      #1 clk = ~clk;
+    #1 \$finish;
+  end
+endmodule
+END
+  ) > $DESIGN
+}
+
+run() {
+  start=`date +%s.%N`
+  $VERGA -q $1 $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$start $end" | awk '{ printf "%f\n",$2-$1 }'
+}
+
+echo "    regs  depth cycles  us/cycle  us/cycle(-L)  speedup"
+design 0
+base=`run`
+baseL=`run -L`
+design `expr $CYCLES \* 2`
+t=`run`
+tL=`run -L`
+rm -f $DESIGN
+echo "$REGS $DEPTH $CYCLES $base $t $baseL $tL" | awk '{ e = ($5-$4)*1e6/$3; l = ($7-$6)*1e6/$3; printf "%8d %6d %6d %9.1f %13.1f %8.1f\n",$1,$2,$3,e,l,e/l }'
@@ -0,0 +1,33 @@
+#!/bin/sh
+#
+# Many concurrent clocks with delays longer than the level 0 time wheel, as
+# with a picosecond timescale.  Every event is scheduled into an upper level
+# of the time wheel and cascaded down.  Run with several level 0 wheel sizes.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+CLOCKS=${CLOCKS:-1000}
+CYCLES=${CYCLES:-1000}
+DESIGN=/tmp/longdelay$$.v
+
+awk -v clocks=$CLOCKS -v cycles=$CYCLES 'BEGIN {
+  print "module top;"
+  print "  integer n;"
+  print "  initial n = 0;"
+  for (i = 1;i <= clocks;i++) {
+    print "  reg ck" i ";"
+    print "  initial ck" i " = 0;"
+    print "  always #" 10000 + i*7 " ck" i " = ~ck" i ";"
+  }
+  print "  always @(ck1) begin n = n + 1; if (n == " cycles ") $finish; end"
+  print "endmodule"
+}' > $DESIGN
+
+echo "   wheel  seconds"
+for w in 64 4096 65536; do
+  start=`date +%s.%N`
+  $VERGA -q -w $w $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$w $start $end" | awk '{ printf "%8d %8.3f\n",$1,$3-$2 }'
+done
+rm -f $DESIGN
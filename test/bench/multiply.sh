@@ -0,0 +1,36 @@
+#!/bin/sh
+#
+# Multiply, divide and modulus across operand widths.  Each design runs a
+# loop of one operator on registers of the given width, so the run time
+# shows how the operator scales as the operands move from the schoolbook
+# multiply to the Karatsuba multiply and from one to many division words.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-200000}
+DESIGN=/tmp/multiply$$.v
+
+echo "   width  op        iter   seconds"
+for width in 64 256 1024 2048 4096 8192; do
+  for op in '*' '/' '%'; do
+    cat > $DESIGN <<END
+module top;
+  reg [$width-1:0] a, b, x;
+  integer n;
+
+  initial begin
+    a = {256{32'h9e3779b9}};
+    b = {256{32'h7f4a7c15}} >> ($width/2 - 16);
+    for (n = 0;n < $ITER;n = n + 1)
+      x = a $op b;
+    \$finish;
+  end
+endmodule
+END
+    start=`date +%s.%N`
+    $VERGA -q $DESIGN > /dev/null
+    end=`date +%s.%N`
+    echo "$width $op $ITER $start $end" | awk '{ printf "%8d  %-2s %9d %9.3f\n",$1,$2,$3,$5-$4 }'
+  done
+done
+rm -f $DESIGN
@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Net update cost.  A loop assigns registers of a given width alternately
+# from two values that are the same, differ in the top bit or differ in every
+# bit, so that the time of comparing a new value against the net and storing
+# it is measured with and without a change.  Each register has a listener so that
+# changes are not optimized away.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-2000000}
+DESIGN=/tmp/netset$$.v
+
+echo "   width  update      iter   seconds"
+for width in 2 32 128 1024; do
+  for kind in same topbit all; do
+    case $kind in
+      same) v="c" ;;
+      topbit) v="{~c[$width-1],c[$width-2:0]}" ;;
+      all) v="~c" ;;
+    esac
+    cat > $DESIGN <<END
+module top;
+  reg [$width-1:0] a, b, c, d;
+  integer n, k;
+
+  always @(a) k = k + 1;
+  always @(b) k = k + 1;
+
+  initial begin
+    c = {32{32'h9e3779b9}};
+    d = $v;
+    k = 0;
+    for (n = 0;n < $ITER;n = n + 1)
+      if (n[0]) begin
+	a = c;
+	b = c;
+      end else begin
+	a = d;
+	b = d;
+      end
+    \$finish;
+  end
+endmodule
+END
+    start=`date +%s.%N`
+    $VERGA -q $DESIGN > /dev/null
+    end=`date +%s.%N`
+    echo "$width $kind $ITER $start $end" | awk '{ printf "%8d  %-7s %9d %9.3f\n",$1,$2,$3,$5-$4 }'
+  done
+done
+rm -f $DESIGN
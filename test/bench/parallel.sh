@@ -0,0 +1,64 @@
+#!/bin/sh
+#
+# Parallel thread events.  A synchronous design of many registers, each
+# computed by its own always block from a few others, run for a number of
+# clock cycles with -j 1 up to -j $JOBS.  The time of a run with no clock
+# cycles is subtracted, and the time per cycle and the speedup over -j 1
+# are printed for each number of jobs.
+#
+VERGA=${VERGA:-"../../src/verga/verga++"}
+REGS=${REGS:-2000}
+TERMS=${TERMS:-8}
+CYCLES=${CYCLES:-200}
+JOBS=${JOBS:-4}
+DESIGN=/tmp/parallel$$.v
+
+design() {
+  (
+    echo "module top;"
+    echo "  reg clk;"
+    echo "  integer n;"
+    awk "BEGIN {
+      for (i = 0;i < $REGS;i++)
+        printf \"  reg [31:0] r%d; initial r%d = %d;\\n\",i,i,i
+      for (i = 0;i < $REGS;i++) {
+        printf \"  always @(posedge clk) r%d <= r%d\",i,i
+        for (j = 1;j < $TERMS;j++)
+          printf \" %s (r%d >> %d)\",(j % 2 ? \"+\" : \"^\"),(i+j*7)%$REGS,j
+        printf \";\\n\"
+      }
+    }"
+    cat <<END
+  initial begin
+    clk = 0;
+    for (n = 0;n < $1;n = n + 1)
+      #1 clk = ~clk;
+    #1 \$finish;
+  end
+endmodule
+END
+  ) > $DESIGN
+}
+
+run() {
+  start=`date +%s.%N`
+  $VERGA -q -j $1 $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$start $end" | awk '{ printf "%f\n",$2-$1 }'
+}
+
+echo "    regs  terms cycles  jobs  us/cycle  speedup"
+j=1
+while [ $j -le $JOBS ]; do
+  design 0
+  base=`run $j`
+  design `expr $CYCLES \* 2`
+  t=`run $j`
+  c=`echo "$base $t $CYCLES" | awk '{ printf "%f\n",($2-$1)*1e6/$3 }'`
+  if [ $j -eq 1 ]; then
+    c1=$c
+  fi
+  echo "$REGS $TERMS $CYCLES $j $c $c1" | awk '{ printf "%8d %6d %6d %5d %9.1f %8.2f\n",$1,$2,$3,$4,$5,$6/$5 }'
+  j=`expr $j \* 2`
+done
+rm -f $DESIGN
@@ -0,0 +1,74 @@
+#!/bin/sh
+#
+# Scaling of partitioned parallel evaluation.  A design of $CORES cores in
+# a ring, each a module of many registers computed from each other and from
+# the output of the previous core, run for a number of clock cycles with -j
+# 1, 2, 4, ... up to $JOBS.  The time of a run with no clock cycles is
+# subtracted, and the time per cycle, the speedup over -j 1 and the number
+# of nets cut by the partitions (from the -Q profile) are printed.
+#
+VERGA=${VERGA:-"../../src/verga/verga++"}
+CORES=${CORES:-16}
+REGS=${REGS:-200}
+CYCLES=${CYCLES:-200}
+JOBS=${JOBS:-16}
+DESIGN=/tmp/partition$$.v
+PROFILE=/tmp/partition$$.json
+
+design() {
+  (
+    echo "module core(clk, in, out);"
+    echo "  input clk;"
+    echo "  input [31:0] in;"
+    echo "  output [31:0] out;"
+    awk "BEGIN {
+      for (i = 0;i < $REGS;i++)
+        printf \"  reg [31:0] r%d; initial r%d = %d;\\n\",i,i,i
+      printf \"  assign out = r%d;\\n\",$REGS-1
+      printf \"  always @(posedge clk) r0 <= in + (r1 >> 1);\\n\"
+      for (i = 1;i < $REGS;i++)
+        printf \"  always @(posedge clk) r%d <= r%d + (r%d ^ (r%d >> 3));\\n\",i,i-1,(i*7)%$REGS,(i*13)%$REGS
+    }"
+    echo "endmodule"
+    echo "module top;"
+    echo "  reg clk;"
+    echo "  integer n;"
+    awk "BEGIN {
+      for (i = 0;i < $CORES;i++)
+        printf \"  wire [31:0] o%d;\\n  core c%d(clk, o%d, o%d);\\n\",i,i,(i+$CORES-1)%$CORES,i
+    }"
+    cat <<END
+  initial begin
+    clk = 0;
+    for (n = 0;n < $1;n = n + 1)
+      #1 clk = ~clk;
+    #1 \$finish;
+  end
+endmodule
+END
+  ) > $DESIGN
+}
+
+run() {
+  start=`date +%s.%N`
+  $VERGA -q -j $1 -Q $PROFILE $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$start $end" | awk '{ printf "%f\n",$2-$1 }'
+}
+
+echo "   cores   regs cycles  jobs  us/cycle  speedup  cut"
+j=1
+while [ $j -le $JOBS ]; do
+  design 0
+  base=`run $j`
+  design `expr $CYCLES \* 2`
+  t=`run $j`
+  cut=`sed -n 's/.*"cut": \([0-9]*\).*/\1/p' $PROFILE`
+  c=`echo "$base $t $CYCLES" | awk '{ printf "%f\n",($2-$1)*1e6/$3 }'`
+  if [ $j -eq 1 ]; then
+    c1=$c
+  fi
+  echo "$CORES $REGS $CYCLES $j $c $c1 ${cut:-0}" | awk '{ printf "%8d %6d %6d %5d %9.1f %8.2f %4d\n",$1,$2,$3,$4,$5,$6/$5,$7 }'
+  j=`expr $j \* 2`
+done
+rm -f $DESIGN $PROFILE
@@ -0,0 +1,45 @@
+#!/bin/sh
+#
+# Vector kernels.  A loop applies bitwise, reduction and equality operators to
+# registers of a given width, once with the vector kernels disabled (-X none)
+# and once with the best instruction set the processor supports.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-500000}
+DESIGN=/tmp/simd$$.v
+
+echo "   width  isa           iter   seconds"
+for width in 256 512 1024 4096; do
+  cat > $DESIGN <<END
+module top;
+  reg [$width-1:0] a, b, c, x;
+  reg p, q;
+  integer n, k;
+
+  initial begin
+    a = {128{32'h9e3779b9}};
+    b = {128{32'h7f4a7c15}};
+    c = a;
+    x = 0;
+    k = 0;
+    for (n = 0;n < $ITER;n = n + 1) begin
+      x = (a & b) | (x ^ c);
+      p = &x;
+      q = ^x;
+      if (x == a) k = k + 1;
+      if (b !== c) k = k + 1;
+    end
+    \$finish;
+  end
+endmodule
+END
+  for isa in none default; do
+    if [ $isa = none ]; then opt="-X none"; else opt=""; fi
+    start=`date +%s.%N`
+    $VERGA -q $opt $DESIGN > /dev/null
+    end=`date +%s.%N`
+    echo "$width $isa $ITER $start $end" | awk '{ printf "%8d  %-7s %9d %9.3f\n",$1,$2,$3,$5-$4 }'
+  done
+done
+rm -f $DESIGN
@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+# Readers of slices of a wide register.  Each of a number of processes reads
+# its own 4-bit field of a register, and a loop changes one field at a time,
+# so that only one of the processes needs to wake up for each change.
+#
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-200000}
+DESIGN=/tmp/slice$$.v
+
+echo "  fields      iter   seconds"
+for fields in 4 16 64; do
+  (
+    echo "module top;"
+    echo "  reg [$fields*4-1:0] r;"
+    echo "  reg [3:0] f [0:$fields-1];"
+    echo "  integer n;"
+    i=0
+    while [ $i -lt $fields ]; do
+      echo "  always @(*) f[$i] = r[$i*4 +: 4] + 1;"
+      i=`expr $i + 1`
+    done
+    cat <<END
+  initial begin
+    r = 0;
+    for (n = 0;n < $ITER;n = n + 1)
+      #1 r[(n % $fields)*4 +: 4] = n / $fields;
+    \$finish;
+  end
+endmodule
+END
+  ) > $DESIGN
+  start=`date +%s.%N`
+  $VERGA -q $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$fields $ITER $start $end" | awk '{ printf "%8d %9d %9.3f\n",$1,$2,$4-$3 }'
+done
+rm -f $DESIGN
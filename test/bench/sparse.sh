@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+# Run time vs. delay sparsity.  Each run toggles a few clocks a fixed number
+# of times, but with increasing delay between toggles so that more and more
+# of the simulated epochs are idle.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+TOGGLES=${TOGGLES:-200000}
+DESIGN=/tmp/sparse$$.v
+
+echo "   delay         epochs  seconds"
+for d in 1 10 100 1000 4095 4096 10000 100000 1000000; do
+  t=`expr $TOGGLES \* $d`
+  cat > $DESIGN <<END
+module top;
+  reg a, b, c;
+  integer n;
+
+  initial begin
+    a = 0; b = 0; c = 0; n = 0;
+  end
+
+  always #$d begin
+    a = ~a;
+    n = n + 1;
+    if (n == $TOGGLES) \$finish;
+  end
+  always #$d b = ~a;
+  always @(a) c = a ^ b;
+endmodule
+END
+  start=`date +%s.%N`
+  $VERGA -q $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$d $t $start $end" | awk '{ printf "%8d %14s %8.3f\n",$1,$2,$4-$3 }'
+done
+rm -f $DESIGN
@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# Value storage.  The first part builds a design with NETS scalar regs and
+# reports the peak resident memory of the simulator.  The second part times
+# a loop that copies a value and compares it with ===, which spends most of
+# its time in Value_copy and Value_isEqual, for several value widths.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+NETS=${NETS:-1000000}
+ITER=${ITER:-2000000}
+DESIGN=/tmp/values$$.v
+
+awk -v nets=$NETS 'BEGIN {
+  print "module top;";
+  print "  integer n;";
+  for (i = 0;i < nets;i += 1000) {
+    printf "  reg";
+    for (j = i;j < i + 1000 && j < nets;j++) printf "%s r%d", (j > i ? "," : ""), j;
+    print ";";
+  }
+  print "  initial begin";
+  print "    for (n = 0;n < 1000000;n = n + 1) ;";
+  print "    $finish;";
+  print "  end";
+  print "endmodule";
+}' > $DESIGN
+
+#
+# Peak memory is read from /proc while the simulator runs its final loop.
+#
+$VERGA -q $DESIGN > /dev/null &
+pid=$!
+hwm=0
+while kill -0 $pid 2> /dev/null; do
+  x=`awk '/^VmHWM/ { print $2 }' /proc/$pid/status 2> /dev/null`
+  [ -n "$x" ] && hwm=$x
+  sleep 0.05
+done
+wait $pid
+echo "    nets   peak KB"
+echo "$NETS $hwm" | awk '{ printf "%8d %9d\n",$1,$2 }'
+echo
+
+echo "   width      iter   seconds"
+for width in 1 32 64 128; do
+  cat > $DESIGN <<END
+module top;
+  reg [$width-1:0] a, b, r;
+  integer n, k;
+
+  initial begin
+    a = {4{32'h9e3779b9}};
+    b = a;
+    k = 0;
+    for (n = 0;n < $ITER;n = n + 1) begin
+      r = a;
+      if (r === b) k = k + 1;
+    end
+    \$finish;
+  end
+endmodule
+END
+  start=`date +%s.%N`
+  $VERGA -q $DESIGN > /dev/null
+  end=`date +%s.%N`
+  echo "$width $ITER $start $end" | awk '{ printf "%8d %9d %9.3f\n",$1,$2,$4-$3 }'
+done
+rm -f $DESIGN
@@ -0,0 +1,50 @@
+#!/bin/sh
+#
+# Wide data path operators.  A loop applies bitwise, add/subtract and compare
+# operators to registers of a given width, so the run time follows the
+# number of words each operator touches.  A second loop times multiply,
+# divide and modulus at the same widths.
+#
+
+VERGA=${VERGA:-"../../src/verga/verga++"}
+ITER=${ITER:-2000000}
+DESIGN=/tmp/wide$$.v
+
+echo "   width  ops          iter   seconds"
+for width in 64 128 256 512; do
+  for ops in logic muldiv; do
+    if [ $ops = logic ]; then
+      body='x = (a & b) | (x ^ c);
+      y = x + a - b;
+      if (y > c) k = k + 1;
+      if (x == y) k = k + 1;'
+    else
+      body='x = a * b;
+      y = x / c;
+      z = x % c;'
+    fi
+    cat > $DESIGN <<END
+module top;
+  reg [$width-1:0] a, b, c, x, y, z;
+  integer n, k;
+
+  initial begin
+    a = {16{32'h9e3779b9}};
+    b = {16{32'h7f4a7c15}};
+    c = {8{32'h00000001}};
+    x = 0;
+    k = 0;
+    for (n = 0;n < $ITER;n = n + 1) begin
+      $body
+    end
+    \$finish;
+  end
+endmodule
+END
+    start=`date +%s.%N`
+    $VERGA -q $DESIGN > /dev/null
+    end=`date +%s.%N`
+    echo "$width $ops $ITER $start $end" | awk '{ printf "%8d  %-6s %9d %9.3f\n",$1,$2,$3,$5-$4 }'
+  done
+done
+rm -f $DESIGN
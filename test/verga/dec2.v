@@ -0,0 +1,24 @@
+//
+// Check decimal conversion of values wide enough to be split by powers of
+// ten, in both directions, and $display lines longer than the default
+// format buffer.
+//
+module top;
+  reg [4095:0] u, s;
+  reg [1023:0] c, d;
+
+  initial
+    begin
+      u = {128{32'hc2b2ae35}};
+      $display("%d", u);
+      $display("%d %d", u, u * 3);
+      c = 17190733398152930424578316454332100476122806340271245818678316624635020058718299824531562362460147623079491482370126804194670203691166454977555221691842458123652629123349862828234365623690729106279450021459572847685646836859769113547252217799092431763868950194963766239040945129175539039221168130589016001;
+      d = 1024'd1000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000012345;
+      $display("%h", c);
+      $display("%h", d);
+      $display("%d", c * d);
+      s = 522194440706576253345876355358312191289982124523691890192116741641976953985778728424413405967498779170445053357219631418993786719092896803631618043925682638972978488271854999170180795067191859157214035005927973113188159419698856372836167342172293308748403954352901852035642024370059304557233988891799014503343469488440893892973452815095130470299789726716411734651513348221529512507986199933857107770846917779942645743159118957217248367043905936319748237550094520674504208530837546834166925275516486044134775384991808184705966507606898412918594045916828375610659246423184062775112999150206172392431297837246097308511903252956622805412865917690043804311051417135098849101156584508839003337597742539960818209685142687562392007453579567729991395256699805775897135553415567045292136442139895777424891477161767258532611634530697452993846501061481697843891439474220308003706472837459911525285821188577408160690315522951458068463354171428220365223949985950890732881736611925133626529949897998045399734600887312408859224933727829625089164535236559716582775403784110923285873186648442456409760158728501220463308455437074192539205964902261490928669488824051563042951500651206733594863336608245755565801460390869016718045121902354170201577095169;
+      $display("%b", s);
+      $display("%d", s);
+    end
+endmodule
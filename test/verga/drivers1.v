@@ -0,0 +1,165 @@
+//
+// Nets with several drivers, each of which drives a random mix of 0, 1, x
+// and z bits.  The value of each net is checked against the value found
+// bit by bit from the drivers of that bit.
+//
+`define W 70
+`define N 5
+
+module top;
+
+  reg [`W-1:0] d0, d1, d2, d3, d4;
+  reg [`W-1:0] e_wire, e_wand, e_wor, e_tri0, e_tri1, e_trireg;
+  integer i, k, n_wire, n_wand, n_wor, n_tri0, n_tri1, n_trireg;
+
+  wire [`W-1:0] w1;
+  wand [`W-1:0] w2;
+  wor [`W-1:0] w3;
+  tri0 [`W-1:0] w4;
+  tri1 [`W-1:0] w5;
+  trireg [`W-1:0] w6;
+
+  assign w1 = d0;
+  assign w1 = d1;
+  assign w1 = d2;
+  assign w1 = d3;
+  assign w1 = d4;
+
+  assign w2 = d0;
+  assign w2 = d1;
+  assign w2 = d2;
+  assign w2 = d3;
+  assign w2 = d4;
+
+  assign w3 = d0;
+  assign w3 = d1;
+  assign w3 = d2;
+  assign w3 = d3;
+  assign w3 = d4;
+
+  assign w4 = d0;
+  assign w4 = d1;
+  assign w4 = d2;
+  assign w4 = d3;
+  assign w4 = d4;
+
+  assign w5 = d0;
+  assign w5 = d1;
+  assign w5 = d2;
+  assign w5 = d3;
+  assign w5 = d4;
+
+  assign w6 = d0;
+  assign w6 = d1;
+  assign w6 = d2;
+  assign w6 = d3;
+  assign w6 = d4;
+
+  //
+  // Random value with about half of its bits floating
+  //
+  function [`W-1:0] drive;
+  input dummy;
+  integer j, r;
+    for (j = 0;j < `W;j = j + 1)
+      begin
+	r = $random & 7;
+	case (r)
+	  0: drive[j] = 1'b0;
+	  1: drive[j] = 1'b1;
+	  2: drive[j] = 1'bx;
+	  default: drive[j] = 1'bz;
+	endcase
+      end
+  endfunction
+
+  //
+  // Expected value of each kind of net from the drivers of each bit
+  //
+  task expect;
+  integer j, c0, c1, cx;
+  reg [`N-1:0] b;
+    for (j = 0;j < `W;j = j + 1)
+      begin
+	b = {d4[j],d3[j],d2[j],d1[j],d0[j]};
+	c0 = 0; c1 = 0; cx = 0;
+	for (k = 0;k < `N;k = k + 1)
+	  if (b[k] === 1'b0)
+	    c0 = c0 + 1;
+	  else if (b[k] === 1'b1)
+	    c1 = c1 + 1;
+	  else if (b[k] === 1'bx)
+	    cx = cx + 1;
+
+	if (c0 + c1 + cx == 0)
+	  begin
+	    e_wire[j] = 1'bz;
+	    e_wand[j] = 1'bz;
+	    e_wor[j] = 1'bz;
+	    e_tri0[j] = 1'b0;
+	    e_tri1[j] = 1'b1;
+	  end
+	else
+	  begin
+	    if (cx > 0 || (c0 > 0 && c1 > 0))
+	      e_wire[j] = 1'bx;
+	    else
+	      e_wire[j] = (c1 > 0);
+	    e_wand[j] = c0 > 0 ? 1'b0 : (cx > 0 ? 1'bx : 1'b1);
+	    e_wor[j] = c1 > 0 ? 1'b1 : (cx > 0 ? 1'bx : 1'b0);
+	    e_tri0[j] = e_wire[j];
+	    e_tri1[j] = e_wire[j];
+	    e_trireg[j] = e_wire[j];
+	  end
+      end
+  endtask
+
+  initial
+    begin
+      n_wire = 0; n_wand = 0; n_wor = 0;
+      n_tri0 = 0; n_tri1 = 0; n_trireg = 0;
+      e_trireg = {`W{1'bx}};
+
+      for (i = 0;i < 200;i = i + 1)
+	begin
+	  //
+	  // Change one driver at a time, or all of them at once.  A trireg
+	  // net takes charge from the drivers as they change one after the
+	  // other, so the expected charge is found after each of them.
+	  //
+	  case (i % 6)
+	    0: d0 = drive(0);
+	    1: d1 = drive(0);
+	    2: d2 = drive(0);
+	    3: d3 = drive(0);
+	    4: d4 = drive(0);
+	    5: begin
+		d0 = drive(0);
+		#1 expect;
+		d1 = drive(0);
+		#1 expect;
+		d2 = drive(0);
+		#1 expect;
+		d3 = drive(0);
+		#1 expect;
+		d4 = drive(0);
+	      end
+	  endcase
+	  #1 expect;
+
+	  if (w1 !== e_wire) n_wire = n_wire + 1;
+	  if (w2 !== e_wand) n_wand = n_wand + 1;
+	  if (w3 !== e_wor) n_wor = n_wor + 1;
+	  if (w4 !== e_tri0) n_tri0 = n_tri0 + 1;
+	  if (w5 !== e_tri1) n_tri1 = n_tri1 + 1;
+	  if (w6 !== e_trireg) n_trireg = n_trireg + 1;
+	end
+
+      $display("wire: %0d errors", n_wire);
+      $display("wand: %0d errors", n_wand);
+      $display("wor: %0d errors", n_wor);
+      $display("tri0: %0d errors", n_tri0);
+      $display("tri1: %0d errors", n_tri1);
+      $display("trireg: %0d errors", n_trireg);
+    end
+endmodule
@@ -0,0 +1,37 @@
+//
+// Gate and continuous assignment handler loops of several shapes
+//
+module top;
+  reg a, b, c;
+  reg [3:0] v;
+  wire y_and, y_nor, y_xnor3, y_sel, y_not1, y_not2, y_lo, y_hi;
+  wire [3:0] y_vec, y_expr;
+
+  and #1 g1(y_and, a, b);		// scalar two-input gate
+  nor #2 g2(y_nor, a, b);
+  xnor #1 g3(y_xnor3, a, b, c);		// three inputs
+  nand #1 g4(y_sel, v[1], v[2]);	// bit-select inputs
+  not #1 g5(y_not1, y_not2, v[3]);	// multiple outputs
+  or #1 g6[3:0](y_vec, v, {a,b,c,a});	// vector gate
+
+  assign #1 y_expr = (v + {3'b0,a}) ^ {b,c,b,c};
+  assign #2 {y_hi, y_lo} = {a & v[0], b | v[0]};
+
+  initial
+    $monitor("%2d: a=%b b=%b c=%b v=%b | %b %b %b %b %b %b %b %b %b %b",$time,a,b,c,v,
+	     y_and,y_nor,y_xnor3,y_sel,y_not1,y_not2,y_vec,y_expr,y_hi,y_lo);
+
+  initial
+    begin
+      a = 0; b = 0; c = 0; v = 4'b0000;
+      #5 a = 1;
+      #5 b = 1;
+      #5 c = 1'bx;
+      #5 v = 4'b0110;
+      #5 v = 4'b1z01;
+      #1 v = 4'b1001;		// narrower than the two unit delays
+      #5 c = 1; a = 0;
+      #5 $finish;
+    end
+
+endmodule
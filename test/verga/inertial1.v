@@ -0,0 +1,27 @@
+module top;
+  reg a, b;
+  wire g, w;
+
+  and #5 g1(g, a, b);
+  assign #3 w = a;
+
+  initial
+    $monitor("%3d: a=%b b=%b g=%b w=%b",$time,a,b,g,w);
+
+  initial
+    begin
+      a = 0;
+      b = 1;
+      #10 a = 1;
+      #2 a = 0;			// narrower than both delays
+      #10 a = 1;
+      #4 a = 0;			// passes w, but not g
+      #10 a = 1;
+      #6 a = 0;			// passes both
+      #10 b = 0;
+      #1 a = 1;
+      #1 b = 1;			// same value re-scheduled
+      #10 $finish;
+    end
+
+endmodule
@@ -0,0 +1,58 @@
+//
+// Check the width-specialized operator kernels against known results for
+// scalar, single word and two word operands, with and without x/z bits.
+//
+module top;
+  reg a, b;
+  wire wand1, wnand1, wor1, wnor1, wxor1, wxnor1, wnot1, wbuf1;
+  reg [11:0] p, q;
+  reg [47:0] m, n;
+  reg [63:0] u, v;
+
+  and g1(wand1, a, b);
+  nand g2(wnand1, a, b);
+  or g3(wor1, a, b);
+  nor g4(wnor1, a, b);
+  xor g5(wxor1, a, b);
+  xnor g6(wxnor1, a, b);
+  not g7(wnot1, a);
+  buf g8(wbuf1, b);
+
+  initial
+    begin
+      a = 1'b0; b = 1'b0;
+      #1 $display("%b%b: %b%b%b%b%b%b%b%b", a, b, wand1, wnand1, wor1, wnor1, wxor1, wxnor1, wnot1, wbuf1);
+      a = 1'b1; b = 1'b0;
+      #1 $display("%b%b: %b%b%b%b%b%b%b%b", a, b, wand1, wnand1, wor1, wnor1, wxor1, wxnor1, wnot1, wbuf1);
+      a = 1'b1; b = 1'b1;
+      #1 $display("%b%b: %b%b%b%b%b%b%b%b", a, b, wand1, wnand1, wor1, wnor1, wxor1, wxnor1, wnot1, wbuf1);
+      a = 1'b0; b = 1'bx;
+      #1 $display("%b%b: %b%b%b%b%b%b%b%b", a, b, wand1, wnand1, wor1, wnor1, wxor1, wxnor1, wnot1, wbuf1);
+      a = 1'b1; b = 1'bz;
+      #1 $display("%b%b: %b%b%b%b%b%b%b%b", a, b, wand1, wnand1, wor1, wnor1, wxor1, wxnor1, wnot1, wbuf1);
+
+      a = 1'b1; b = 1'b1;
+      $display("1 bit: %b %b %b %b %b %b", a + b, a - b, a > b, a < b, a >= b, a <= b);
+      b = 1'bx;
+      $display("1 bit: %b %b %b %b %b %b", a + b, a - b, a > b, a < b, a >= b, a <= b);
+
+      p = 12'h9c3; q = 12'h0f5;
+      $display("12 bit: %h %h %h %h %h %h", p & q, p | q, p ^ q, ~p, p + q, p - q);
+      $display("12 bit: %b %b %b %b", p > q, p < q, p >= q, p <= q);
+      q = 12'h0x5;
+      $display("12 bit: %h %h %h %h %h", p & q, p | q, p ^ q, p + q, p - q);
+      $display("12 bit: %b %b %b %b", p > q, p < q, p >= q, p <= q);
+
+      m = 48'h8000ffff0001; n = 48'h00010000ffff;
+      $display("48 bit: %h %h %h %h %h %h", m & n, m | n, m ^ n, ~m, m + n, n - m);
+      $display("48 bit: %b %b %b %b", m > n, m < n, m >= n, m <= n);
+      n = 48'h00010000fzff;
+      $display("48 bit: %h %h %h %h %h", m & n, m | n, m ^ n, m + n, n - m);
+      $display("48 bit: %b %b %b %b", m > n, m < n, m >= n, m <= n);
+
+      u = 64'hffffffffffffffff; v = 64'h0000000000000001;
+      $display("64 bit: %h %h %h %b %b", u + v, v - u, u ~^ v, u > v, u <= v);
+      u = 64'h1234567800000000; v = 64'h1234567800000000;
+      $display("64 bit: %h %h %b %b %b %b", u + v, u - v, u > v, u < v, u >= v, u <= v);
+    end
+endmodule
@@ -0,0 +1,98 @@
+//
+// Values that go from 2-state to 4-state and back through operators, nets,
+// shifts, concatenation and memories.  Operators skip the x/z tests of
+// operands that are known to be 2-state, so every result is checked against
+// the same operator applied one bit at a time.
+//
+module top;
+  check #(.W(8)) c1();
+  check #(.W(64)) c2();
+  check #(.W(100)) c3();
+  check #(.W(300), .TRIALS(12)) c4();
+endmodule
+
+module check #(.W(8), .TRIALS(24)) ();
+  reg [W-1:0] a, b, r, s;
+  reg [W-1:0] mem[0:3];
+  reg [2*W-1:0] cat;
+  reg [31:0] k;
+  reg e, x;
+  integer t, i, errors;
+  wire [W-1:0] wa = a;
+  wire [W-1:0] wand_ab = a & b;
+  wire [W-1:0] sel = e ? a : b;
+
+  initial
+    begin
+      errors = 0;
+      for (t = 0;t < TRIALS;t = t + 1)
+	begin
+	  //
+	  // Even trials use 2-state values; odd ones put a few x or z bits in
+	  // one operand.
+	  //
+	  for (i = 0;i < W;i = i + 1)
+	    begin
+	      k = $random;
+	      a[i] = k[0];
+	      b[i] = k[1];
+	      if (t % 2 == 1 && k[6:2] == 0)
+		a[i] = k[7] ? 1'bx : 1'bz;
+	    end
+	  e = t[1];
+	  #1;
+
+	  //
+	  // Nets follow the registers from 2-state to 4-state and back.
+	  //
+	  for (i = 0;i < W;i = i + 1)
+	    begin
+	      if (wa[i] !== a[i]) errors = errors + 1;
+	      if (wand_ab[i] !== (a[i] & b[i])) errors = errors + 1;
+	      if (sel[i] !== (e ? a[i] : b[i])) errors = errors + 1;
+	    end
+
+	  r = a | b;
+	  s = ~r;
+	  for (i = 0;i < W;i = i + 1)
+	    if (s[i] !== ~(a[i] | b[i])) errors = errors + 1;
+
+	  r = a >> 3;
+	  for (i = 0;i < W;i = i + 1)
+	    if (i+3 < W)
+	      begin
+		if (r[i] !== a[i+3]) errors = errors + 1;
+	      end
+	    else if (r[i] !== 1'b0) errors = errors + 1;
+	  r = b << 5;
+	  for (i = 0;i < W;i = i + 1)
+	    if (i >= 5)
+	      begin
+		if (r[i] !== b[i-5]) errors = errors + 1;
+	      end
+	    else if (r[i] !== 1'b0) errors = errors + 1;
+
+	  cat = {a,b};
+	  for (i = 0;i < W;i = i + 1)
+	    if (cat[i] !== b[i] || cat[i+W] !== a[i]) errors = errors + 1;
+
+	  mem[t%4] = a;
+	  r = mem[t%4];
+	  if (r !== a) errors = errors + 1;
+
+	  r = a + b;
+	  x = (r === r);
+	  if (x !== 1'b1) errors = errors + 1;
+	  for (i = 0;i < W;i = i + 1)
+	    if ((a[i] === 1'bx || a[i] === 1'bz) && r !== {W{1'bx}}) errors = errors + 1;
+
+	  x = ^a;
+	  e = 1'b0;
+	  for (i = 0;i < W;i = i + 1) e = e ^ a[i];
+	  if (x !== e) errors = errors + 1;
+	  x = (a == b);
+	  if (x !== ((a === b) ? 1'b1 : (e === 1'bx) ? 1'bx : 1'b0)) errors = errors + 1;
+	end
+      $display("%0d bits: %0d trials, %0d errors", W, TRIALS, errors);
+    end
+endmodule
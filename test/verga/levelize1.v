@@ -0,0 +1,53 @@
+//
+// Synchronous logic of the kind evaluated in levelized passes with -L, mixed
+// with gates that stay event driven: a delayed gate, a latch on a loop, a
+// tristate bus and a net driven in parts.  The output must be the same with
+// and without -L.
+//
+module top;
+  reg clk, en;
+  reg [7:0] q;
+  wire [7:0] sum, nxt;
+  wire [3:0] hi;
+  wire par, d1, s_n, r_n, l, lb;
+  wire [3:0] bus;
+  wire [7:0] parts;
+  integer i;
+
+  assign sum = q + 8'd3;
+  assign hi = sum[7:4];
+  assign nxt = {hi ^ q[3:0], sum[3:0]};
+  xor (par, nxt[0], nxt[1], nxt[2], nxt[3], nxt[4], nxt[5], nxt[6], nxt[7]);
+  not #2 (d1, par);
+
+  assign s_n = ~(par & en);
+  assign r_n = ~(~par & en);
+  nand (l, s_n, lb);
+  nand (lb, r_n, l);
+
+  bufif1 (bus[0], par, en);
+  bufif0 (bus[0], d1, en);
+  assign bus[3:1] = hi[2:0];
+
+  assign parts[3:0] = q[7:4];
+  assign parts[7:4] = q[3:0];
+
+  always @(posedge clk)
+    q <= nxt;
+
+  always @(negedge clk)
+    #1 $display("%0d: q=%h sum=%h nxt=%h par=%b d1=%b l=%b bus=%b parts=%h",
+	     $time, q, sum, nxt, par, d1, l, bus, parts);
+
+  initial begin
+    clk = 0;
+    en = 0;
+    q = 8'h5a;
+    for (i = 0;i < 12;i = i + 1) begin
+      #5 clk = 1;
+      #5 clk = 0;
+      if (i == 5) en = 1;
+    end
+    $finish;
+  end
+endmodule
@@ -0,0 +1,34 @@
+//
+// Check multiply, divide and modulus on operands long enough to take the
+// Karatsuba multiply and multi-word long division.
+//
+module top;
+  reg [1023:0] a, b, p, q;
+  reg [4095:0] u, v, w, z;
+  reg ok;
+
+  initial
+    begin
+      a = {32{32'h9e3779b9}};
+      b = {16{64'h7f4a7c15f39cc060}} >> 7;
+      p = a * b;
+      $display("%h", p);
+      q = a / (b >> 500);
+      $display("%h", q);
+      $display("%h", a % (b >> 500));
+
+      u = {128{32'hc2b2ae35}};
+      v = {64{64'h27d4eb2f165667b1}} >> 1031;
+      w = u * v;
+      $display("%h %h %h", w[127:0], w[2175:2048], w[4095:3968]);
+      w = u * u;
+      $display("%h %h %h", w[127:0], w[2175:2048], w[4095:3968]);
+      z = u / v;
+      $display("%h %h", z[127:0], z[1151:1024]);
+      z = u % v;
+      $display("%h %h", z[127:0], z[3071:2944]);
+      z = (w / v) * v + (w % v);
+      ok = (z == w);
+      $display("%b", ok);
+    end
+endmodule
@@ -0,0 +1,81 @@
+//
+// Net updates that change nothing, one bit in one word, a part select or
+// the whole value.  Only updates that change the net may wake up the
+// processes waiting on it.
+//
+module top;
+  reg b;
+  wire bw = b;
+
+  always @(posedge bw) $display("%0t: posedge %b", $time, bw);
+  always @(negedge bw) $display("%0t: negedge %b", $time, bw);
+
+  initial
+    begin
+      #1 b = 1'b0;
+      #1 b = 1'b0;
+      #1 b = 1'bx;
+      #1 b = 1'b1;
+      #1 b = 1'bz;
+      #1 b = 1'b0;
+      #1 b = 1'bz;
+      #1 b = 1'bx;
+      #1 b = 1'bx;
+      #1 b = 1'b0;
+      #1 b = 1'b1;
+    end
+
+  check #(.W(8)) c1();
+  check #(.W(64)) c2();
+  check #(.W(100)) c3();
+  check #(.W(300)) c4();
+endmodule
+
+module check #(.W(8)) ();
+  reg [W-1:0] r, v;
+  wire [W-1:0] w = r;
+  integer nr, nw, expect, i;
+
+  always @(r) nr = nr + 1;
+  always @(w) nw = nw + 1;
+
+  initial
+    begin
+      #20 nr = 0;
+      nw = 0;
+      v = {10{32'h9e3779b9}};
+      r = v;
+      #1 expect = 1;
+
+      r = v;
+      #1;
+
+      //
+      // One bit in each word, then back.
+      //
+      for (i = 0;i < W;i = i + 13)
+	begin
+	  r[i] = ~r[i];
+	  #1 r = v;
+	  #1 expect = expect + 2;
+	end
+
+      r[W-1] = 1'bx;
+      #1 r[W-1] = 1'bx;
+      #1 r[W-1] = 1'bz;
+      #1 r = v;
+      #1 expect = expect + 3;
+
+      r[W-1:W/2] = v[W-1:W/2];
+      #1 r[W-1:W/2] = ~v[W-1:W/2];
+      #1 r[W/2+3:3] = {W{1'b1}};
+      #1 r = ~v;
+      #1 r = ~v;
+      #1 expect = expect + 3;
+
+      if (nr !== expect || nw !== expect)
+	$display("%0d bits: %0d reg and %0d wire events, expected %0d", W, nr, nw, expect);
+      else
+	$display("%0d bits: %0d events", W, nr);
+    end
+endmodule
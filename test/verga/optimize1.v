@@ -0,0 +1,80 @@
+//
+// Check that optimized bytecode gives the same results as unoptimized
+// bytecode.  Covers folding of parameter expressions and constant branches,
+// copy propagation from function results and nets, jump chains from nested
+// if/else and null statements.
+//
+module sub #(.WIDTH(4), .SHIFT(2)) (z,a);
+  output [WIDTH-1:0] z;
+  input [WIDTH-1:0] a;
+  reg [WIDTH-1:0] z;
+
+  always @(a)
+    z = (a << SHIFT) | (a >> (WIDTH - SHIFT));
+endmodule
+
+module top;
+  parameter N = 5;
+  parameter MASK = (1 << N) - 1;
+  parameter DEBUG = 0;
+  reg [7:0] a, b;
+  reg [15:0] w;
+  integer i, k, sum;
+  wire [3:0] z4;
+  wire [7:0] z8;
+
+  sub s1(z4, a[3:0]);
+  sub #(.WIDTH(8), .SHIFT(4)) s2(z8, a);
+
+  function [7:0] twice;
+    input [7:0] x;
+    twice = x + x;
+  endfunction
+
+  function [15:0] mix;
+    input [7:0] x, y;
+    mix = {x, y} ^ MASK;
+  endfunction
+
+  initial
+    begin
+      sum = 0;
+      for (i = 0; i < N*2; i = i + 1)
+        begin
+	  if (DEBUG)
+	    $display("debug %d", i);
+	  else if (i % 3 == 0)
+	    sum = sum + MASK;
+	  else if (i % 3 == 1)
+	    ;
+	  else
+	    sum = sum - (N + 1);
+	end
+      $display("sum=%0d", sum);
+
+      k = 0;
+      repeat (N + 2)
+	k = k + twice(N - 2);
+      $display("k=%0d", k);
+
+      a = 8'h5a;
+      b = twice(a) + twice(8'd3);
+      w = mix(a, b);
+      $display("a=%h b=%h w=%h", a, b, w);
+
+      {a[3:0], a[7:4]} = a;
+      $display("swapped a=%h", a);
+
+      #1 $display("z4=%h z8=%h", z4, z8);
+
+      a = 8'h81;
+      #1 $display("z4=%h z8=%h", z4, z8);
+
+      if (MASK == 31 && !DEBUG)
+	$display("mask ok");
+      else
+	$display("mask bad");
+
+      $finish;
+    end
+endmodule
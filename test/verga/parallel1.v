@@ -0,0 +1,95 @@
+//
+// Many registers clocked by the same edge, which -j runs on several
+// threads at once.  Each register reads others that are written on the
+// same edge, so non-blocking assignments must still see the old values.
+// The output must be the same with and without -j.
+//
+module top;
+  reg clk;
+  reg [15:0] r0, r1, r2, r3, r4, r5, r6, r7, r8, r9, r10, r11, r12, r13, r14, r15, r16, r17, r18, r19, r20, r21, r22, r23, r24, r25, r26, r27, r28, r29, r30, r31;
+  reg [3:0] cnt;
+  integer i;
+
+  always @(posedge clk) r0 <= r1 + r7 + 16'd1;
+  always @(posedge clk) r1 <= r2 ^ {r8[14:0], r8[15]};
+  always @(posedge clk) r2 <= (r3 & 16'h0ff0) | (r9 >> 3);
+  always @(posedge clk) r3 <= r4 - r10 * 16'd3;
+  always @(posedge clk) r4 <= r5 + r11 + 16'd5;
+  always @(posedge clk) r5 <= r6 ^ {r12[14:0], r12[15]};
+  always @(posedge clk) r6 <= (r7 & 16'h0ff0) | (r13 >> 3);
+  always @(posedge clk) r7 <= r8 - r14 * 16'd3;
+  always @(posedge clk) r8 <= r9 + r15 + 16'd9;
+  always @(posedge clk) r9 <= r10 ^ {r16[14:0], r16[15]};
+  always @(posedge clk) r10 <= (r11 & 16'h0ff0) | (r17 >> 3);
+  always @(posedge clk) r11 <= r12 - r18 * 16'd3;
+  always @(posedge clk) r12 <= r13 + r19 + 16'd13;
+  always @(posedge clk) r13 <= r14 ^ {r20[14:0], r20[15]};
+  always @(posedge clk) r14 <= (r15 & 16'h0ff0) | (r21 >> 3);
+  always @(posedge clk) r15 <= r16 - r22 * 16'd3;
+  always @(posedge clk) r16 <= r17 + r23 + 16'd17;
+  always @(posedge clk) r17 <= r18 ^ {r24[14:0], r24[15]};
+  always @(posedge clk) r18 <= (r19 & 16'h0ff0) | (r25 >> 3);
+  always @(posedge clk) r19 <= r20 - r26 * 16'd3;
+  always @(posedge clk) r20 <= r21 + r27 + 16'd21;
+  always @(posedge clk) r21 <= r22 ^ {r28[14:0], r28[15]};
+  always @(posedge clk) r22 <= (r23 & 16'h0ff0) | (r29 >> 3);
+  always @(posedge clk) r23 <= r24 - r30 * 16'd3;
+  always @(posedge clk) r24 <= r25 + r31 + 16'd25;
+  always @(posedge clk) r25 <= r26 ^ {r0[14:0], r0[15]};
+  always @(posedge clk) r26 <= (r27 & 16'h0ff0) | (r1 >> 3);
+  always @(posedge clk) r27 <= r28 - r2 * 16'd3;
+  always @(posedge clk) r28 <= r29 + r3 + 16'd29;
+  always @(posedge clk) r29 <= r30 ^ {r4[14:0], r4[15]};
+  always @(posedge clk) r30 <= (r31 & 16'h0ff0) | (r5 >> 3);
+  always @(posedge clk) r31 <= r0 - r6 * 16'd3;
+
+  always @(posedge clk)
+    cnt <= cnt + 1;
+
+  always @(negedge clk)
+    $display("%0d: cnt=%0d %h %h %h %h %h %h %h %h", $time, cnt, r0, r4, r8, r12, r16, r20, r24, r28);
+  always @(negedge clk)
+    $display("%0d: %h %h %h %h %h %h %h %h", $time, r1, r5, r9, r13, r17, r21, r25, r29);
+
+  initial begin
+    clk = 0;
+    cnt = 0;
+    r0 = 16'h2468;
+    r1 = 16'h37bf;
+    r2 = 16'h4b16;
+    r3 = 16'h5e6d;
+    r4 = 16'h71c4;
+    r5 = 16'h851b;
+    r6 = 16'h9872;
+    r7 = 16'habc9;
+    r8 = 16'hbf20;
+    r9 = 16'hd277;
+    r10 = 16'he5ce;
+    r11 = 16'hf925;
+    r12 = 16'h0c7c;
+    r13 = 16'h1fd3;
+    r14 = 16'h332a;
+    r15 = 16'h4681;
+    r16 = 16'h59d8;
+    r17 = 16'h6d2f;
+    r18 = 16'h8086;
+    r19 = 16'h93dd;
+    r20 = 16'ha734;
+    r21 = 16'hba8b;
+    r22 = 16'hcde2;
+    r23 = 16'he139;
+    r24 = 16'hf490;
+    r25 = 16'h07e7;
+    r26 = 16'h1b3e;
+    r27 = 16'h2e95;
+    r28 = 16'h41ec;
+    r29 = 16'h5543;
+    r30 = 16'h689a;
+    r31 = 16'h7bf1;
+    for (i = 0;i < 20;i = i + 1) begin
+      #5 clk = 1;
+      #5 clk = 0;
+    end
+    $finish;
+  end
+endmodule
@@ -0,0 +1,53 @@
+//
+// Several cores of registers, each clocked by the same edge and passing a
+// value to the next core through a port.  With -j the registers of each
+// core are kept together in a partition, which may also be chosen with -p
+// (e.g. "-p top.c2=0").  The output must be the same with and without -j.
+//
+module core #(.SEED(0)) (clk, in, out);
+  input clk;
+  input [15:0] in;
+  output [15:0] out;
+  reg [15:0] a, b, c, d, e, f;
+
+  assign out = f;
+
+  always @(posedge clk) a <= in + b;
+  always @(posedge clk) b <= a ^ {c[7:0], c[15:8]};
+  always @(posedge clk) c <= (b >> 1) + d;
+  always @(posedge clk) d <= c - e * 16'd5;
+  always @(posedge clk) e <= d | (a & 16'h0f0f);
+  always @(posedge clk) f <= e + a;
+
+  initial begin
+    a = SEED;
+    b = SEED * 3;
+    c = SEED + 16'h1111;
+    d = SEED ^ 16'h5a5a;
+    e = 16'd7;
+    f = 16'd0;
+  end
+endmodule
+
+module top;
+  reg clk;
+  wire [15:0] o0, o1, o2, o3;
+  integer i;
+
+  core #(.SEED(16'h1234)) c0 (clk, o3, o0);
+  core #(.SEED(16'h2345)) c1 (clk, o0, o1);
+  core #(.SEED(16'h3456)) c2 (clk, o1, o2);
+  core #(.SEED(16'h4567)) c3 (clk, o2, o3);
+
+  always @(negedge clk)
+    #2 $display("%0d: %h %h %h %h", $time, o0, o1, o2, o3);
+
+  initial begin
+    clk = 0;
+    for (i = 0;i < 16;i = i + 1) begin
+      #5 clk = 1;
+      #5 clk = 0;
+    end
+    $finish;
+  end
+endmodule
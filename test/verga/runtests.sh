@@ -1,4 +1,8 @@
 #!/bin/sh
+#
+# Any arguments are passed on to verga, so that the same expected outputs
+# can be checked with other options (e.g. "./runtests.sh -L").
+#
 
 VERGA="../../src/verga/verga++"
 
@@ -7,7 +11,7 @@ FAIL=0
 for f in *.v; do
   
   echo -n "checking $f ... "
-  $VERGA -q $f > verga.out
+  $VERGA -q "$@" $f > verga.out
   if diff -q verga.out ${f%.v}.out 1> /dev/null; then
     echo "ok"
     PASS=`expr $PASS + 1`
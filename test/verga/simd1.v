@@ -0,0 +1,103 @@
+//
+// Cross-check the vector kernels for wide bitwise, reduction and equality
+// operators against the same operators applied one bit at a time, on random
+// 4-state values.  The widths cover whole vectors, a partial last vector and
+// a partial top word.
+//
+module top;
+  check c1();
+  check #(.W(520)) c2();
+  check #(.W(1024), .TRIALS(16)) c3();
+endmodule
+
+module check #(.W(256), .TRIALS(40)) ();
+  reg [W-1:0] a, b, r;
+  reg [31:0] k;
+  reg e, ne, x, nx, fl, df;
+  integer t, i, errors;
+
+  initial
+    begin
+      errors = 0;
+      for (t = 0;t < TRIALS;t = t + 1)
+	begin
+	  //
+	  // Trials cycle through 4-state values, 2-state values, all ones
+	  // with a few x/z bits, and equal operands.
+	  //
+	  for (i = 0;i < W;i = i + 1)
+	    begin
+	      k = $random;
+	      case (t % 4)
+		0 : a[i] = (k[2:0] == 0) ? 1'bx : (k[2:0] == 1) ? 1'bz : k[3];
+		1 : a[i] = k[3];
+		2 : a[i] = (k[7:0] == 0) ? 1'bx : 1'b1;
+		3 : a[i] = k[3];
+	      endcase
+	      k = $random;
+	      case (t % 4)
+		0 : b[i] = (k[2:0] == 0) ? 1'bz : (k[2:0] == 1) ? 1'bx : k[3];
+		1 : b[i] = k[3];
+		2 : b[i] = (k[7:0] == 0) ? 1'bz : 1'b1;
+		3 : b[i] = a[i];
+	      endcase
+	    end
+	  if (t % 8 == 7)
+	    b[W-1] = ~b[W-1];
+
+	  r = a & b;
+	  for (i = 0;i < W;i = i + 1) if (r[i] !== (a[i] & b[i])) errors = errors + 1;
+	  r = a ~& b;
+	  for (i = 0;i < W;i = i + 1) if (r[i] !== (a[i] ~& b[i])) errors = errors + 1;
+	  r = a | b;
+	  for (i = 0;i < W;i = i + 1) if (r[i] !== (a[i] | b[i])) errors = errors + 1;
+	  r = a ~| b;
+	  for (i = 0;i < W;i = i + 1) if (r[i] !== (a[i] ~| b[i])) errors = errors + 1;
+	  r = a ^ b;
+	  for (i = 0;i < W;i = i + 1) if (r[i] !== (a[i] ^ b[i])) errors = errors + 1;
+	  r = a ~^ b;
+	  for (i = 0;i < W;i = i + 1) if (r[i] !== (a[i] ~^ b[i])) errors = errors + 1;
+	  r = ~a;
+	  for (i = 0;i < W;i = i + 1) if (r[i] !== ~a[i]) errors = errors + 1;
+
+	  e = 1'b1;
+	  for (i = 0;i < W;i = i + 1) e = e & a[i];
+	  ne = ~e;
+	  x = &a;
+	  nx = ~&a;
+	  if (x !== e || nx !== ne) errors = errors + 1;
+	  e = 1'b0;
+	  for (i = 0;i < W;i = i + 1) e = e | a[i];
+	  ne = ~e;
+	  x = |a;
+	  nx = ~|a;
+	  if (x !== e || nx !== ne) errors = errors + 1;
+	  e = 1'b0;
+	  for (i = 0;i < W;i = i + 1) e = e ^ b[i];
+	  ne = ~e;
+	  x = ^b;
+	  nx = ~^b;
+	  if (x !== e || nx !== ne) errors = errors + 1;
+
+	  //
+	  // == is unknown if either operand has an x or z bit.
+	  //
+	  fl = 0;
+	  df = 0;
+	  for (i = 0;i < W;i = i + 1)
+	    begin
+	      if (a[i] === 1'bx || a[i] === 1'bz || b[i] === 1'bx || b[i] === 1'bz) fl = 1;
+	      if (a[i] !== b[i]) df = 1;
+	    end
+	  e = fl ? 1'bx : !df;
+	  ne = fl ? 1'bx : df;
+	  x = (a == b);
+	  nx = (a != b);
+	  if (x !== e || nx !== ne) errors = errors + 1;
+	  x = (a === b);
+	  nx = (a !== b);
+	  if (x !== !df || nx !== df) errors = errors + 1;
+	end
+      $display("%0d bits: %0d trials, %0d errors", W, TRIALS, errors);
+    end
+endmodule
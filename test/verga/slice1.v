@@ -0,0 +1,56 @@
+//
+// Processes that read some bits of a wide register are woken only by
+// changes in those bits.  Each process counts its wakeups, including the
+// one when its counter is cleared.  A process that reads several ranges of
+// the register is woken by changes between them too.
+//
+module top;
+  parameter T = 99;
+  reg [99:0] bus;
+  reg b3, bt;
+  reg [6:0] hi;
+  reg [3:0] up, dn;
+  reg [67:0] mid;
+  integer i;
+  integer n3, nhi, nup, ndn, nmid, nall, nvar, nt, nw;
+  wire [1:0] w = {bus[T], bus[3]};
+
+  always @(*) begin b3 = bus[3]; n3 = n3 + 1; end
+  always @(*) begin hi = bus[70:64]; nhi = nhi + 1; end
+  always @(*) begin up = bus[8 +: 4]; nup = nup + 1; end
+  always @(*) begin dn = bus[99 -: 4]; ndn = ndn + 1; end
+  always @(*) begin mid = {bus[70:64], bus[3]}; nmid = nmid + 1; end
+  always @(*) begin bt = bus[T]; nt = nt + 1; end
+  always @(*) begin b3 = bus[i]; nvar = nvar + 1; end
+  always @(bus) nall = nall + 1;
+  always @(w) nw = nw + 1;
+
+  initial
+    begin
+      i = 5;
+      bus = 0;
+      #1 n3 = 0; nhi = 0; nup = 0; ndn = 0; nmid = 0; nall = 0; nvar = 0; nt = 0; nw = 0;
+
+      #1 bus[3] = 1;			// n3 nmid nall nvar nw
+      #1 bus[50] = 1;			// nmid nall nvar
+      #1 bus[65] = 1;			// nhi nmid nall nvar
+      #1 bus[10:9] = 2'b11;		// nup nmid nall nvar
+      #1 bus[97] = 1'bx;		// ndn nall nvar
+      #1 bus[99] = 1;			// ndn nt nall nvar nw
+      #1 bus[50] = 1;			// nothing changes
+      #1 bus = ~bus;			// all
+      #1 bus[40:20] <= 0;		// nmid nall nvar
+      #1;
+
+      $display("bus[3]: %0d", n3);
+      $display("bus[70:64]: %0d", nhi);
+      $display("bus[8 +: 4]: %0d", nup);
+      $display("bus[99 -: 4]: %0d", ndn);
+      $display("{bus[70:64], bus[3]}: %0d", nmid);
+      $display("bus[T]: %0d", nt);
+      $display("bus[i]: %0d", nvar);
+      $display("bus: %0d", nall);
+      $display("w: %0d", nw);
+      $display("%b %b %b %b %b %b %b", b3, hi, up, dn, mid[7:0], bt, w);
+    end
+endmodule
@@ -0,0 +1,26 @@
+module top;
+  reg [7:0] r;
+  reg ck;
+
+  initial
+    $monitor("%6d: r=%d ck=%b",$time,r,ck);
+
+  initial
+    begin
+      r = 0;
+      ck = 1'b0;
+      #3 ck = 1'b1;
+      #5000 r = 1;
+      #4096 r = 2;
+      #4095 r = 3;
+      #1 r = 4;
+      #100000 r = 5;
+      #2 ck = 1'b0;
+      #10000 $display("%6d: done", $time);
+      $finish;
+    end
+
+  initial
+    #8192 r = 8'hff;
+
+endmodule
@@ -0,0 +1,51 @@
+//
+// Check multi-word arithmetic, comparison and decimal conversion on values
+// that span several words, including carries and borrows across word
+// boundaries and divisors of one and more words.
+//
+module top;
+  reg [127:0] a, b, r;
+  reg [255:0] p, q, s;
+  reg [95:0] m, n;
+
+  initial
+    begin
+      a = 128'hffffffffffffffffffffffffffffffff;
+      b = 128'h1;
+      $display("%h %h", a + b, b - a);
+      a = 128'h0000000000000000ffffffffffffffff;
+      $display("%h %h %d", a + b, a * a, a * a);
+      a = 128'h8000000000000000fffffffffffffffe;
+      b = 128'h00000000000000010000000000000003;
+      $display("%b %b %b %b %b %b", a > b, a < b, a >= b, a <= b, a == b, a != b);
+      $display("%h %h %h", a - b, a / b, a % b);
+      $display("%h", 128'h50000000000000002 - 128'h20000000000000003);
+      b = 128'h7;
+      $display("%h %h", a / b, a % b);
+      b = 128'h123456789abcdef0fedcba9876543210;
+      $display("%h %h", a / b, a % b);
+
+      a = 340282366920938463463374607431768211455;
+      b = 18446744073709551629;
+      $display("%d %d %d %d", a, b, a / b, a % b);
+
+      p = 256'hfedcba9876543210fedcba9876543210fedcba9876543210fedcba9876543210;
+      q = 256'h00000000000000000000000000000001fffffffffffffffffffffffffffffffd;
+      s = p * q;
+      $display("%h", s);
+      $display("%h %h", p / q, p % q);
+      $display("%d", p);
+      q = 256'h8000000000000000000000000000000000000000000000000000000000000001;
+      $display("%h %h %b", p / q, p % q, p > q);
+
+      m = 96'h00000001ffffffffffffffff;
+      n = 96'h000000000000000100000000;
+      $display("%h %h %h %h", m + n, m - n, m * n, m / n);
+      $display("%d %d", m, m % n);
+      $display("%h %h", -m, -n);
+      m = 96'h000000000000000000000000;
+      $display("%h %h", -m, m - n);
+      n = 96'h0;
+      $display("%h %h", m / n, m % n);
+    end
+endmodule